@@ -13,7 +13,8 @@
         "src/pulsar/parser.cpp",
         "src/pulsar/runtime.cpp",
         "src/pulsar/unicode.cpp",
-        "src/pulsar/utf8.cpp"
+        "src/pulsar/utf8.cpp",
+        "src/pulsar/verifier.cpp"
       ],
       "direct_dependent_settings": {
         "include_dirs": [ "include" ]
@@ -24,7 +24,7 @@ namespace Pulsar
     class List;
 
     template<typename T>
-    class LinkedList;
+    class ChunkedList;
 
     template<typename T>
     class SharedRef;
@@ -63,7 +63,7 @@ namespace CPulsar::Opaque
     CPULSAR_OPAQUE_IMPL(CPulsar_Module,           Pulsar::Module)
     CPULSAR_OPAQUE_IMPL(CPulsar_Locals,           Pulsar::List<Pulsar::Value>)
     CPULSAR_OPAQUE_IMPL(CPulsar_Value,            Pulsar::Value)
-    CPULSAR_OPAQUE_IMPL(CPulsar_ValueList,        Pulsar::LinkedList<Pulsar::Value>)
+    CPULSAR_OPAQUE_IMPL(CPulsar_ValueList,        Pulsar::ChunkedList<Pulsar::Value>)
     CPULSAR_OPAQUE_IMPL(CPulsar_CustomData,       Pulsar::CustomData)
     CPULSAR_OPAQUE_IMPL(CPulsar_Stack,            Pulsar::Stack)
     CPULSAR_OPAQUE_IMPL(CPulsar_Frame,            Pulsar::Frame)
@@ -28,6 +28,7 @@ typedef enum {
     CPulsar_RuntimeState_NoCustomTypeGlobalData,
     CPulsar_RuntimeState_InvalidCustomTypeHandle,
     CPulsar_RuntimeState_InvalidCustomTypeReference,
+    CPulsar_RuntimeState_Yielded,
 } CPulsar_RuntimeState;
 
 typedef struct {
@@ -75,6 +76,8 @@ CPULSAR_API CPulsar_Frame*       CPULSAR_CALL CPulsar_ExecutionContext_CurrentFr
 CPULSAR_API CPulsar_RuntimeState CPULSAR_CALL CPulsar_ExecutionContext_CallFunctionByName(CPulsar_ExecutionContext* self, const char* fnName);
 
 CPULSAR_API CPulsar_RuntimeState CPULSAR_CALL CPulsar_ExecutionContext_Run(CPulsar_ExecutionContext* self);
+// Returns CPulsar_RuntimeState_Yielded once about `maxInstructions` instructions were run, see Pulsar::ExecutionContext::RunFor().
+CPULSAR_API CPulsar_RuntimeState CPULSAR_CALL CPulsar_ExecutionContext_RunFor(CPulsar_ExecutionContext* self, uint64_t maxInstructions);
 CPULSAR_API CPulsar_RuntimeState CPULSAR_CALL CPulsar_ExecutionContext_GetState(const CPulsar_ExecutionContext* self);
 
 #ifdef CPULSAR_CPP
@@ -46,6 +46,10 @@ CPULSAR_API CPulsar_CBuffer* CPULSAR_CALL CPulsar_Value_SetCustomBuffer(CPulsar_
 CPULSAR_API CPulsar_ValueList* CPULSAR_CALL CPulsar_ValueList_Create(void);
 CPULSAR_API void              CPULSAR_CALL CPulsar_ValueList_Delete(CPulsar_ValueList* self);
 
+CPULSAR_API size_t CPULSAR_CALL CPulsar_ValueList_Length(const CPulsar_ValueList* self);
+// Returns a reference to the value at `index` owned by `self`, or NULL if `index` is out of bounds.
+CPULSAR_API CPulsar_Value* CPULSAR_CALL CPulsar_ValueList_Get(CPulsar_ValueList* self, size_t index);
+
 CPULSAR_API CPulsar_Value* CPULSAR_CALL CPulsar_ValueList_Pop(CPulsar_ValueList* self);
 // Pushes a new empty value owned by `self` and returns its reference.
 CPULSAR_API CPulsar_Value* CPULSAR_CALL CPulsar_ValueList_PushEmpty(CPulsar_ValueList* self);
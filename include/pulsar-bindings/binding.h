@@ -35,11 +35,16 @@ namespace PulsarBindings
     public:
         using NativeFunction = Pulsar::Module::NativeFunction;
         using NativeFunctionFactoryFn = std::function<NativeFunction(const CustomTypeResolver&)>;
+        using FastNativeFunction = Pulsar::Module::FastNativeFunction;
 
         struct NativeFunctionBinding
         {
             Pulsar::FunctionDefinition Definition;
             NativeFunctionFactoryFn CreateFunction;
+            // If set, it's bound instead of the function created by CreateFunction.
+            FastNativeFunction FastFunction = nullptr;
+            // The id of this type is passed as userData to FastFunction, if not empty.
+            Pulsar::String FastFunctionTypeName = Pulsar::String();
         };
 
     public:
@@ -84,6 +89,9 @@ namespace PulsarBindings
             };
         }
 
+        // Returns the type id passed as userData to a fast native bound with a type name.
+        static uint64_t TypeIdOf(void* userData) { return (uint64_t)(uintptr_t)userData; }
+
     protected:
         // Dependencies are IBindings which are bound before this
         template<typename T, typename ...Args>
@@ -109,6 +117,12 @@ namespace PulsarBindings
             BindNativeFunction(sig, [func = std::move(func)](const CustomTypeResolver&) { return func; });
         }
 
+        // See Pulsar::NativeCall, the id of the type named `typeName` is passed as userData to `func` (see TypeIdOf).
+        void BindFastNativeFunction(const Pulsar::FunctionSignature& sig, FastNativeFunction func, Pulsar::StringView typeName="")
+        {
+            m_NativeFunctionsPool.emplace_back(std::forward<Pulsar::FunctionDefinition>(sig.ToNativeDefinition()), nullptr, func, typeName.ToString());
+        }
+
     private:
         std::vector<std::unique_ptr<IBinding>> m_Dependencies;
         std::vector<Pulsar::CustomType> m_CustomTypesPool;
@@ -10,6 +10,7 @@
 #include "pulsar-bindings/std/stdio.h"
 #include "pulsar-bindings/std/thread.h"
 #include "pulsar-bindings/std/time.h"
+#include "pulsar-bindings/std/value.h"
 
 #define PULSARBINDINGS_STD_X \
     X(Debug)                 \
@@ -20,6 +21,7 @@
     X(Print)                 \
     X(Stdio)                 \
     X(Thread)                \
-    X(Time)
+    X(Time)                  \
+    X(Value)
 
 #endif // _PULSARBINDINGS_STD_H
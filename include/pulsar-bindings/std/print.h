@@ -11,8 +11,8 @@ namespace PulsarBindings::Std
         Print();
 
     public:
-        static Pulsar::RuntimeState FPrint(Pulsar::ExecutionContext& eContext);
-        static Pulsar::RuntimeState FPrintln(Pulsar::ExecutionContext& eContext);
+        static Pulsar::RuntimeState FPrint(Pulsar::NativeCall& call, void* userData);
+        static Pulsar::RuntimeState FPrintln(Pulsar::NativeCall& call, void* userData);
     };
 }
 
@@ -0,0 +1,191 @@
+#ifndef _PULSARBINDINGS_STD_SCHEDULER_H
+#define _PULSARBINDINGS_STD_SCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "pulsar/platform.h"
+#include "pulsar/runtime.h"
+
+namespace PulsarBindings::Std
+{
+    /**
+     * Runs ExecutionContexts on a pool of worker threads.
+     * A context runs until it's done, it's parked or it has run for TIME_SLICE,
+     *  in which case it's queued again (see Pulsar::ExecutionContext::RunUntil()).
+     * Only the context of a task can be parked, contexts forked by it (e.g. by scall) block their worker instead.
+     * The pool grows while workers are blocked, so that the same number of them keeps running tasks.
+     */
+    class Scheduler
+    {
+    public:
+        // Called on a worker right before a parked task resumes.
+        // Used to push the return values of the native function which parked it.
+        // If it returns false the task stays parked, it must have been handed to something which wakes it up again.
+        using ResumeFn = std::function<bool(Pulsar::ExecutionContext&)>;
+        using DoneFn = std::function<void()>;
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr std::chrono::milliseconds TIME_SLICE{2};
+
+        class Task
+        {
+        public:
+            using Ref = Pulsar::SharedRef<Task>;
+
+            Task(Pulsar::ExecutionContext&& context)
+                : Context(std::move(context)) {}
+
+            // Must only be accessed by the worker running the task or once the task is done.
+            Pulsar::ExecutionContext Context;
+            // Set until the task is done.
+            std::atomic_bool IsRunning = false;
+
+        private:
+            friend Scheduler;
+
+            enum class State { Ready, Running, Parked, Done };
+
+            std::mutex m_Mutex;
+            std::condition_variable m_DoneCV;
+            State m_State = State::Ready;
+            // Set by ::Park(), the task is parked when its worker stops running it.
+            bool m_ParkRequested = false;
+            // Set by ::Wake() if the task was not parked yet.
+            bool m_WakeRequested = false;
+            ResumeFn m_OnResume;
+            std::vector<DoneFn> m_OnDone;
+        };
+
+        /**
+         * Something waiting on one or more objects (e.g. Channels), which hold a reference to it until they notify it.
+         * It's either a parked task, which is woken up with `onResume`, or a thread blocked by ::Block().
+         * A Waiter is notified at most once, whoever ::Claim()s it first must call ::Notify().
+         */
+        class Waiter
+        {
+        public:
+            using Ref = Pulsar::SharedRef<Waiter>;
+
+            // Threads which are not run by the Scheduler pass a null `task`.
+            Waiter(Task::Ref task, ResumeFn onResume)
+                : m_Task(std::move(task)), m_OnResume(std::move(onResume)) {}
+
+            bool IsClaimed() const { return m_Claimed.load(std::memory_order_acquire); }
+            // Returns true if the caller is the first one to claim the Waiter.
+            bool Claim() { return !m_Claimed.exchange(true, std::memory_order_acq_rel); }
+            void Notify();
+            bool TryNotify();
+
+            // Spins for a while, then sleeps until the Waiter is notified or `deadline` is reached.
+            // Returns false on timeout, the Waiter should be claimed by the caller to check if it was notified.
+            bool Block(Clock::time_point deadline = Clock::time_point::max());
+
+        private:
+            bool Sleep(Clock::time_point deadline);
+
+        private:
+            Task::Ref m_Task;
+            ResumeFn m_OnResume;
+            std::atomic_bool m_Claimed = false;
+            // Futex word set by ::Notify() for blocked threads.
+            std::atomic_uint32_t m_Signal = 0;
+#ifndef PULSAR_PLATFORM_LINUX
+            std::mutex m_Mutex;
+            std::condition_variable m_SignalCV;
+#endif // PULSAR_PLATFORM_LINUX
+        };
+
+    public:
+        Scheduler(size_t workerCount);
+        ~Scheduler();
+
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        // Returns the number of workers which run tasks at once, blocked workers are not counted.
+        size_t GetWorkerCount() const { return m_WorkerCount; }
+
+        // Queues a task whose context has a pending function call.
+        void Spawn(Task::Ref task);
+        // Blocks the calling thread until `task` is done.
+        // Tasks should not call this, see ::OnDone().
+        void Wait(Task& task);
+        // Calls `fn` once `task` is done (from the worker which ran it), or right away if it already is.
+        void OnDone(Task& task, DoneFn fn);
+
+        /**
+         * Parks `task` once the native function which called this returns, until ::Wake() is called.
+         * The native function must return without pushing its return values, they're pushed by `onResume`.
+         * Must be called from a native function running within the context of `task` (see ::GetParkableTask()).
+         */
+        void Park(Task& task);
+        // Queues a task which was parked, `onResume` is called before resuming it.
+        void Wake(Task::Ref task, ResumeFn onResume);
+        // Notifies `waiter` once `deadline` is reached, unless it was already claimed.
+        void NotifyAt(Waiter::Ref waiter, Clock::time_point deadline);
+
+        /**
+         * Must be called before blocking the current thread, ::EndBlocking() must be called once it's no longer blocked.
+         * If the thread is a worker (e.g. a task waiting within a forked context), its Scheduler starts another one when needed.
+         * They do nothing on other threads, ::Wait() and Waiter::Block() already call them.
+         */
+        static void BeginBlocking();
+        static void EndBlocking();
+
+        // Returns the task run by this thread if it can be parked by a native function called by `context`.
+        // Contexts forked by the task (e.g. by scall) run on the same thread, but the task can't be parked from them.
+        static Task::Ref GetParkableTask(const Pulsar::ExecutionContext& context);
+
+        // Returns false if spinning is pointless because there's only one core, nobody could end the spin.
+        static bool CanSpin();
+
+        // Returns the Scheduler used by the std bindings, which is created on the first call.
+        static Scheduler& Get();
+        // Sets the number of workers of the Scheduler returned by ::Get(), 0 creates one for each core.
+        // It must be called before ::Get() to have any effect.
+        static void SetDefaultWorkerCount(size_t workerCount);
+
+    private:
+        struct Timer
+        {
+            Clock::time_point Deadline;
+            Waiter::Ref Target;
+
+            bool operator>(const Timer& other) const { return Deadline > other.Deadline; }
+        };
+
+    private:
+        // Must be called with m_Mutex locked.
+        void StartWorker();
+        void Enqueue(Task::Ref task);
+        // Returns nullptr if the Scheduler is stopping.
+        Task::Ref NextTask();
+        void RunWorker();
+        void Finish(Task& task);
+
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_ReadyCV;
+        std::deque<Task::Ref> m_Ready;
+        std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> m_Timers;
+        bool m_Stopping = false;
+
+        size_t m_WorkerCount;
+        // Workers which did not exit, some of them may be blocked.
+        size_t m_LiveWorkers = 0;
+        size_t m_BlockedWorkers = 0;
+        std::vector<std::thread> m_Workers;
+        // Workers which exited because too many were running once the blocked ones resumed, they're joined by ::StartWorker().
+        std::vector<std::thread::id> m_ExitedWorkers;
+    };
+}
+
+#endif // _PULSARBINDINGS_STD_SCHEDULER_H
@@ -3,25 +3,109 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <thread>
+#include <vector>
 
 #include <iostream>
 
 #include "pulsar-bindings/binding.h"
+#include "pulsar-bindings/std/scheduler.h"
 
 namespace PulsarBindings::Std
 {
     class Channel : public Binding
     {
     public:
-        struct ChannelData
+        /**
+         * Bounded lock-free MPMC queue (see https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue).
+         * Sending to and receiving from a Channel only takes a lock if there's someone waiting on it.
+         * Unbounded Channels use a queue of UNBOUNDED_QUEUE_CAPACITY slots, values which don't fit
+         *  are kept in a locked overflow list until it's emptied by receivers.
+         */
+        class ChannelData
         {
-            // FIFO List
-            Pulsar::Value::List Pipe;
-            bool IsClosed = false;
-            std::mutex Mutex;
-            std::condition_variable CV;
+        public:
+            static constexpr size_t UNBOUNDED = 0;
+            static constexpr size_t UNBOUNDED_QUEUE_CAPACITY = 256;
+            static constexpr size_t MAX_CAPACITY = (size_t)1 << 24;
+
+            // `capacity` is rounded up to a power of 2 and clamped to [2, MAX_CAPACITY], the queue needs at least 2 slots.
+            // The Channel is unbounded if `capacity` is UNBOUNDED.
+            ChannelData(size_t capacity = UNBOUNDED);
+
+            ChannelData(const ChannelData&) = delete;
+            ChannelData& operator=(const ChannelData&) = delete;
+
+            // Moves `value` into the Channel, returns false if it's full. Closed Channels are not checked.
+            bool TrySend(Pulsar::Value& value);
+            // Moves the oldest value of the Channel into `value`, returns false if it's empty.
+            bool TryReceive(Pulsar::Value& value);
+            void Close();
+
+            bool IsClosed() const  { return m_IsClosed.load(std::memory_order_acquire); }
+            bool IsBounded() const { return m_IsBounded; }
+            // These are approximate while other threads are using the Channel.
+            bool IsEmpty() const;
+            bool IsFull() const;
+            // Unbounded Channels return the capacity of their lock-free queue.
+            size_t Capacity() const { return m_Mask+1; }
+
+            // The waiter is notified once a value is sent or the Channel is closed.
+            void AddReceiver(const Scheduler::Waiter::Ref& waiter) { AddWaiter(m_Receivers, waiter); }
+            // The waiter is notified once a value is received or the Channel is closed.
+            void AddSender(const Scheduler::Waiter::Ref& waiter)   { AddWaiter(m_Senders, waiter); }
+
+        private:
+            struct Slot
+            {
+                std::atomic_size_t Sequence;
+                Pulsar::Value Value;
+            };
+
+            // Positions are updated by different threads, they're kept on separate cache lines.
+            struct Position
+            {
+                std::atomic_size_t Value = 0;
+                char Padding[64 - sizeof(std::atomic_size_t)];
+            };
+
+            struct WaiterList
+            {
+                std::deque<Scheduler::Waiter::Ref> Waiters;
+                // Checked without locking m_WaitersMutex by who may have to notify them.
+                std::atomic_size_t Count = 0;
+            };
+
+            struct OverflowList
+            {
+                std::deque<Pulsar::Value> Values;
+                // Checked without locking m_OverflowMutex, values are sent to the overflow list while it's not empty.
+                std::atomic_size_t Count = 0;
+            };
+
+            bool TrySendToQueue(Pulsar::Value& value);
+            bool TryReceiveFromQueue(Pulsar::Value& value);
+
+            void AddWaiter(WaiterList& list, const Scheduler::Waiter::Ref& waiter);
+            void NotifyOne(WaiterList& list);
+            void NotifyAll(WaiterList& list);
+
+        private:
+            std::unique_ptr<Slot[]> m_Slots;
+            size_t m_Mask;
+            bool m_IsBounded;
+            Position m_SendPosition;
+            Position m_ReceivePosition;
+            std::atomic_bool m_IsClosed = false;
+
+            std::mutex m_OverflowMutex;
+            OverflowList m_Overflow;
+
+            std::mutex m_WaitersMutex;
+            WaiterList m_Receivers;
+            WaiterList m_Senders;
         };
 
         class ChannelType :
@@ -38,8 +122,13 @@ namespace PulsarBindings::Std
 
     public:
         static Pulsar::RuntimeState FNew(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId);
-        static Pulsar::RuntimeState FSend(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId);
+        static Pulsar::RuntimeState FWithCapacity(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId);
+        static Pulsar::RuntimeState FSend(Pulsar::NativeCall& call, void* channelTypeId);
+        static Pulsar::RuntimeState FTrySend(Pulsar::NativeCall& call, void* channelTypeId);
         static Pulsar::RuntimeState FReceive(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId);
+        static Pulsar::RuntimeState FTryReceive(Pulsar::NativeCall& call, void* channelTypeId);
+        static Pulsar::RuntimeState FReceiveTimeout(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId);
+        static Pulsar::RuntimeState FSelect(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId);
         static Pulsar::RuntimeState FClose(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId);
         static Pulsar::RuntimeState FIsEmpty(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId);
         static Pulsar::RuntimeState FIsClosed(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId);
@@ -49,15 +138,12 @@ namespace PulsarBindings::Std
     class Thread : public Binding
     {
     public:
-        struct ThreadContext
-        {
-            Pulsar::ExecutionContext Context;
-            std::atomic_bool IsRunning = false;
-        };
+        // Threads are tasks run by Scheduler::Get().
+        // They must be joined before the Module they're running is destroyed.
+        using ThreadContext = Scheduler::Task;
 
         struct ThreadData
         {
-            std::thread Thread;
             Pulsar::SharedRef<Thread::ThreadContext> ThreadContext;
         };
 
@@ -67,8 +153,8 @@ namespace PulsarBindings::Std
         {
         public:
             using Ref = Pulsar::SharedRef<ThreadType>;
-            ThreadType(std::thread&& thread, Pulsar::SharedRef<Thread::ThreadContext>&& threadContext)
-                : ThreadData{ std::move(thread), std::move(threadContext) } { }
+            ThreadType(Pulsar::SharedRef<Thread::ThreadContext>&& threadContext)
+                : ThreadData{ std::move(threadContext) } { }
         };
 
     public:
@@ -82,7 +168,10 @@ namespace PulsarBindings::Std
         static Pulsar::RuntimeState FIsAlive(Pulsar::ExecutionContext& eContext, uint64_t threadTypeId);
         static Pulsar::RuntimeState FIsValid(Pulsar::ExecutionContext& eContext, uint64_t threadTypeId);
 
+        // Pushes the results of `thread` onto `stack`, blocking until it's done.
         static void Join(Pulsar::SharedRef<ThreadData> thread, Pulsar::Stack& stack);
+        // Pushes a List with the results of each thread onto `stack`, blocking until they're done.
+        static void JoinAll(const std::vector<ThreadType::Ref>& threads, Pulsar::Stack& stack);
     };
 }
 
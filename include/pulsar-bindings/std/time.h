@@ -11,9 +11,9 @@ namespace PulsarBindings::Std
         Time();
 
     public:
-        static Pulsar::RuntimeState FTime(Pulsar::ExecutionContext& eContext);
-        static Pulsar::RuntimeState FSteady(Pulsar::ExecutionContext& eContext);
-        static Pulsar::RuntimeState FMicros(Pulsar::ExecutionContext& eContext);
+        static Pulsar::RuntimeState FTime(Pulsar::NativeCall& call, void* userData);
+        static Pulsar::RuntimeState FSteady(Pulsar::NativeCall& call, void* userData);
+        static Pulsar::RuntimeState FMicros(Pulsar::NativeCall& call, void* userData);
     };
 }
 
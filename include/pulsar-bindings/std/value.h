@@ -0,0 +1,19 @@
+#ifndef _PULSARBINDINGS_STD_VALUE_H
+#define _PULSARBINDINGS_STD_VALUE_H
+
+#include "pulsar-bindings/binding.h"
+
+namespace PulsarBindings::Std
+{
+    class Value : public Binding
+    {
+    public:
+        Value();
+
+    public:
+        static Pulsar::RuntimeState FFreeze(Pulsar::NativeCall& call, void* userData);
+        static Pulsar::RuntimeState FIsFrozen(Pulsar::NativeCall& call, void* userData);
+    };
+}
+
+#endif // _PULSARBINDINGS_STD_VALUE_H
@@ -0,0 +1,46 @@
+#ifndef _PULSARJIT_COMPILER_H
+#define _PULSARJIT_COMPILER_H
+
+#include "pulsar/core.h"
+
+#include "pulsar/runtime.h"
+#include "pulsar/runtime/compiler.h"
+
+#include "pulsar-jit/executablememory.h"
+
+namespace PulsarJit
+{
+    // Machine code of a compiled function, its entry point is at the start of the memory.
+    class NativeFunction : public Pulsar::CompiledFunction
+    {
+    public:
+        NativeFunction(ExecutableMemory&& memory)
+            : m_Memory(std::move(memory)) {}
+        ~NativeFunction() override = default;
+
+        EntryPoint GetEntryPoint() const override;
+
+    private:
+        ExecutableMemory m_Memory;
+    };
+
+    /**
+     * Baseline compiler which translates each instruction of a function into x86-64 machine code.
+     * Code is only produced on x86-64 hosts (see ::IsSupported()), otherwise nothing is compiled.
+     *
+     * Usage:
+     *   if (PulsarJit::Compiler::IsSupported())
+     *       context.SetCompiler(Pulsar::SharedRef<PulsarJit::Compiler>::New());
+     */
+    class Compiler : public Pulsar::FunctionCompiler
+    {
+    public:
+        Compiler() = default;
+        ~Compiler() override = default;
+
+        static bool IsSupported();
+        Pulsar::CompiledFunction::Ref Compile(const Pulsar::Module& module, const Pulsar::FunctionDefinition& function) override;
+    };
+}
+
+#endif // _PULSARJIT_COMPILER_H
@@ -0,0 +1,51 @@
+#ifndef _PULSARJIT_EXECUTABLEMEMORY_H
+#define _PULSARJIT_EXECUTABLEMEMORY_H
+
+#include "pulsar/core.h"
+
+namespace PulsarJit
+{
+    // Owns a block of memory pages which can be executed but not written to.
+    class ExecutableMemory
+    {
+    public:
+        ExecutableMemory() = default;
+        ~ExecutableMemory() { Free(); }
+
+        ExecutableMemory(const ExecutableMemory&) = delete;
+        ExecutableMemory(ExecutableMemory&& other)
+            : m_Data(other.m_Data), m_Size(other.m_Size)
+        {
+            other.m_Data = nullptr;
+            other.m_Size = 0;
+        }
+
+        ExecutableMemory& operator=(const ExecutableMemory&) = delete;
+        ExecutableMemory& operator=(ExecutableMemory&& other)
+        {
+            if (this == &other)
+                return *this;
+            Free();
+            m_Data = other.m_Data;
+            m_Size = other.m_Size;
+            other.m_Data = nullptr;
+            other.m_Size = 0;
+            return *this;
+        }
+
+        // Copies `size` bytes of `code` into new executable pages.
+        // Returns false if the pages could not be allocated or protected.
+        bool Load(const uint8_t* code, size_t size);
+        void Free();
+
+        const void* Data() const { return m_Data; }
+        size_t Size() const { return m_Size; }
+        bool IsEmpty() const { return m_Data == nullptr; }
+
+    private:
+        void* m_Data = nullptr;
+        size_t m_Size = 0;
+    };
+}
+
+#endif // _PULSARJIT_EXECUTABLEMEMORY_H
@@ -0,0 +1,152 @@
+#ifndef _PULSARJIT_X64_EMITTER_H
+#define _PULSARJIT_X64_EMITTER_H
+
+#include "pulsar/core.h"
+
+#include "pulsar/structures/list.h"
+
+namespace PulsarJit::X64
+{
+    enum class Reg : uint8_t {
+        RAX = 0, RCX = 1, RDX = 2, RBX = 3,
+        RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+        R8  = 8, R9  = 9, R10 = 10, R11 = 11,
+        R12 = 12, R13 = 13, R14 = 14, R15 = 15,
+    };
+
+    enum class XmmReg : uint8_t {
+        XMM0 = 0, XMM1 = 1,
+    };
+
+    // Condition codes used by Jcc and SetCC.
+    enum class Condition : uint8_t {
+        O  = 0x0, NO = 0x1,
+        B  = 0x2, AE = 0x3, // Unsigned <, >=
+        E  = 0x4, NE = 0x5,
+        BE = 0x6, A  = 0x7, // Unsigned <=, >
+        S  = 0x8, NS = 0x9,
+        P  = 0xA, NP = 0xB, // Parity (unordered doubles)
+        L  = 0xC, GE = 0xD, // Signed <, >=
+        LE = 0xE, G  = 0xF, // Signed <=, >
+    };
+
+    // [Base + Disp]
+    struct Mem
+    {
+        Reg Base;
+        int32_t Disp = 0;
+
+        Mem Offset(int32_t offset) const { return { Base, Disp + offset }; }
+    };
+
+    // Ops which share the same encoding pattern.
+    enum class AluOp : uint8_t {
+        Add = 0, Or = 1, And = 4, Sub = 5, Xor = 6, Cmp = 7,
+    };
+
+    enum class SseOp : uint8_t {
+        Add = 0x58, Mul = 0x59, Sub = 0x5C, Div = 0x5E,
+    };
+
+    /**
+     * Emits x86-64 machine code into a buffer.
+     * Only the encodings needed by the Translator are implemented.
+     * Jumps target Labels, which are resolved by ::Finalize().
+     */
+    class Emitter
+    {
+    public:
+        using Label = size_t;
+
+    public:
+        Emitter() = default;
+        ~Emitter() = default;
+
+        Label NewLabel();
+        void Bind(Label label);
+        bool IsBound(Label label) const { return m_LabelPositions[label] != UNBOUND; }
+
+        // Resolves all references to labels, returns false if any of them was not bound.
+        bool Finalize();
+        const Pulsar::List<uint8_t>& GetCode() const { return m_Code; }
+
+    public:
+        void Push(Reg reg);
+        void Pop(Reg reg);
+        void Ret();
+        // Pads the code with int3 until its size is a multiple of `alignment`.
+        void Align(size_t alignment);
+
+        void Mov64(Reg dst, Reg src);
+        void Mov64(Reg dst, Mem src);
+        void Mov64(Mem dst, Reg src);
+        void Mov64(Reg dst, int64_t imm);
+        // Sign-extends imm to 64 bits.
+        void Mov64(Mem dst, int32_t imm);
+        void Mov32(Reg dst, Mem src);
+        void Mov32(Mem dst, Reg src);
+        void Mov32(Mem dst, int32_t imm);
+
+        void Alu64(AluOp op, Reg dst, Reg src);
+        void Alu64(AluOp op, Reg dst, Mem src);
+        // Sign-extends imm to 64 bits.
+        void Alu64(AluOp op, Mem dst, int32_t imm);
+        void Alu32(AluOp op, Reg dst, Mem src);
+        void Alu32(AluOp op, Reg dst, int32_t imm);
+        void Alu32(AluOp op, Mem dst, int32_t imm);
+        void Cmp8(Mem dst, int8_t imm);
+        void Imul64(Reg dst, Mem src);
+        void Not64(Mem dst);
+        void Test64(Reg a, Reg b);
+
+        // Sets the low byte of `dst` to 1 if `cond` is met, to 0 otherwise.
+        void SetCC(Condition cond, Reg dst);
+        // Zero-extends the low byte of `src` into `dst`.
+        void Movzx32(Reg dst, Reg src);
+
+        void Movsd(XmmReg dst, Mem src);
+        void Movsd(Mem dst, XmmReg src);
+        void Sse(SseOp op, XmmReg dst, Mem src);
+        void Ucomisd(XmmReg a, XmmReg b);
+        void Xorpd(XmmReg dst, XmmReg src);
+
+        void Jmp(Label target);
+        void Jmp(Reg target);
+        void Jcc(Condition cond, Label target);
+        void LeaRip(Reg dst, Label target);
+        // dst = sign-extended 32-bit integer at [base + index*4]
+        void Movsxd(Reg dst, Reg base, Reg index);
+        // Emits the 32-bit offset of `target` from `base`.
+        void EmitLabelOffset(Label target, Label base);
+
+    private:
+        void Emit8(uint8_t byte) { m_Code.PushBack(byte); }
+        void Emit32(uint32_t value);
+        void Emit64(uint64_t value);
+        // Emits a REX prefix if needed.
+        void EmitRex(bool wide, uint8_t reg, uint8_t index, uint8_t base);
+        // Emits the ModRM (and SIB) bytes to address `mem` with `reg` as the register operand.
+        void EmitModRM(uint8_t reg, Mem mem);
+        void EmitModRMReg(uint8_t reg, uint8_t rm);
+        // Emits a 32-bit placeholder which is resolved as `target - base`.
+        // If `base` is NO_LABEL, the offset is relative to the end of the placeholder.
+        void EmitFixup(Label target, Label base);
+
+    private:
+        static constexpr size_t UNBOUND  = size_t(-1);
+        static constexpr Label NO_LABEL = size_t(-1);
+
+        struct Fixup
+        {
+            size_t Position;
+            Label Target;
+            Label Base;
+        };
+
+        Pulsar::List<uint8_t> m_Code;
+        Pulsar::List<size_t> m_LabelPositions;
+        Pulsar::List<Fixup> m_Fixups;
+    };
+}
+
+#endif // _PULSARJIT_X64_EMITTER_H
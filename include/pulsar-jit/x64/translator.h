@@ -0,0 +1,85 @@
+#ifndef _PULSARJIT_X64_TRANSLATOR_H
+#define _PULSARJIT_X64_TRANSLATOR_H
+
+#include "pulsar/core.h"
+
+#include "pulsar/runtime.h"
+#include "pulsar/verifier.h"
+#include "pulsar/structures/list.h"
+
+#include "pulsar-jit/x64/emitter.h"
+
+namespace PulsarJit::X64
+{
+    /**
+     * Translates the Code of a verified FunctionDefinition into x86-64 machine code
+     *  which follows the contract of Pulsar::CompiledFunction.
+     *
+     * The stack depth before each instruction is computed statically (see Pulsar::Verifier::ComputeStackDepths),
+     *  so Values on the Stack are accessed at fixed offsets. Instructions with an unknown depth are never translated.
+     * On entry, the code jumps to the translation of InstructionIndex if StackSize matches its depth.
+     *
+     * Translated instructions only handle trivial Values (Void, numbers and references).
+     * Instructions which aren't supported, or whose operands don't have the expected types,
+     *  exit before changing anything so that the ExecutionContext can execute them (and report errors).
+     */
+    class Translator
+    {
+    public:
+        Translator(const Pulsar::Module& module, const Pulsar::FunctionDefinition& function)
+            : m_Module(module), m_Function(function) {}
+        ~Translator() = default;
+
+        // Returns false if the function can't be translated.
+        bool Translate();
+        const Pulsar::List<uint8_t>& GetCode() const { return m_Emitter.GetCode(); }
+
+    private:
+        using Label = Emitter::Label;
+
+        // Returns false if the instruction is not supported, in which case nothing is emitted.
+        bool TranslateInstruction(size_t instrIdx);
+        bool TranslateConditionalJump(size_t instrIdx);
+
+        // Returns true if the code can continue from `targetIdx` after an instruction leaves `depthAfter` values.
+        bool CanTransfer(size_t targetIdx, size_t depthAfter) const;
+        // Emits a jump to `targetIdx`, checking for stop requests if it's a backward jump.
+        // If `canFallThrough` is true and `targetIdx` follows `fromIdx`, no jump is emitted.
+        void EmitTransfer(size_t fromIdx, size_t targetIdx, size_t depthAfter, bool canFallThrough = true);
+        // Emits a return to the ExecutionContext which continues from `instrIdx` with `depth` values.
+        void EmitExit(size_t instrIdx, size_t depth);
+        // Returns a label which exits at `instrIdx` with the depth computed for it.
+        Label GetExitLabel(size_t instrIdx);
+
+        // Jumps to `exitLabel` if the Value at `slot` is not trivial.
+        void EmitTrivialGuard(Mem slot, Label exitLabel);
+        // Jumps to `exitLabel` if the Value at `slot` is not of `type`.
+        void EmitTypeGuard(Mem slot, Pulsar::ValueType type, Label exitLabel);
+        // Copies a trivial Value.
+        void EmitCopy(Mem dst, Mem src);
+        void EmitSetType(Mem slot, Pulsar::ValueType type);
+
+        Mem StackSlot(size_t index) const;
+        Mem LocalSlot(size_t index) const;
+        Mem TypeOf(Mem slot) const    { return slot.Offset(m_TypeOffset); }
+        Mem PayloadOf(Mem slot) const { return slot.Offset(m_PayloadOffset); }
+
+    private:
+        static constexpr size_t UNKNOWN_DEPTH = Pulsar::Verifier::UNKNOWN_DEPTH;
+        static constexpr Label NO_LABEL = size_t(-1);
+
+        const Pulsar::Module& m_Module;
+        const Pulsar::FunctionDefinition& m_Function;
+
+        Emitter m_Emitter;
+        Pulsar::List<size_t> m_Depths;
+        Pulsar::List<Label> m_InstructionLabels;
+        Pulsar::List<Label> m_ExitLabels;
+        Label m_ReturnLabel = NO_LABEL;
+
+        int32_t m_TypeOffset = 0;
+        int32_t m_PayloadOffset = 0;
+    };
+}
+
+#endif // _PULSARJIT_X64_TRANSLATOR_H
@@ -4,6 +4,7 @@
 #include <lsp/types.h>
 
 #include "pulsar/structures/hashmap.h"
+#include "pulsar/structures/list.h"
 #include "pulsar/structures/string.h"
 
 namespace PulsarLSP::Completion
@@ -104,6 +104,10 @@ namespace PulsarTools::CLI
             AllowLabels(cmd, "allow-labels", "l",
                 "Allow the usage of labels. (default: false)",
                 false),
+            TailCalls(cmd, "tail-calls", "",
+                "Replace the frame of the caller when a call is followed by a return."
+                " Replaced frames are not shown in stack traces. (default: true)",
+                true),
             WarnDuplicateFunctionNames(cmd, "warn-duplicate-function-names", "Wduplicate-function-names",
                 "Warn if duplicate function names are found."
                 " Multiple functions named 'main' won't be reported."
@@ -125,6 +129,7 @@ namespace PulsarTools::CLI
         Argue::FlagOption ErrorNotes;
         Argue::FlagOption AllowInclude;
         Argue::FlagOption AllowLabels;
+        Argue::FlagOption TailCalls;
 
         Argue::FlagOption WarnDuplicateFunctionNames;
         Argue::FlagGroupOption WarnAll;
@@ -183,21 +188,25 @@ namespace PulsarTools::CLI
             OptimizeUnused(cmd, "optimize-unused", "",
                 "Removed unused symbols. (default: false)",
                 false),
+            OptimizePeephole(cmd, "optimize-peephole", "",
+                "Fuse common instruction sequences into superinstructions. (default: false)",
+                false),
             OptimizeAll(cmd, "optimize-all", "", "Apply all optimizations. (default: false)", false,
-                OptimizeUnused),
+                OptimizeUnused, OptimizePeephole),
             Exports(cmd, "export", "",
                 "Marks symbols as exported so that the optimizer may not remove/rename them.\n"
                 "If an entry point could be specified, it's added to the exported functions.")
         {}
 
         Argue::FlagOption OptimizeUnused;
+        Argue::FlagOption OptimizePeephole;
         Argue::FlagGroupOption OptimizeAll;
 
         ExportOption Exports;
 
         bool HasOptimizationsActive() const
         {
-            return *OptimizeUnused;
+            return *OptimizeUnused || *OptimizePeephole;
         }
     };
 
@@ -211,6 +220,14 @@ namespace PulsarTools::CLI
                 "Sets the max depth of the printed stack-trace on error. (default: 10)",
                 10),
             EntryPoint(cmd, "entry-point", "E", "FUNC", "Set entry point. (default: main)", "main"),
+            Jit(cmd, "jit", "", "Compile frequently executed functions to native code. Only supported on x86-64."),
+            Engine(cmd, "engine", "", "ENGINE",
+                "Sets the interpreter used to run verified functions. (default: stack)",
+                {"stack", "register"}, 0),
+            Arena(cmd, "arena", "", "Serve small allocations made while running from an arena owned by each thread."),
+            Workers(cmd, "workers", "", "N",
+                "Sets the number of OS threads which run the threads started by the script. (default: one for each core)",
+                0),
             LibraryFolders(cmd, "library-search", "L", "PATH", "Adds the path to the library search paths."),
             InterpreterLibrariesFolder(cmd, "interpreter-libraries", "",
                 HasInterpreterLibrariesFolder()
@@ -227,8 +244,9 @@ namespace PulsarTools::CLI
             BindStdio(cmd, "bind-stdio", "", "Bind String IO functions."),
             BindThread(cmd, "bind-thread", "", "Bind Thread natives."),
             BindTime(cmd, "bind-time", "", "Bind system clock natives."),
+            BindValue(cmd, "bind-value", "", "Bind natives which work on any value."),
             BindAll(cmd, "bind-all", "", "Bind all available natives. (default: true)", true,
-                BindDebug, BindError, BindFileSystem, BindLexer, BindModule, BindPrint, BindStdio, BindThread, BindTime)
+                BindDebug, BindError, BindFileSystem, BindLexer, BindModule, BindPrint, BindStdio, BindThread, BindTime, BindValue)
         {
             BindAll.SetValue(true);
         }
@@ -237,6 +255,10 @@ namespace PulsarTools::CLI
         Argue::IntOption  StackTraceDepth;
 
         Argue::StrOption EntryPoint;
+        Argue::FlagOption Jit;
+        Argue::ChoiceOption Engine;
+        Argue::FlagOption Arena;
+        Argue::IntOption  Workers;
         Argue::CollectionOption LibraryFolders;
         Argue::FlagOption InterpreterLibrariesFolder;
         Argue::CollectionOption Libraries;
@@ -250,6 +272,7 @@ namespace PulsarTools::CLI
         Argue::FlagOption BindStdio;
         Argue::FlagOption BindThread;
         Argue::FlagOption BindTime;
+        Argue::FlagOption BindValue;
         Argue::FlagGroupOption BindAll;
     };
 
@@ -16,6 +16,7 @@ namespace Pulsar::Binary
     constexpr uint8_t CHUNK_GLOBALS         = 0x03;
     constexpr uint8_t CHUNK_CONSTANTS       = 0x04;
     constexpr uint8_t CHUNK_SOURCE_DEBUG_SYMBOLS = 0x80;
+    constexpr uint8_t CHUNK_MAX_STACK_SIZES      = 0x81;
 
     constexpr bool IsOptionalChunk(uint8_t chunkType) { return chunkType >= 0x80; }
 
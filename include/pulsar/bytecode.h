@@ -51,8 +51,8 @@ namespace Pulsar::Binary
     bool WriteByteCode(IWriter& writer, const Module& module, const WriteSettings& settings=WriteSettings_Default);
     
     namespace ByteCode {
-        // LinkedLists are stored like normal Lists
-        ReadResult ReadLinkedList(IReader& reader, LinkedList<Value>& out, const ReadSettings& settings);
+        // Value::Lists are stored like normal Lists
+        ReadResult ReadList(IReader& reader, Value::List& out, const ReadSettings& settings);
         ReadResult ReadList(IReader& reader, List<Value>& out, const ReadSettings& settings);
         ReadResult ReadList(IReader& reader, List<Instruction>& out, const ReadSettings& settings);
         ReadResult ReadList(IReader& reader, List<BlockDebugSymbol>& out, const ReadSettings& settings);
@@ -82,8 +82,8 @@ namespace Pulsar::Binary
 
         ReadResult ReadValue(IReader& reader, Value& out, const ReadSettings& settings);
 
-        // LinkedLists are stored like normal Lists
-        bool WriteLinkedList(IWriter& writer, const LinkedList<Value>& list, const WriteSettings& settings);
+        // Value::Lists are stored like normal Lists
+        bool WriteList(IWriter& writer, const Value::List& list, const WriteSettings& settings);
         bool WriteList(IWriter& writer, const List<Value>& list, const WriteSettings& settings);
         bool WriteList(IWriter& writer, const List<Instruction>& list, const WriteSettings& settings);
         bool WriteList(IWriter& writer, const List<BlockDebugSymbol>& list, const WriteSettings& settings);
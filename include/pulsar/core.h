@@ -2,11 +2,14 @@
 #define _PULSAR_CORE_H
 
 // All std includes from header files are here.
+#include <bit> // std::countr_zero
+#include <chrono>
 #include <cinttypes>
 #include <cmath> // std::floor, ::ceil
 #include <cstdlib> // std::malloc, ::realloc, ::free, ...
 #include <cstring> // std::memset, ::memcpy, ::strlen, ...
 #include <functional>
+#include <span>
 #include <type_traits>
 #include <utility>
 
@@ -40,8 +43,17 @@
 
 #ifndef PULSAR_NO_ATOMIC
 #include <atomic>
+#include <mutex>
 #endif // PULSAR_NO_ATOMIC
 
+// Define PULSAR_NO_SIMD to use the portable version of code which is vectorized (e.g. HashMap lookups).
+#ifndef PULSAR_NO_SIMD
+  #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define PULSAR_HAS_SSE2
+    #include <emmintrin.h>
+  #endif
+#endif // PULSAR_NO_SIMD
+
 #ifndef PULSAR_ATOMIC_SIZE_T
   #ifdef PULSAR_NO_ATOMIC
     #define PULSAR_ATOMIC_SIZE_T size_t
@@ -106,10 +118,49 @@
 
 namespace Pulsar::Core
 {
+    // Served by the Allocator bound to the calling thread, if any, otherwise by std::malloc.
     void* Malloc(size_t size);
     void* Realloc(void* block, size_t newSize);
+    // Blocks within a registered MemoryRegion are given back to it, others to std::free.
     void Free(void* block);
 
+    // Extend this class to serve the ::Malloc() calls of the threads it's bound to (see ::SetThreadAllocator()).
+    class Allocator
+    {
+    public:
+        virtual ~Allocator() = default;
+        // Returns nullptr to let std::malloc serve the request.
+        // Blocks which don't come from std::malloc must be part of a registered MemoryRegion.
+        virtual void* Malloc(size_t size) = 0;
+    };
+
+    Allocator* GetThreadAllocator();
+    // Returns the Allocator which was bound to the calling thread.
+    Allocator* SetThreadAllocator(Allocator* allocator);
+
+    /**
+     * The header of REGION_SIZE bytes of memory aligned to REGION_SIZE.
+     * Blocks within registered regions are freed through them, so they can be freed
+     *  from any thread and even after the Allocator which created them is destroyed.
+     */
+    class MemoryRegion
+    {
+    public:
+        static constexpr size_t REGION_SIZE = 64*1024;
+
+        virtual ~MemoryRegion() = default;
+        // May be called from any thread, `threadAllocator` is the one bound to it.
+        virtual void Free(void* block, Allocator* threadAllocator) = 0;
+        // Returns the usable size of `block`.
+        virtual size_t SizeOf(const void* block) const = 0;
+
+        // Returns the registered region which holds `block`, or nullptr.
+        static MemoryRegion* Of(const void* block);
+        // Returns false if `region` is at an address which can't be tracked.
+        static bool Register(MemoryRegion* region);
+        static void Unregister(MemoryRegion* region);
+    };
+
     template<typename ...Args>
     inline constexpr void Unused(const Args& ...args)
     {
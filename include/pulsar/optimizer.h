@@ -99,11 +99,53 @@ namespace Pulsar
         RemappedIndex m_RemappedGlobals;
         RemappedIndex m_RemappedConstants;
     };
+
+    /**
+     * The PeepholeOptimizer fuses common sequences of instructions into superinstructions,
+     *  so that fewer instructions are dispatched at runtime (see InstructionCode).
+     * A sequence is only fused if no jump lands within it.
+     * Jumps and CodeDebugSymbols are remapped and the Module is verified again.
+     */
+    class PeepholeOptimizer
+    {
+    public:
+        PeepholeOptimizer() = default;
+        ~PeepholeOptimizer() = default;
+
+        // Returns the number of instructions which were removed from `module`.
+        size_t Optimize(Module& module);
+
+        // Returns the number of instructions which were removed from `function`.
+        // On error (i.e. a jump out of bounds), `function` is not modified.
+        // Does not update FunctionDefinition::Verified and ::MaxStackSize.
+        size_t OptimizeFunction(FunctionDefinition& function);
+
+    private:
+        // Returns the amount of instructions fused into `out` starting from `instrIdx`, 0 if none.
+        size_t FuseInstructions(const List<Instruction>& code, size_t instrIdx, Instruction& out) const;
+        // Returns the offset of the instruction which may fail within the sequence that was fused into `fused`.
+        // Superinstructions report errors at the position of that instruction.
+        static size_t FailingInstructionOffset(InstructionCode fused);
+
+    private:
+        static constexpr auto INVALID_INDEX = Module::INVALID_INDEX;
+
+        // m_IsJumpTarget[i] is true if a jump lands on the i-th instruction.
+        List<bool> m_IsJumpTarget;
+        // m_RemappedIndex[i] is the new index of the i-th instruction.
+        // Instructions fused together are remapped to the same index.
+        List<size_t> m_RemappedIndex;
+        // m_SymbolIndex[i] is the index of the instruction whose debug symbol is used by the new i-th instruction.
+        List<size_t> m_SymbolIndex;
+        List<Instruction> m_Code;
+        List<BlockDebugSymbol> m_CodeDebugSymbols;
+    };
 }
 
 constexpr bool Pulsar::OptimizerUtils::InstructionReferencesFunction(InstructionCode code)
 {
     return code == InstructionCode::Call
+        || code == InstructionCode::TailCall
         || code == InstructionCode::PushFunctionReference;
 }
 
@@ -123,7 +165,8 @@ constexpr bool Pulsar::OptimizerUtils::InstructionReferencesGlobal(InstructionCo
 
 constexpr bool Pulsar::OptimizerUtils::InstructionReferencesConstant(InstructionCode code)
 {
-    return code == InstructionCode::PushConst;
+    return code == InstructionCode::PushConst
+        || code == InstructionCode::PushConstAppend;
 }
 
 template<typename T>
@@ -202,6 +202,9 @@ namespace Pulsar
         bool AppendNotesToErrorMessage      = true;
         bool AllowIncludeDirective          = true;
         bool AllowLabels                    = true;
+        // Calls followed by a return replace the caller's frame, which won't appear in stack traces.
+        // Disabled by default so that stack traces show every caller unless tail calls are asked for.
+        bool EmitTailCalls                  = false;
         // LSPs may set this to `true` to avoid infinite loops in global producers.
         // If this is set to `true`, you shouldn't expect the module to run correctly.
         bool MapGlobalProducersToVoid       = false;
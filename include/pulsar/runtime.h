@@ -3,10 +3,13 @@
 
 #include "pulsar/core.h"
 
+#include "pulsar/runtime/allocator.h"
+#include "pulsar/runtime/compiler.h"
 #include "pulsar/runtime/debug.h"
 #include "pulsar/runtime/function.h"
 #include "pulsar/runtime/global.h"
 #include "pulsar/runtime/module.h"
+#include "pulsar/runtime/registerir.h"
 #include "pulsar/runtime/state.h"
 #include "pulsar/runtime/value.h"
 #include "pulsar/structures/linkedlist.h"
@@ -26,8 +29,18 @@ namespace Pulsar
         Stack(size_t initCapacity)
             : m_Values(initCapacity) {}
 
-        explicit Stack(const LinkedList<Value>& ll) : m_Values(ll) {}
-        explicit Stack(LinkedList<Value>&& ll) : m_Values(std::move(ll)) {}
+        explicit Stack(const Value::List& l)
+            : m_Values(l.Length())
+        {
+            for (const Value& v : l) m_Values.PushBack(v);
+        }
+
+        explicit Stack(Value::List&& l)
+            : m_Values(l.Length())
+        {
+            for (Value& v : l) m_Values.PushBack(std::move(v));
+            l.Clear();
+        }
 
         explicit Stack(const List<Value>& l) : m_Values(l) {}
         explicit Stack(List<Value>&& l) : m_Values(std::move(l)) {}
@@ -40,6 +53,8 @@ namespace Pulsar
         Stack& operator=(const Stack& other) = default;
         Stack& operator=(Stack&& other) = default;
 
+        Value* Data() { return m_Values.Data(); }
+
         void Resize(size_t newSize)      { m_Values.Resize(newSize); }
         void Reserve(size_t newCapacity) { m_Values.Reserve(newCapacity); }
 
@@ -167,15 +182,103 @@ namespace Pulsar
         RuntimeState PrepareFrame(Frame& frame, Stack& callerStack);
 
         Frame& PushFrame(Frame&& frame) { return m_Frames.EmplaceBack(std::move(frame)); }
-        void PopFrame() { m_Frames.PopBack(); }
+        // The storage of the popped frame may be reused by the next call to CreateFrame.
+        void PopFrame();
 
         bool IsEmpty() const { return m_Frames.IsEmpty(); }
         size_t Size() const { return m_Frames.Size(); }
         Frame& operator[](size_t i) { return m_Frames[i]; }
         const Frame& operator[](size_t i) const { return m_Frames[i]; }
 
+    private:
+        // Max amount of popped frames kept for reuse.
+        static constexpr size_t MAX_FREE_FRAMES = 64;
+        // Locals and Stacks of popped frames with a bigger capacity are freed before they're kept for reuse,
+        //  so that a single large call doesn't hold onto its memory for the lifetime of the CallStack.
+        static constexpr size_t MAX_FREE_FRAME_CAPACITY = 256;
+
     private:
         List<Frame> m_Frames;
+        // Popped frames with empty Locals and Stack, their buffers are reused by CreateFrame.
+        List<Frame> m_FreeFrames;
+    };
+
+    // Forward declaration for NativeCall
+    class ExecutionContext;
+
+    /**
+     * The arguments and results of a native bound with `Module::BindFastNativeFunction()`.
+     * Until `::MaterializeFrame()` is called, arguments are views into the Stack of the caller and
+     *  results are pushed right after them, no Frame is pushed onto the CallStack.
+     * So `ExecutionContext::CurrentFrame()` is the Frame of the caller, materialize the Frame of the native
+     *  to call back into the VM or to make it show up in stack traces.
+     * References to arguments and results are invalidated by pushing any result, materializing the Frame
+     *  or calling back into the VM. Move arguments out of the call if they're needed after that.
+     */
+    class NativeCall
+    {
+    public:
+        // Calls the native on top of `callerStack`, which must hold its arguments.
+        NativeCall(ExecutionContext& context, const FunctionDefinition& native, Stack& callerStack);
+        // Calls the native with the Frame at `frameIdx` of the CallStack of `context`.
+        NativeCall(ExecutionContext& context, size_t frameIdx);
+
+        NativeCall(const NativeCall&) = delete;
+        NativeCall& operator=(const NativeCall&) = delete;
+
+        ExecutionContext& GetContext() const            { return m_Context; }
+        const FunctionDefinition& GetDefinition() const { return m_Native; }
+
+        // Arguments()[0] is the first argument.
+        // The returned views are invalidated by ::PushResult() and ::MaterializeFrame().
+        std::span<Value> Arguments();
+        Value& Argument(size_t idx) { return Arguments()[idx]; }
+        // Values taken from the Stack of the caller (see FunctionDefinition::StackArity).
+        std::span<Value> StackArguments();
+
+        Value& PushResult();
+        Value& PushResult(const Value& value) { return PushResult() = value; }
+        Value& PushResult(Value&& value)      { return PushResult() = std::move(value); }
+        Value& PushInteger(int64_t integer)   { return PushResult().SetInteger(integer); }
+        Value& PushDouble(double doublev)     { return PushResult().SetDouble(doublev); }
+
+        bool HasFrame() const { return m_FrameIdx != NO_FRAME; }
+        /**
+         * Pushes the Frame of the native onto the CallStack, arguments and results are moved into it.
+         * The Frame is returned from like the one of a NativeFunction once the native returns.
+         * The returned reference is invalidated by pushing other frames, calling this again returns the current one.
+         */
+        Frame& MaterializeFrame();
+
+        /**
+         * Replaces the arguments on the Stack of the caller with the last `Returns` values that were pushed
+         *  after the stack arguments, like returning from a Frame does.
+         * Must only be called by the ExecutionContext once the native returns without a Frame.
+         */
+        RuntimeState Return();
+
+    private:
+        static constexpr size_t NO_FRAME = size_t(-1);
+
+        // Index of the i-th value of the Stack of the native on the Stack of the caller.
+        size_t StackIndex(size_t i) const;
+        size_t PushedResults() const { return m_CallerStack->Size() - m_ArgsIdx - m_Native.Arity; }
+
+    private:
+        ExecutionContext& m_Context;
+        const FunctionDefinition& m_Native;
+        Stack* m_CallerStack = nullptr;
+        size_t m_StackArgsIdx = 0;
+        size_t m_ArgsIdx = 0;
+        size_t m_FrameIdx = NO_FRAME;
+    };
+
+    enum class ExecutionEngine
+    {
+        // Runs the bytecode of functions.
+        Stack,
+        // Runs verified functions translated by RegisterTranslator.
+        Register,
     };
 
     /**
@@ -183,6 +286,13 @@ namespace Pulsar
      * Its job is running a valid Pulsar Module.
      * If any member function that returns `RuntimeState` returns a value `!= RuntimeState::OK`, this context is no longer usable.
      * 
+     * Generic arithmetic and comparison instructions are quickened into type-specialized ones
+     *  the first time they're executed. The rewritten code is owned by the context and shared with its forks,
+     *  so the Module is never modified and can be shared by contexts running on different threads.
+     * If a FunctionCompiler is set, hot functions are compiled and their compiled code is run
+     *  until it reaches an instruction that it doesn't support, which is run by the context.
+     * The same goes for the register interpreter, which is selected with `::SetEngine()`.
+     * 
 ```cpp
 ExecutionContext context(module);
 Stack& stack = context.GetStack();
@@ -195,6 +305,10 @@ if (state != RuntimeState::OK) // ERROR
      */
     class ExecutionContext
     {
+    public:
+        static constexpr size_t DEFAULT_COMPILE_THRESHOLD = 1000;
+        static constexpr int64_t DEADLINE_CHECK_INTERVAL = 1 << 14;
+
     public:
         // typeId -> typeData
         using CustomTypeGlobalDataMap = HashMap<uint64_t, CustomTypeGlobalData::Ref>;
@@ -221,9 +335,20 @@ if (state != RuntimeState::OK) // ERROR
          * Creates a new "child" ExecutionContext which inherits global data from this one.
          * Global data is CustomTypeGlobalData and Globals. Any change to the forked context
          *  won't affect the original one (except for CustomTypeGlobalData that explicitly wants that).
+         * Globals are shared with the fork, call ::PromoteGlobalsToAtomic() if it's going to run on another thread.
+         * Whichever context writes to a Global first copies them, so forking doesn't copy any of them.
          */
         ExecutionContext Fork() const;
 
+        /**
+         * Like ::Fork(), but CustomTypeGlobalData is shared with this context instead of being forked.
+         * Globals are still copied on write, use ::SwapGlobals() to make the changes of the fork visible to this context.
+         */
+        ExecutionContext ForkShared() const;
+
+        // Allows Globals to be shared with forks which run on other threads (see Value::PromoteToAtomic()).
+        void PromoteGlobalsToAtomic() const;
+
         /**
          * Retrieves and casts to the correct type an instance of CustomTypeGlobalData.
          * If the type does not exist, nullptr is returned.
@@ -252,8 +377,11 @@ if (state != RuntimeState::OK) // ERROR
         const CustomTypeGlobalDataMap& GetAllCustomTypeGlobalData() const { return m_CustomTypeGlobalData; }
 
         // Do not add or remove values from the returned list.
-        List<GlobalInstance>& GetGlobals()             { return m_Globals; }
-        const List<GlobalInstance>& GetGlobals() const { return m_Globals; }
+        // Globals which are shared with forks are copied, since they may be modified through the returned list.
+        List<GlobalInstance>& GetGlobals()             { return OwnGlobals(); }
+        const List<GlobalInstance>& GetGlobals() const { return *m_Globals; }
+        // Swaps Globals with `other`, which must run the same Module.
+        void SwapGlobals(ExecutionContext& other)      { std::swap(m_Globals, other.m_Globals); }
 
         // Generates the trace for a single call in the CallStack.
         // Provide a `positionConverter` to convert from UTF32 0-indexed positions to other position kinds.
@@ -280,6 +408,39 @@ if (state != RuntimeState::OK) // ERROR
 
         const Module& GetModule() const { return m_Module; }
 
+        /**
+         * Functions which are entered or jump backwards `threshold` times are compiled by `compiler`.
+         * Only the non-stepping variants (i.e. `::Run()`) run compiled code.
+         * Forks of this context share the same compiler.
+         * Set `compiler` to nullptr to disable compilation.
+         */
+        void SetCompiler(FunctionCompiler::Ref compiler, size_t threshold=DEFAULT_COMPILE_THRESHOLD)
+        {
+            m_Compiler = compiler;
+            m_CompileThreshold = threshold > 0 ? threshold : 1;
+        }
+
+        const FunctionCompiler::Ref& GetCompiler() const { return m_Compiler; }
+        size_t GetCompileThreshold() const { return m_CompileThreshold; }
+
+        /**
+         * Selects the interpreter used by `::Run()` for verified functions, `::Step()` always uses the stack one.
+         * Compiled code, if any, takes precedence over both.
+         * Forks of this context use the same engine.
+         */
+        void SetEngine(ExecutionEngine engine) { m_Engine = engine; }
+        ExecutionEngine GetEngine() const      { return m_Engine; }
+
+        /**
+         * Allocations made while running this context (i.e. within `::Run()` and `::Step()`) are served by `allocator`.
+         * Forks of this context use the allocator returned by `allocator->Fork()`.
+         * Set `allocator` to nullptr to use the default one.
+         */
+        void SetAllocator(RuntimeAllocator::Ref allocator) { m_Allocator = allocator; }
+        const RuntimeAllocator::Ref& GetAllocator() const  { return m_Allocator; }
+        // Returns empty stats if this context has no allocator.
+        AllocatorStats GetAllocatorStats() const { return m_Allocator ? m_Allocator->GetStats() : AllocatorStats(); }
+
         Stack& GetStack()             { return m_Stack; }
         const Stack& GetStack() const { return m_Stack; }
 
@@ -310,7 +471,9 @@ if (state != RuntimeState::OK) // ERROR
                 return m_State;
 
             m_Running = true;
+            Core::Allocator* oldAllocator = Core::SetThreadAllocator(m_Allocator.Get());
             InternalStep();
+            Core::SetThreadAllocator(oldAllocator);
             m_Running = false;
 
             if (m_StopRequested)
@@ -325,25 +488,33 @@ if (state != RuntimeState::OK) // ERROR
          */
         RuntimeState Run()
         {
-            if (m_Running || IsDone() || m_State != RuntimeState::OK)
-                return m_State;
-
-            m_Running = true;
-            while (!IsDone() && m_State == RuntimeState::OK && !m_StopRequested) {
-                InternalStep();
-            }
-            m_Running = false;
+            return RunWithBudget(FUEL_UNLIMITED, NO_DEADLINE);
+        }
 
-            if (m_StopRequested)
-                m_StopRequested = false;
+        /**
+         * Like `::Run()` but returns RuntimeState::Yielded once about `maxInstructions` instructions were executed.
+         * The budget is only charged at backward jumps (by the length of the loop) and calls,
+         *  so it may be exceeded by the instructions of functions which don't loop.
+         * Running the context again resumes it where it yielded.
+         * Some instructions are always executed, so calling it in a loop makes progress even with no budget.
+         */
+        RuntimeState RunFor(uint64_t maxInstructions)
+        {
+            int64_t fuel = maxInstructions < (uint64_t)FUEL_UNLIMITED ? (int64_t)maxInstructions : FUEL_UNLIMITED;
+            return RunWithBudget(fuel > 0 ? fuel : 1, NO_DEADLINE);
+        }
 
-            return m_State;
+        // Like `::RunFor()` but yields once `deadline` has passed, which is checked every DEADLINE_CHECK_INTERVAL instructions.
+        RuntimeState RunUntil(std::chrono::steady_clock::time_point deadline)
+        {
+            return RunWithBudget(DEADLINE_CHECK_INTERVAL, deadline);
         }
 
         /**
          * This function may be called at any point. Calls to `::Run()` will
          * terminate as soon as the current instruction terminates execution.
          * Useful to create "breakpoint" native functions.
+         * It may also be called by other threads to make a running context yield (unless PULSAR_NO_ATOMIC is defined).
          */
         void Stop()
         {
@@ -353,21 +524,165 @@ if (state != RuntimeState::OK) // ERROR
         }
 
     private:
+        using SharedGlobals = SharedRef<List<GlobalInstance>>;
+        struct FunctionStateTable;
+
+        // Creates a context which shares `globals` and `functionStates`, Values of `module` must have already been promoted.
+        ExecutionContext(const Module& module, SharedGlobals globals, SharedRef<FunctionStateTable> functionStates);
+
+        // Creates a context which shares Globals and settings with this one.
+        ExecutionContext ForkBase() const;
+
+        // Copies Globals if they're shared with other contexts, must be called before writing to them.
+        List<GlobalInstance>& OwnGlobals()
+        {
+            if (m_Globals.SharedCount() > 1)
+                m_Globals = SharedGlobals::New(*m_Globals);
+            return *m_Globals;
+        }
+
+    private:
+        static constexpr int64_t FUEL_UNLIMITED = INT64_MAX;
+        static constexpr std::chrono::steady_clock::time_point NO_DEADLINE = std::chrono::steady_clock::time_point::min();
+
+        // Runs with `fuel` instructions of budget, which is refilled until `deadline` has passed.
+        RuntimeState RunWithBudget(int64_t fuel, std::chrono::steady_clock::time_point deadline);
+        // Called once m_Fuel has run out, returns false if the context should yield.
+        bool Refuel();
+
         // Must be called only if
         // - IsDone() returns false
         // - m_State is OK
         void InternalStep();
-        RuntimeState ExecuteInstruction(Frame& frame);
+        // Same as ::InternalStep() but keeps executing until
+        //  IsDone() returns true, m_State is not OK, a stop is requested or it runs out of budget.
+        void InternalRun();
+        // If SingleStep is true, only one instruction is executed.
+        // If Verified is true, checks proven by Pulsar::Verifier are skipped.
+        template<bool SingleStep, bool Verified>
+        void InternalExecute();
+
+#ifdef PULSAR_NO_ATOMIC
+        template<typename T>
+        using SharedField = T;
+#else // PULSAR_NO_ATOMIC
+        // Fields of FunctionStates which are read without holding the lock of their table.
+        template<typename T>
+        using SharedField = std::atomic<T>;
+#endif // PULSAR_NO_ATOMIC
+
+        /**
+         * Per-function state which is shared by a context and its forks, which may run on other threads.
+         * Each part is filled in once, under the lock of the table, and then published through its shared field.
+         */
+        struct FunctionState
+        {
+            // Code of the function with its instructions quickened, empty if it was never entered.
+            // Instructions are rewritten by multiple contexts at once, see LoadInstructionCode.
+            List<Instruction> QuickenedCode = List<Instruction>();
+            SharedField<Instruction*> Code = nullptr;
+            // Number of times the function was entered or jumped backwards.
+            PULSAR_ATOMIC_SIZE_T Hotness = 0;
+            SharedField<bool> CompileAttempted = false;
+            CompiledFunction::Ref Compiled = nullptr;
+            SharedField<CompiledFunction::EntryPoint> CompiledEntryPoint = nullptr;
+            // Translated the first time it's needed, empty if the function can't be translated.
+            RegisterFunction Registers = RegisterFunction();
+            SharedField<bool> RegistersTranslated = false;
+        };
+
+        // The states of the functions of the Module, they're replaced whenever the version of Module::Functions changes.
+        struct FunctionStateTable
+        {
+            static constexpr uint64_t INVALID_VERSION = uint64_t(-1);
+
+            FunctionStateTable() = default;
+            ~FunctionStateTable() { Reset(0, INVALID_VERSION); }
+
+            FunctionStateTable(const FunctionStateTable&) = delete;
+            FunctionStateTable& operator=(const FunctionStateTable&) = delete;
+
+            // Replaces all states with `count` new ones for version `version` of Module::Functions.
+            void Reset(size_t count, uint64_t version);
+
+            FunctionState* States = nullptr;
+            size_t Count = 0;
+            SharedField<uint64_t> FunctionsVersion = INVALID_VERSION;
+#ifndef PULSAR_NO_ATOMIC
+            std::mutex Mutex;
+#endif // PULSAR_NO_ATOMIC
+        };
+
+        // Returns the state of `function`, its code is copied on the first call by any context sharing the table.
+        // Returns nullptr if `function` is not part of the Module.
+        FunctionState* GetFunctionState(const FunctionDefinition& function);
+        // Copies the code of `function` into `state` if no other context did, or replaces the table if it's stale.
+        FunctionState* InitFunctionState(size_t funcIdx);
+        // Increases the hotness of the function and compiles it once it reaches m_CompileThreshold.
+        // Returns the entry point of its compiled code, if any.
+        CompiledFunction::EntryPoint GetCompiledEntryPoint(FunctionState& state, const FunctionDefinition& function);
+        // Runs compiled code on `frame` from its current instruction.
+        void RunCompiledCode(CompiledFunction::EntryPoint entryPoint, Frame& frame);
+        // Returns the translation of `function`, nullptr if it can't be translated.
+        const RegisterFunction* GetRegisterFunction(FunctionState& state, const FunctionDefinition& function);
+        // Runs `function` on `frame` from its current instruction until it exits to the stack interpreter.
+        // Instructions which are not translated are run through ::InternalExecute<true, true>().
+        void RunRegisterCode(const RegisterFunction& function, Frame& frame);
+        // Calls the fast native at `nativeIdx` on top of `callerStack` and sets m_State.
+        // Returns true if the Frame of the native was materialized, which is also the case if it failed.
+        bool CallFastNative(size_t nativeIdx, Stack& callerStack);
+
+    private:
+        // A flag which may be set by other threads while the context is running (see ::Stop()).
+        // Contexts are never copied while running, so copies start with the flag cleared.
+        class RunFlag
+        {
+        public:
+            RunFlag() = default;
+            RunFlag(const RunFlag&) {}
+            RunFlag& operator=(const RunFlag&) { Set(false); return *this; }
+
+            RunFlag& operator=(bool value) { Set(value); return *this; }
+            operator bool() const { return Get(); }
+
+            // Compiled code reads the flag through this pointer.
+            const bool* Data() const { return reinterpret_cast<const bool*>(&m_Value); }
+
+        private:
+#ifdef PULSAR_NO_ATOMIC
+            bool Get() const { return m_Value; }
+            void Set(bool value) { m_Value = value; }
+
+            bool m_Value = false;
+#else // PULSAR_NO_ATOMIC
+            bool Get() const { return m_Value.load(std::memory_order_relaxed); }
+            void Set(bool value) { m_Value.store(value, std::memory_order_relaxed); }
+
+            static_assert(sizeof(std::atomic_bool) == sizeof(bool) && std::atomic_bool::is_always_lock_free);
+            std::atomic_bool m_Value = false;
+#endif // PULSAR_NO_ATOMIC
+        };
 
     private:
         const Module& m_Module;
+        // Declared first so that values are freed while it's still alive.
+        RuntimeAllocator::Ref m_Allocator = nullptr;
         Pulsar::Stack m_Stack;
         Pulsar::CallStack m_CallStack;
-        List<GlobalInstance> m_Globals;
+        // Copy-on-write, shared with forks until either of them writes to a Global.
+        SharedGlobals m_Globals;
         CustomTypeGlobalDataMap m_CustomTypeGlobalData;
-
-        bool m_Running = false;
-        bool m_StopRequested = false;
+        // States[i] is the state of the i-th function of the Module, shared with forks.
+        SharedRef<FunctionStateTable> m_FunctionStates;
+        FunctionCompiler::Ref m_Compiler = nullptr;
+        size_t m_CompileThreshold = DEFAULT_COMPILE_THRESHOLD;
+        ExecutionEngine m_Engine = ExecutionEngine::Stack;
+
+        RunFlag m_Running;
+        RunFlag m_StopRequested;
+        // Charged at backward jumps and calls, the context yields once it's not positive.
+        int64_t m_Fuel = FUEL_UNLIMITED;
+        std::chrono::steady_clock::time_point m_Deadline = NO_DEADLINE;
         RuntimeState m_State = RuntimeState::OK;
     };
 }
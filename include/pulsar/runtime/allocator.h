@@ -0,0 +1,99 @@
+#ifndef _PULSAR_RUNTIME_ALLOCATOR_H
+#define _PULSAR_RUNTIME_ALLOCATOR_H
+
+#include "pulsar/core.h"
+
+#include "pulsar/structures/list.h"
+#include "pulsar/structures/ref.h"
+
+namespace Pulsar
+{
+    struct AllocatorStats
+    {
+        struct SizeClass
+        {
+            size_t BlockSize = 0;
+            size_t Allocations = 0;
+        };
+
+        // Size of the blocks which were allocated and not freed yet.
+        // Allocators may account for blocks freed by other threads later on.
+        size_t BytesInUse = 0;
+        size_t PeakBytesInUse = 0;
+        // Memory requested to the system to hold blocks.
+        size_t BytesReserved = 0;
+        size_t Allocations = 0;
+        // Allocations which were left to std::malloc.
+        size_t FallbackAllocations = 0;
+        List<SizeClass> SizeClasses = List<SizeClass>();
+    };
+
+    /**
+     * Extend this class to serve the allocations made while running an ExecutionContext (see ExecutionContext::SetAllocator).
+     * It's bound to the thread running the context through Core::SetThreadAllocator.
+     */
+    class RuntimeAllocator : public Core::Allocator
+    {
+    public:
+        using Ref = SharedRef<Pulsar::RuntimeAllocator>;
+
+        virtual ~RuntimeAllocator() = default;
+        // Returns the allocator of a fork of the context, which may run on another thread.
+        virtual Ref Fork() const = 0;
+        // Must not be called while the allocator is bound to another thread.
+        virtual AllocatorStats GetStats() const = 0;
+    };
+
+    /**
+     * Serves allocations up to MAX_BLOCK_SIZE bytes from slabs which hold blocks of a single size class.
+     * Each slab is a Core::MemoryRegion, so blocks may be freed by any thread and outlive the arena.
+     * Blocks freed while the arena is bound to the thread are reused right away,
+     *  the ones freed by other threads are reclaimed once the arena runs out of blocks of their size.
+     * Slabs are given back to the system once the arena is destroyed and all of their blocks are freed.
+     *
+     * An arena must only be bound to one thread at a time.
+     */
+    class ArenaAllocator : public RuntimeAllocator
+    {
+    public:
+        static constexpr size_t SIZE_CLASS_COUNT = 12;
+        static constexpr size_t SIZE_CLASSES[SIZE_CLASS_COUNT] = { 16, 32, 48, 64, 80, 96, 112, 128, 192, 256, 384, 512 };
+        static constexpr size_t MAX_BLOCK_SIZE = SIZE_CLASSES[SIZE_CLASS_COUNT-1];
+
+        ArenaAllocator() = default;
+        ~ArenaAllocator();
+
+        ArenaAllocator(const ArenaAllocator&) = delete;
+        ArenaAllocator(ArenaAllocator&&) = delete;
+        ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+        ArenaAllocator& operator=(ArenaAllocator&&) = delete;
+
+        void* Malloc(size_t size) override;
+        // Forks get their own arena.
+        RuntimeAllocator::Ref Fork() const override;
+        AllocatorStats GetStats() const override;
+
+    private:
+        class Slab;
+        struct FreeBlock { FreeBlock* Next; };
+
+        static size_t SizeClassOf(size_t size);
+        // Returns a block which was never allocated or was freed by another thread.
+        FreeBlock* NewBlock(size_t sizeClass);
+        // Moves the blocks freed by other threads into m_FreeBlocks, returns false if there were none.
+        bool ReclaimBlocks(size_t sizeClass);
+        void FreeLocal(Slab& slab, void* block);
+
+    private:
+        FreeBlock* m_FreeBlocks[SIZE_CLASS_COUNT] = {};
+        // Slabs of each size class, new blocks are taken from the first one.
+        Slab* m_Slabs[SIZE_CLASS_COUNT] = {};
+        size_t m_Allocations[SIZE_CLASS_COUNT] = {};
+        size_t m_BytesInUse = 0;
+        size_t m_PeakBytesInUse = 0;
+        size_t m_BytesReserved = 0;
+        size_t m_FallbackAllocations = 0;
+    };
+}
+
+#endif // _PULSAR_RUNTIME_ALLOCATOR_H
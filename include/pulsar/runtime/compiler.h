@@ -0,0 +1,64 @@
+#ifndef _PULSAR_RUNTIME_COMPILER_H
+#define _PULSAR_RUNTIME_COMPILER_H
+
+#include "pulsar/core.h"
+
+#include "pulsar/runtime/function.h"
+#include "pulsar/runtime/value.h"
+#include "pulsar/structures/ref.h"
+
+namespace Pulsar
+{
+    // Forward declaration for FunctionCompiler::Compile
+    class Module;
+
+    // State of a Frame shared between the ExecutionContext and compiled code.
+    struct CompiledFrameState
+    {
+        Value* Locals;
+        // Holds FunctionDefinition::MaxStackSize values, the ones after StackSize are Void or trivial (see below).
+        Value* Stack;
+        size_t StackSize;
+        // Index of the next instruction to execute.
+        size_t InstructionIndex;
+        const bool* StopRequested;
+        // See ExecutionContext::RunFor(), backward jumps subtract the length of the loop from it.
+        int64_t Fuel;
+    };
+
+    /**
+     * Native code compiled from the Code of a FunctionDefinition.
+     * The entry point starts executing from InstructionIndex and returns with the state
+     *  updated to the first instruction it could not execute (e.g. calls, type mismatches, errors).
+     * Such instruction is then executed by the ExecutionContext, which also reports errors.
+     *
+     * Compiled code may only create, overwrite and remove trivial Values (Void, numbers and references).
+     * If InstructionIndex or StackSize are not the ones expected by the code, it must return without changes.
+     */
+    class CompiledFunction
+    {
+    public:
+        using Ref = SharedRef<Pulsar::CompiledFunction>;
+        using EntryPoint = void(*)(CompiledFrameState* state);
+
+        virtual ~CompiledFunction() = default;
+        virtual EntryPoint GetEntryPoint() const = 0;
+    };
+
+    // Extend this class to provide compiled code to an ExecutionContext (see ExecutionContext::SetCompiler).
+    class FunctionCompiler
+    {
+    public:
+        using Ref = SharedRef<Pulsar::FunctionCompiler>;
+
+        virtual ~FunctionCompiler() = default;
+        /**
+         * Only verified functions with a known FunctionDefinition::MaxStackSize are compiled.
+         * Returns nullptr if `function` can't be compiled.
+         * Contexts on different threads may share the same compiler, so this function must be thread-safe.
+         */
+        virtual CompiledFunction::Ref Compile(const Module& module, const FunctionDefinition& function) = 0;
+    };
+}
+
+#endif // _PULSAR_RUNTIME_COMPILER_H
@@ -25,6 +25,13 @@ namespace Pulsar
         FunctionDebugSymbol DebugSymbol{Token(TokenType::None), (size_t)-1};
         List<BlockDebugSymbol> CodeDebugSymbols = List<BlockDebugSymbol>();
 
+        // Set by Pulsar::Verifier, verified functions are run without static checks.
+        // This flag is not serialized and must be reset if Code is changed.
+        bool Verified = false;
+        // Max size of the Stack while running Code, 0 if unknown.
+        // Computed by Pulsar::Verifier, it's only used to allocate the Stack of new Frames once.
+        size_t MaxStackSize = 0;
+
         bool HasDebugSymbol() const { return DebugSymbol.Token.Type != TokenType::None; }
         bool HasCodeDebugSymbols() const { return !CodeDebugSymbols.IsEmpty(); }
 
@@ -5,7 +5,7 @@
 
 namespace Pulsar
 {
-    enum class InstructionCode {
+    enum class InstructionCode : uint8_t {
         // Stack
         PushInt = 0x01,
         PushDbl = 0x02,
@@ -35,6 +35,10 @@ namespace Pulsar
         Return     = 0x20,
         Call       = 0x21,
         CallNative = 0x22,
+        // Like Call and ICall, the current frame is replaced by the callee's
+        //  if they return the same amount of values.
+        TailCall   = 0x23,
+        ITailCall  = 0x2E,
         ICall      = 0x2F,
 
         // Math
@@ -89,6 +93,31 @@ namespace Pulsar
         // Compound Type Checking
         IsNumber = 0x90,
         IsAnyFunctionReference = 0x91,
+        // Superinstructions (see Pulsar::PeepholeOptimizer)
+        IncLocal   = 0xA0, // PushLocal x; PushInt 1; DynSum; PopIntoLocal x
+        DecLocal   = 0xA1, // PushLocal x; PushInt 1; DynSub; PopIntoLocal x
+        PushLocal2 = 0xA2, // PushLocal a; PushLocal b (see PackArgs)
+        PushConstAppend = 0xA3, // PushConst c; Append
+        DupJZ = 0xA4, // Dup; JZ
+        CompareJGZ  = 0xA8, // Compare; JGZ
+        CompareJGEZ = 0xA9, // Compare; JGEZ
+        CompareJLZ  = 0xAA, // Compare; JLZ
+        CompareJLEZ = 0xAB, // Compare; JLEZ
+        EqualsJZ    = 0xAC, // Equals; JZ
+        EqualsJNZ   = 0xAD, // Equals; JNZ
+        // Quickened Instructions (see Pulsar::ExecutionContext)
+        // They're only written by an ExecutionContext into its own copy of the code.
+        // If an operand does not have the expected type they're rewritten back to the generic one.
+        SumII = 0xB0, // DynSum of two Integers
+        SumDD = 0xB1, // DynSum of two Doubles
+        SubII = 0xB2,
+        SubDD = 0xB3,
+        MulII = 0xB4,
+        MulDD = 0xB5,
+        DivII = 0xB6,
+        DivDD = 0xB7,
+        CompareII = 0xB8, // Compare of two Integers
+        CompareDD = 0xB9, // Compare of two Doubles
     };
 
     struct Instruction
@@ -97,6 +126,11 @@ namespace Pulsar
         int64_t Arg0 = 0;
     };
 
+    // Superinstructions with two operands store both of them within Arg0.
+    constexpr int64_t PackArgs(uint32_t first, uint32_t second) { return (int64_t)(((uint64_t)second << 32) | first); }
+    constexpr uint32_t UnpackFirstArg(int64_t arg0)  { return (uint32_t)((uint64_t)arg0 & 0xFFFFFFFF); }
+    constexpr uint32_t UnpackSecondArg(int64_t arg0) { return (uint32_t)((uint64_t)arg0 >> 32); }
+
     constexpr bool IsJump(InstructionCode jmpInstr)
     {
         switch (jmpInstr) {
@@ -113,6 +147,31 @@ namespace Pulsar
         }
     }
 
+    // Returns the jump performed by a superinstruction, or `instr` itself.
+    constexpr InstructionCode GetFusedJump(InstructionCode instr)
+    {
+        switch (instr) {
+        case InstructionCode::DupJZ:
+        case InstructionCode::EqualsJZ:
+            return InstructionCode::JZ;
+        case InstructionCode::EqualsJNZ:
+            return InstructionCode::JNZ;
+        case InstructionCode::CompareJGZ:
+            return InstructionCode::JGZ;
+        case InstructionCode::CompareJGEZ:
+            return InstructionCode::JGEZ;
+        case InstructionCode::CompareJLZ:
+            return InstructionCode::JLZ;
+        case InstructionCode::CompareJLEZ:
+            return InstructionCode::JLEZ;
+        default:
+            return instr;
+        }
+    }
+
+    // Returns true if Arg0 of `instr` is a jump offset.
+    constexpr bool HasJumpOffset(InstructionCode instr) { return IsJump(GetFusedJump(instr)); }
+
     constexpr InstructionCode InvertJump(InstructionCode jmpInstr)
     {
         switch (jmpInstr) {
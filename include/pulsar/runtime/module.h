@@ -11,11 +11,14 @@
 #include "pulsar/runtime/value.h"
 #include "pulsar/structures/hashmap.h"
 #include "pulsar/structures/list.h"
+#include "pulsar/structures/stringview.h"
+#include "pulsar/structures/versionedlist.h"
 
 namespace Pulsar
 {
-    // Forward declaration for NativeFunction
+    // Forward declarations for NativeFunction and FastNativeFunction
     class ExecutionContext;
+    class NativeCall;
 
     /**
      * This class represents an executable Pulsar program.
@@ -39,6 +42,17 @@ namespace Pulsar
 
         using NativeFunction = std::function<RuntimeState(ExecutionContext&)>;
 
+        /**
+         * Fast natives are called without pushing a Frame onto the CallStack, see NativeCall.
+         * `UserData` is passed to `Function` as is, it must outlive all contexts running the Module.
+         */
+        using FastNativeFunction = RuntimeState(*)(NativeCall& call, void* userData);
+        struct FastNativeBinding
+        {
+            FastNativeFunction Function = nullptr;
+            void* UserData = nullptr;
+        };
+
         // Returns the index of the declared function.
         size_t DeclareNativeFunction(FunctionSignature signature);
         size_t DeclareNativeFunction(const FunctionDefinition& definition);
@@ -49,43 +63,119 @@ namespace Pulsar
         size_t BindNativeFunction(const FunctionDefinition& definition, NativeFunction function);
         size_t BindNativeFunction(FunctionDefinition&& definition, NativeFunction function);
 
+        // Returns the index of the declared and bound function.
+        // A NativeFunction which materializes the Frame of the NativeCall is also bound, for users of NativeFunctions.
+        size_t BindFastNativeFunction(FunctionSignature signature, FastNativeFunction function, void* userData=nullptr);
+        size_t BindFastNativeFunction(const FunctionDefinition& definition, FastNativeFunction function, void* userData=nullptr);
+        size_t BindFastNativeFunction(FunctionDefinition&& definition, FastNativeFunction function, void* userData=nullptr);
+
+        // Returns nullptr if the native at `nativeIdx` is not a fast native.
+        const FastNativeBinding* GetFastNative(size_t nativeIdx) const
+        {
+            return nativeIdx < FastNativeFunctions.Size() && FastNativeFunctions[nativeIdx].Function
+                ? &FastNativeFunctions[nativeIdx] : nullptr;
+        }
+
         uint64_t BindCustomType(const String& name, CustomType::GlobalDataFactoryFn globalDataFactory=nullptr);
 
         // Be sure to check if the type exists first (unless you know for sure it exists)
         CustomType& GetCustomType(uint64_t typeId)             { return CustomTypes.Find(typeId)->Value(); }
         const CustomType& GetCustomType(uint64_t typeId) const { return CustomTypes.Find(typeId)->Value(); }
         bool HasCustomType(uint64_t typeId) const              { return CustomTypes.Find(typeId); }
+        // Returns the id of the first type named `name` which was bound by BindCustomType, or 0.
+        uint64_t FindCustomTypeByName(const String& name) const;
 
         bool HasSourceDebugSymbols() const { return !SourceDebugSymbols.IsEmpty(); }
 
         template<typename T>
         size_t FindDefinitionByName(const List<T>& definitions, const String& name) const;
 
-        size_t FindFunctionByName(const String& name) const { return FindDefinitionByName(Functions, name); }
-        size_t FindNativeByName(const String& name)   const { return FindDefinitionByName(NativeBindings, name); }
-        size_t FindGlobalByName(const String& name)   const { return FindDefinitionByName(Globals, name); }
+        // These use an index of the names which is built on the first lookup, they're O(1) on average.
+        size_t FindFunctionByName(StringView name) const;
+        size_t FindNativeByName(StringView name) const;
+        size_t FindGlobalByName(StringView name) const;
 
         size_t FindFunctionDefinitionBySignature(const List<FunctionDefinition>& definitions, FunctionSignature signature) const;
-        size_t FindFunctionBySignature(FunctionSignature signature) const { return FindFunctionDefinitionBySignature(Functions, signature); }
-        size_t FindNativeBySignature(FunctionSignature signature)   const { return FindFunctionDefinitionBySignature(NativeBindings, signature); }
+        size_t FindFunctionBySignature(FunctionSignature signature) const;
+        size_t FindNativeBySignature(FunctionSignature signature) const;
+
+        // Values of the Module are copied by all contexts which run it, which may be on different threads.
+        // The Parser and the ByteCode reader call this once the Module is complete,
+        //  it must be called again after adding Constants or Globals directly.
+        void PromoteValuesToAtomic();
 
     public:
         // Access these member variables only for:
         // - Inspecting the Module.
         // - Creating your own language which runs on the Pulsar VM.
-        List<FunctionDefinition> Functions;
-        List<FunctionDefinition> NativeBindings;
-        List<GlobalDefinition> Globals;
+        // The name indices are kept up to date by the versions of these lists, see VersionedList.
+        VersionedList<FunctionDefinition> Functions;
+        VersionedList<FunctionDefinition> NativeBindings;
+        VersionedList<GlobalDefinition> Globals;
         List<Value> Constants;
 
         List<SourceDebugSymbol> SourceDebugSymbols;
 
         // These are managed by the Bind* methods.
         List<NativeFunction> NativeFunctions;
+        List<FastNativeBinding> FastNativeFunctions;
         HashMap<uint64_t, CustomType> CustomTypes;
 
+    private:
+        size_t BindNative(FunctionDefinition&& definition, NativeFunction function, FastNativeBinding fastFunction);
+
+    private:
+        /**
+         * Maps names to the indices of the definitions of a List with that name.
+         * It's updated by lookups when the Version of the List changes,
+         *  lookups may happen on multiple threads as long as the List is not modified.
+         */
+        class NameIndex
+        {
+        public:
+            NameIndex() = default;
+            ~NameIndex() = default;
+
+            // Copies are rebuilt by their first lookup.
+            NameIndex(const NameIndex&) : NameIndex() { }
+            NameIndex(NameIndex&& other);
+
+            NameIndex& operator=(const NameIndex&) { Invalidate(); return *this; }
+            NameIndex& operator=(NameIndex&& other);
+
+            void Invalidate();
+
+            // Returns the last index of a definition named `name` for which `matches(index)` is true.
+            template<typename T, typename Fn>
+            size_t FindLast(const VersionedList<T>& definitions, StringView name, Fn matches) const;
+
+        private:
+            // Indexes the definitions which were appended since the last update,
+            //  or all of them if the List was modified in any other way.
+            void Update(uint64_t version, uint64_t editVersion, size_t count, std::function<StringView(size_t)> nameOf) const;
+
+            static constexpr uint64_t INVALID_VERSION = uint64_t(-1);
+
+        private:
+            // Last index of a definition whose name has the key as its hash.
+            mutable HashMap<size_t, size_t> m_LastByHash;
+            // m_Previous[i] is the previous index of a definition whose name has the same hash as the i-th, or INVALID_INDEX.
+            mutable List<size_t> m_Previous;
+#ifdef PULSAR_NO_ATOMIC
+            mutable uint64_t m_IndexedVersion = INVALID_VERSION;
+#else // PULSAR_NO_ATOMIC
+            mutable std::atomic_uint64_t m_IndexedVersion = INVALID_VERSION;
+            mutable std::mutex m_UpdateMutex;
+#endif // PULSAR_NO_ATOMIC
+        };
+
     private:
         uint64_t m_LastTypeId = 0;
+        HashMap<String, uint64_t> m_CustomTypeIds;
+
+        NameIndex m_FunctionNames;
+        NameIndex m_NativeNames;
+        NameIndex m_GlobalNames;
     };
 }
 
@@ -101,4 +191,24 @@ size_t Pulsar::Module::FindDefinitionByName(const List<T>& definitions, const St
     return INVALID_INDEX;
 }
 
+template<typename T, typename Fn>
+size_t Pulsar::Module::NameIndex::FindLast(const VersionedList<T>& definitions, StringView name, Fn matches) const
+{
+#ifdef PULSAR_NO_ATOMIC
+    if (m_IndexedVersion != definitions.Version())
+#else // PULSAR_NO_ATOMIC
+    if (m_IndexedVersion.load(std::memory_order_acquire) != definitions.Version())
+#endif // PULSAR_NO_ATOMIC
+        Update(definitions.Version(), definitions.EditVersion(), definitions.Size(),
+            [&definitions](size_t idx) { return StringView(definitions[idx].Name); });
+
+    const auto* last = m_LastByHash.Find(std::hash<StringView>{}(name));
+    size_t idx = last ? last->Value() : INVALID_INDEX;
+    for (; idx != INVALID_INDEX; idx = m_Previous[idx]) {
+        if (name == definitions[idx].Name && matches(idx))
+            return idx;
+    }
+    return INVALID_INDEX;
+}
+
 #endif // _PULSAR_RUNTIME_MODULE_H
@@ -0,0 +1,146 @@
+#ifndef _PULSAR_RUNTIME_REGISTERIR_H
+#define _PULSAR_RUNTIME_REGISTERIR_H
+
+#include "pulsar/core.h"
+
+#include "pulsar/runtime/function.h"
+#include "pulsar/runtime/instruction.h"
+#include "pulsar/structures/list.h"
+
+namespace Pulsar
+{
+    // Forward declaration for RegisterTranslator::Translate
+    class Module;
+
+    enum class RegisterOpCode : uint8_t
+    {
+        // Executes the Source instruction with the stack interpreter and continues.
+        Step,
+        // Returns to the stack interpreter, which continues from the Source instruction.
+        Exit,
+        // Dst = Imm
+        LoadInt, LoadDbl, LoadFunctionReference, LoadNativeFunctionReference,
+        // Dst = Module::Constants[Imm]
+        LoadConst,
+        // Dst = A
+        Copy,
+        // Dst = A, A = Void
+        Move,
+        // Dst <=> A
+        Swap,
+        // Dst = Void
+        Reset,
+        // Dst = A op B
+        Sum, Sub, Mul, Div, Mod,
+        BitAnd, BitOr, BitXor, BitShiftLeft, BitShiftRight,
+        Compare, Equals,
+        // Dst = op A
+        BitNot, Floor, Ceil,
+        Length, IsEmpty,
+        // Dst = Condition(A.Type()), Condition is one of the Is* instructions.
+        TypeCheck,
+        // Dst += 1, Dst -= 1
+        Increment, Decrement,
+        // Jumps to the instruction at index Imm within RegisterFunction::Code.
+        // Dst is the index of the target within FunctionDefinition::Code.
+        Jump,
+        // Jumps if Condition(A) is met, Condition is one of the J* instructions.
+        JumpIf,
+        // Jumps if Condition(A <=> B) is met.
+        CompareJump,
+        // Jumps if Condition(A == B) is met.
+        EqualsJump,
+    };
+
+    struct RegisterInstruction
+    {
+        RegisterOpCode Code;
+        InstructionCode Condition = InstructionCode::J;
+        uint32_t Dst = 0;
+        uint32_t A = 0;
+        uint32_t B = 0;
+        int64_t Imm = 0;
+        // Index of the instruction within FunctionDefinition::Code which produced this one.
+        size_t Source = 0;
+    };
+
+    /**
+     * A function translated into three-address code.
+     * Registers are the Locals of a Frame followed by the slots of its Stack (see ::StackRegister()).
+     * Stack slots are only guaranteed to hold the values expected by the stack interpreter
+     *  before instructions which have an entry point (i.e. EntryPoints[i] != NO_ENTRY).
+     */
+    struct RegisterFunction
+    {
+        static constexpr size_t NO_ENTRY = size_t(-1);
+        static constexpr uint32_t STACK_REGISTER_BIT = uint32_t(1) << 31;
+
+        static constexpr uint32_t LocalRegister(size_t localIdx) { return (uint32_t)localIdx; }
+        static constexpr uint32_t StackRegister(size_t slotIdx)  { return (uint32_t)slotIdx | STACK_REGISTER_BIT; }
+        static constexpr bool IsStackRegister(uint32_t reg)      { return (reg & STACK_REGISTER_BIT) != 0; }
+        static constexpr size_t RegisterIndex(uint32_t reg)      { return (size_t)(reg & ~STACK_REGISTER_BIT); }
+
+        List<RegisterInstruction> Code = List<RegisterInstruction>();
+        // EntryPoints[i] is the index within Code from where the i-th instruction of the function
+        //  can be resumed, or NO_ENTRY. The last entry refers to the end of the function.
+        List<size_t> EntryPoints = List<size_t>();
+        // StackDepths[i] is the size of the Stack before the i-th instruction of the function.
+        List<size_t> StackDepths = List<size_t>();
+        size_t MaxStackSize = 0;
+
+        bool IsEmpty() const { return Code.IsEmpty(); }
+    };
+
+    /**
+     * Translates the stack-based Code of verified functions into RegisterFunctions.
+     * Each stack slot becomes a register, since the depth of the Stack before each instruction is known.
+     * Values pushed from locals are read directly from them until they're needed on the Stack,
+     *  so most pushes, pops and swaps don't produce any instruction.
+     *
+     * Instructions which interact with the CallStack (i.e. calls) produce RegisterOpCode::Exit,
+     *  the ones which are less common (and calls to fast natives) produce RegisterOpCode::Step.
+     */
+    class RegisterTranslator
+    {
+    public:
+        RegisterTranslator() = default;
+        ~RegisterTranslator() = default;
+
+        // Returns false if `function` could not be translated, in which case `out` is cleared.
+        bool Translate(const Module& module, const FunctionDefinition& function, RegisterFunction& out);
+
+    private:
+        static constexpr size_t NO_ALIAS = size_t(-1);
+
+        void TranslateInstruction(size_t instrIdx);
+        // Returns the register which holds the value of the slot.
+        uint32_t ReadSlot(size_t slotIdx) const;
+        // Marks the slot as written to, dropping its alias.
+        uint32_t WriteSlot(size_t slotIdx);
+        // Copies aliased locals into the slots below `depth` and drops the aliases above it.
+        void Flush(size_t depth);
+        // Copies the local into the slots which alias it.
+        void FlushLocal(size_t localIdx);
+        bool HasAliases() const;
+        bool IsAliased(size_t localIdx) const;
+        // Returns true if the code can continue at `targetIdx` with `depth` values on the Stack.
+        bool CanContinueAt(size_t targetIdx, size_t depth) const;
+
+        // Returns the index of the emitted instruction, its Source is the instruction being translated.
+        size_t Emit(RegisterOpCode code, uint32_t dst=0, uint32_t a=0, uint32_t b=0, int64_t imm=0);
+        void EmitExit(size_t instrIdx);
+
+    private:
+        const Module* m_Module = nullptr;
+        const FunctionDefinition* m_Function = nullptr;
+        RegisterFunction* m_Out = nullptr;
+        size_t m_CurrentIdx = 0;
+        List<bool> m_IsJumpTarget;
+        // m_Aliases[i] is the local whose value is held by the i-th stack slot, or NO_ALIAS.
+        List<size_t> m_Aliases;
+        // Index of the last emitted instruction whose result can be written somewhere else, or NO_ENTRY.
+        size_t m_Retargetable = RegisterFunction::NO_ENTRY;
+    };
+}
+
+#endif // _PULSAR_RUNTIME_REGISTERIR_H
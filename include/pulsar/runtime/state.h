@@ -26,6 +26,9 @@ namespace Pulsar
         NoCustomTypeGlobalData,
         InvalidCustomTypeHandle,
         InvalidCustomTypeReference,
+        // Returned by ExecutionContext::RunFor() and ::RunUntil() when the context ran out of budget.
+        // It's never the state of a context, which can be resumed by running it again.
+        Yielded,
     };
 
     const char* RuntimeStateToString(RuntimeState rstate);
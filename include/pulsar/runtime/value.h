@@ -3,7 +3,7 @@
 
 #include "pulsar/core.h"
 
-#include "pulsar/structures/linkedlist.h"
+#include "pulsar/structures/chunkedlist.h"
 #include "pulsar/structures/ref.h"
 #include "pulsar/structures/string.h"
 
@@ -55,7 +55,7 @@ namespace Pulsar
     class Value
     {
     public:
-        using List = LinkedList<Value>;
+        using List = ChunkedList<Value>;
 
         // Type = Void
         Value();
@@ -76,18 +76,22 @@ namespace Pulsar
         ValueType Type() const    { return m_Type; }
         int64_t AsInteger() const { return m_AsInteger; }
         double AsDouble() const   { return m_AsDouble; }
-        List& AsList()             { return m_AsList; }
-        const List& AsList() const { return m_AsList; }
-        String& AsString()             { return m_AsString; }
-        const String& AsString() const { return m_AsString; }
-        CustomData& AsCustom()             { return m_AsCustom; }
-        const CustomData& AsCustom() const { return m_AsCustom; }
+        // Lists, Strings and CustomData are shared between copies of a Value.
+        // The non-const accessors give the Value its own copy if it's shared,
+        //  so references returned by them must not be kept while copying the Value.
+        // Values which are only read from should be accessed through const references.
+        List& AsList()             { Own(m_AsList); return m_AsList->Value; }
+        const List& AsList() const { return m_AsList->Value; }
+        String& AsString()             { Own(m_AsString); return m_AsString->Value; }
+        const String& AsString() const { return m_AsString->Value; }
+        CustomData& AsCustom()             { Own(m_AsCustom); return m_AsCustom->Value; }
+        const CustomData& AsCustom() const { return m_AsCustom->Value; }
 
         template<typename T>
         bool GetCustomAs(uint64_t typeId, SharedRef<T>& outRef) const
         {
             if (m_Type == ValueType::Custom) {
-                const auto& custom = m_AsCustom;
+                const auto& custom = m_AsCustom->Value;
                 if (custom.Type == typeId) {
                     outRef = custom.As<T>();
                     return true;
@@ -102,11 +106,30 @@ namespace Pulsar
         Value& SetDouble(double val)                   { Reset(); m_Type = ValueType::Double;                  m_AsDouble  = val;            return *this; }
         Value& SetFunctionReference(int64_t val)       { Reset(); m_Type = ValueType::FunctionReference;       m_AsInteger = val;            return *this; }
         Value& SetNativeFunctionReference(int64_t val) { Reset(); m_Type = ValueType::NativeFunctionReference; m_AsInteger = val;            return *this; }
-        Value& SetList(List&& val)                     { Reset(); m_Type = ValueType::List;                    m_AsList    = std::move(val); return *this; }
-        Value& SetList(const List& val)                { Reset(); m_Type = ValueType::List;                    m_AsList    = val;            return *this; }
-        Value& SetString(String&& val)                 { Reset(); m_Type = ValueType::String;                  m_AsString  = std::move(val); return *this; }
-        Value& SetString(const String& val)            { Reset(); m_Type = ValueType::String;                  m_AsString  = val;            return *this; }
-        Value& SetCustom(const CustomData& val)        { Reset(); m_Type = ValueType::Custom;                  m_AsCustom  = val;            return *this; }
+        Value& SetList(List&& val)                     { Reset(); m_Type = ValueType::List;                    m_AsList    = NewBox<List>(std::move(val)); return *this; }
+        Value& SetList(const List& val)                { Reset(); m_Type = ValueType::List;                    m_AsList    = NewBox<List>(val);            return *this; }
+        Value& SetString(String&& val)                 { Reset(); m_Type = ValueType::String;                  m_AsString  = NewBox<String>(std::move(val)); return *this; }
+        Value& SetString(const String& val)            { Reset(); m_Type = ValueType::String;                  m_AsString  = NewBox<String>(val);            return *this; }
+        Value& SetCustom(const CustomData& val)        { Reset(); m_Type = ValueType::Custom;                  m_AsCustom  = NewBox<CustomData>(val);        return *this; }
+
+    public:
+        /**
+         * Lists, Strings and CustomData are reference counted without atomic operations until they're promoted.
+         * Promotes all of them within this Value, so that copies of it can be used by other threads.
+         * It must be called by the only thread which may be using them, before handing them to another one
+         *  (e.g. before sending them through a channel).
+         */
+        void PromoteToAtomic() const;
+
+        /**
+         * Promotes this Value and marks it as deeply immutable, so that it can be shared with any thread at no cost.
+         * Promoting a frozen Value returns right away, even after copies of it were modified,
+         *  since modifying a frozen Value copies it if it's shared, otherwise it's no longer frozen.
+         * Values which are already shared with other threads may be frozen by any of them.
+         */
+        void Freeze() const;
+        // Integers, Doubles and references to functions are always frozen.
+        bool IsFrozen() const;
 
     public:
         struct ToReprOptions
@@ -123,7 +146,43 @@ namespace Pulsar
         String ToString(ToReprOptions options=ToReprOptions_Default) const;
         String ToRepr(ToReprOptions options=ToReprOptions_Default) const;
 
+    public:
+        // Byte offsets of the type and of the payload (e.g. AsInteger()) within a Value.
+        // Meant for code which accesses Values directly (see Pulsar::FunctionCompiler).
+        static size_t GetTypeOffset();
+        static size_t GetPayloadOffset();
+
     private:
+        // Payloads which are not trivially copyable live on the heap, so that a Value is at most 16 bytes.
+        template<typename T>
+        using Box = RefCountedValue<T>;
+
+        template<typename T, typename ...Args>
+        static Box<T>* NewBox(Args&& ...args)
+        {
+            Box<T>* box = static_cast<Box<T>*>(PULSAR_MALLOC(sizeof(Box<T>)));
+            PULSAR_PLACEMENT_NEW(RefCount, &box->RefCount, 1 | RefCount::LOCAL);
+            PULSAR_PLACEMENT_NEW(T, &box->Value, std::forward<Args>(args)...);
+            return box;
+        }
+
+        template<typename T>
+        static bool IsShared(const Box<T>* box) { return box->RefCount.Count() > 1; }
+
+        // Replaces `box` with a copy owned by this Value.
+        template<typename T>
+        static void Unshare(Box<T>*& box);
+
+        // Makes sure that `box` is only referenced by this Value before it's modified.
+        template<typename T>
+        static void Own(Box<T>*& box)
+        {
+            if (IsShared(box))
+                Unshare(box);
+            // Values which are stored within the box may be local.
+            else box->RefCount.MakeLocal();
+        }
+
         void Reset();
 
     private:
@@ -132,9 +191,9 @@ namespace Pulsar
         {
             int64_t m_AsInteger;
             double m_AsDouble;
-            List m_AsList;
-            String m_AsString;
-            CustomData m_AsCustom;
+            Box<List>* m_AsList;
+            Box<String>* m_AsString;
+            Box<CustomData>* m_AsCustom;
         };
     };
 }
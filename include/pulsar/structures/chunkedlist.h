@@ -0,0 +1,573 @@
+#ifndef _PULSAR_STRUCTURES_CHUNKEDLIST_H
+#define _PULSAR_STRUCTURES_CHUNKEDLIST_H
+
+#include "pulsar/core.h"
+
+#include "pulsar/structures/list.h"
+#include "pulsar/structures/ref.h"
+
+namespace Pulsar
+{
+    /**
+     * A list which stores its elements in reference counted chunks.
+     * Copies of a list share its chunks, which are copied only when they're modified
+     *  by a list which doesn't own them (i.e. through non-const accessors and iterators).
+     * Adding and removing elements at either end never copies a chunk shared with another list,
+     *  so copying a list and then using it as a queue or stack only costs a copy of its chunk references.
+     * Indexing is O(log n) since it's a binary search over the chunks (which are at most MAX_CHUNK_CAPACITY long).
+     * A list must only be used by one thread at a time until ::PromoteToAtomic() is called.
+     */
+    template<typename T>
+    class ChunkedList
+    {
+    public:
+        using Self = ChunkedList<T>;
+        // Forward Declarations
+        class ConstIterator;
+        class MutableIterator;
+
+        static constexpr size_t MIN_CHUNK_CAPACITY = 4;
+        static constexpr size_t MAX_CHUNK_CAPACITY = 64;
+
+    private:
+        struct Chunk
+        {
+            Pulsar::RefCount RefCount;
+            uint32_t Capacity;
+            // Range of the constructed elements.
+            uint32_t Begin;
+            uint32_t End;
+
+            // The elements are stored right after the header.
+            static constexpr size_t ItemsOffset() { return (sizeof(Chunk)+alignof(T)-1) / alignof(T) * alignof(T); }
+
+            T* Items()             { return reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(this)+ItemsOffset()); }
+            const T* Items() const { return reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(this)+ItemsOffset()); }
+        };
+
+        // The elements of a list within a Chunk, which may also hold elements of other lists.
+        struct Slice
+        {
+            Chunk* Data;
+            uint32_t Begin;
+            uint32_t End;
+            // Position of the first element of the slice within the list, relative to the one of the first slice.
+            // It only increases from one slice to the next, so that slices can be looked up by index.
+            int64_t Offset;
+        };
+
+    public:
+        ChunkedList() = default;
+        ~ChunkedList()
+        {
+            Clear();
+            PULSAR_FREE((void*)m_Slices);
+        }
+
+        explicit ChunkedList(const List<T>& list)
+            : ChunkedList()
+        {
+            for (const T& v : list) Append(v);
+        }
+
+        explicit ChunkedList(List<T>&& list)
+            : ChunkedList()
+        {
+            for (T& v : list) Append(std::move(v));
+            list.Clear();
+        }
+
+        ChunkedList(const Self& other)
+            : ChunkedList()
+        {
+            *this = other;
+        }
+
+        ChunkedList(Self&& other)
+            : ChunkedList()
+        {
+            *this = std::move(other);
+        }
+
+        Self& operator=(const Self& other)
+        {
+            if (this == &other)
+                return *this;
+            Clear();
+            size_t sliceCount = other.m_LastSlice - other.m_FirstSlice;
+            ReserveSlices(sliceCount);
+            for (size_t i = other.m_FirstSlice; i < other.m_LastSlice; i++) {
+                const Slice& slice = other.m_Slices[i];
+                slice.Data->RefCount.Increment();
+                m_Slices[m_LastSlice++] = slice;
+            }
+            m_Length = other.m_Length;
+            return *this;
+        }
+
+        Self& operator=(Self&& other)
+        {
+            if (this == &other)
+                return *this;
+            Clear();
+            PULSAR_FREE((void*)m_Slices);
+            m_Slices        = other.m_Slices;
+            m_SliceCapacity = other.m_SliceCapacity;
+            m_FirstSlice    = other.m_FirstSlice;
+            m_LastSlice     = other.m_LastSlice;
+            m_Length        = other.m_Length;
+            other.m_Slices        = nullptr;
+            other.m_SliceCapacity = 0;
+            other.m_FirstSlice    = 0;
+            other.m_LastSlice     = 0;
+            other.m_Length        = 0;
+            return *this;
+        }
+
+        // Unlike LinkedList, returns the new element instead of its node (see docs/API_CHANGES.md).
+        template<typename ...Args>
+        T& Prepend(Args&& ...init)
+        {
+            if (!IsEmpty()) {
+                Slice& front = m_Slices[m_FirstSlice];
+                if (TryOwn(front) && front.Begin > 0) {
+                    T* item = &front.Data->Items()[--front.Begin];
+                    PULSAR_PLACEMENT_NEW(T, item, std::forward<Args>(init)...);
+                    front.Data->Begin = front.Begin;
+                    front.Offset--;
+                    m_Length++;
+                    return *item;
+                }
+            }
+
+            Chunk* chunk = NewChunk(NextChunkCapacity());
+            chunk->Begin = chunk->Capacity-1;
+            chunk->End   = chunk->Capacity;
+            T* item = &chunk->Items()[chunk->Begin];
+            PULSAR_PLACEMENT_NEW(T, item, std::forward<Args>(init)...);
+            PushFrontSlice({ chunk, chunk->Begin, chunk->End, IsEmpty() ? 0 : m_Slices[m_FirstSlice].Offset-1 });
+            m_Length++;
+            return *item;
+        }
+
+        // Unlike LinkedList, returns the new element instead of its node (see docs/API_CHANGES.md).
+        template<typename ...Args>
+        T& Append(Args&& ...init)
+        {
+            if (!IsEmpty()) {
+                Slice& back = m_Slices[m_LastSlice-1];
+                if (TryOwn(back) && back.End < back.Data->Capacity) {
+                    T* item = &back.Data->Items()[back.End++];
+                    PULSAR_PLACEMENT_NEW(T, item, std::forward<Args>(init)...);
+                    back.Data->End = back.End;
+                    m_Length++;
+                    return *item;
+                }
+            }
+
+            Chunk* chunk = NewChunk(NextChunkCapacity());
+            chunk->Begin = 0;
+            chunk->End   = 1;
+            T* item = &chunk->Items()[0];
+            PULSAR_PLACEMENT_NEW(T, item, std::forward<Args>(init)...);
+            PushBackSlice({ chunk, chunk->Begin, chunk->End, EndOffset() });
+            m_Length++;
+            return *item;
+        }
+
+        // Moves the elements of `other` at the end of this list, `other` is left empty.
+        Self& Concat(Self&& other)
+        {
+            if (this == &other) {
+                Self copy(other);
+                return Concat(std::move(copy));
+            }
+
+            if (other.m_Length <= MIN_CHUNK_CAPACITY) {
+                // Small lists are copied to avoid fragmenting this one.
+                for (T& v : other) Append(std::move(v));
+                other.Clear();
+                return *this;
+            }
+
+            ReserveSlices(other.m_LastSlice - other.m_FirstSlice);
+            int64_t offsetDelta = EndOffset() - other.m_Slices[other.m_FirstSlice].Offset;
+            for (size_t i = other.m_FirstSlice; i < other.m_LastSlice; i++) {
+                Slice& slice = m_Slices[m_LastSlice++];
+                slice = other.m_Slices[i];
+                slice.Offset += offsetDelta;
+            }
+            m_Length += other.m_Length;
+
+            other.m_FirstSlice = 0;
+            other.m_LastSlice  = 0;
+            other.m_Length     = 0;
+            return *this;
+        }
+
+        Self& RemoveFront(size_t n)
+        {
+            while (n > 0 && !IsEmpty()) {
+                Slice& front = m_Slices[m_FirstSlice];
+                size_t count = front.End - front.Begin;
+                if (count > n) count = n;
+                if (IsOwned(front)) {
+                    TrimChunk(front);
+                    DestroyItems(front.Data, front.Begin, front.Begin+(uint32_t)count);
+                    front.Data->Begin += (uint32_t)count;
+                }
+                front.Begin += (uint32_t)count;
+                front.Offset += (int64_t)count;
+                m_Length -= count;
+                n -= count;
+                if (front.Begin == front.End)
+                    ReleaseChunk(m_Slices[m_FirstSlice++].Data);
+            }
+            if (IsEmpty())
+                m_FirstSlice = m_LastSlice = 0;
+            return *this;
+        }
+
+        Self& RemoveBack(size_t n)
+        {
+            while (n > 0 && !IsEmpty()) {
+                Slice& back = m_Slices[m_LastSlice-1];
+                size_t count = back.End - back.Begin;
+                if (count > n) count = n;
+                if (IsOwned(back)) {
+                    TrimChunk(back);
+                    DestroyItems(back.Data, back.End-(uint32_t)count, back.End);
+                    back.Data->End -= (uint32_t)count;
+                }
+                back.End -= (uint32_t)count;
+                m_Length -= count;
+                n -= count;
+                if (back.Begin == back.End)
+                    ReleaseChunk(m_Slices[--m_LastSlice].Data);
+            }
+            if (IsEmpty())
+                m_FirstSlice = m_LastSlice = 0;
+            return *this;
+        }
+
+        T& Front()
+        {
+            PULSAR_ASSERT(!IsEmpty(), "Getting the front of an empty ChunkedList.");
+            Slice& front = m_Slices[m_FirstSlice];
+            Own(front);
+            return front.Data->Items()[front.Begin];
+        }
+
+        const T& Front() const
+        {
+            PULSAR_ASSERT(!IsEmpty(), "Getting the front of an empty ChunkedList.");
+            const Slice& front = m_Slices[m_FirstSlice];
+            return front.Data->Items()[front.Begin];
+        }
+
+        T& Back()
+        {
+            PULSAR_ASSERT(!IsEmpty(), "Getting the back of an empty ChunkedList.");
+            Slice& back = m_Slices[m_LastSlice-1];
+            Own(back);
+            return back.Data->Items()[back.End-1];
+        }
+
+        const T& Back() const
+        {
+            PULSAR_ASSERT(!IsEmpty(), "Getting the back of an empty ChunkedList.");
+            const Slice& back = m_Slices[m_LastSlice-1];
+            return back.Data->Items()[back.End-1];
+        }
+
+        T& operator[](size_t index)
+        {
+            PULSAR_ASSERT(index < Length(), "ChunkedList index out of bounds.");
+            Slice& slice = m_Slices[FindSlice(index)];
+            Own(slice);
+            return slice.Data->Items()[SliceIndex(slice, index)];
+        }
+
+        const T& operator[](size_t index) const
+        {
+            PULSAR_ASSERT(index < Length(), "ChunkedList index out of bounds.");
+            const Slice& slice = m_Slices[FindSlice(index)];
+            return slice.Data->Items()[SliceIndex(slice, index)];
+        }
+
+        void Clear()
+        {
+            for (size_t i = m_FirstSlice; i < m_LastSlice; i++)
+                ReleaseChunk(m_Slices[i].Data);
+            m_FirstSlice = 0;
+            m_LastSlice  = 0;
+            m_Length     = 0;
+        }
+
+        size_t Length() const { return m_Length; }
+        bool IsEmpty() const  { return m_Length == 0; }
+
+        /**
+         * Chunks are created with a local RefCount, which must be promoted before the list is handed to another thread.
+         * `promoteItem` is called on every element of the local chunks, including the ones which belong to other lists,
+         *  since the last list to release a chunk destroys all of them.
+         * Chunks which are already atomic are skipped, since they become local again before being modified.
+         */
+        template<typename Fn>
+        void PromoteToAtomic(Fn promoteItem) const
+        {
+            for (size_t i = m_FirstSlice; i < m_LastSlice; i++) {
+                Chunk* chunk = m_Slices[i].Data;
+                if (!chunk->RefCount.IsLocal())
+                    continue;
+                for (uint32_t j = chunk->Begin; j < chunk->End; j++)
+                    promoteItem(chunk->Items()[j]);
+                chunk->RefCount.PromoteToAtomic();
+            }
+        }
+
+        /**
+         * Like ::PromoteToAtomic(), but it also freezes chunks which are already atomic (see Pulsar::RefCount::Freeze()).
+         * `freezeItem` must freeze every element, so that frozen chunks only hold frozen elements.
+         */
+        template<typename Fn>
+        void Freeze(Fn freezeItem) const
+        {
+            for (size_t i = m_FirstSlice; i < m_LastSlice; i++) {
+                Chunk* chunk = m_Slices[i].Data;
+                if (chunk->RefCount.IsFrozen())
+                    continue;
+                for (uint32_t j = chunk->Begin; j < chunk->End; j++)
+                    freezeItem(chunk->Items()[j]);
+                chunk->RefCount.Freeze();
+            }
+        }
+
+        ConstIterator Begin() const { return ConstIterator(m_Slices+m_FirstSlice, m_Slices+m_LastSlice); }
+        ConstIterator End()   const { return ConstIterator(m_Slices+m_LastSlice, m_Slices+m_LastSlice); }
+        // Returns an iterator to the element at `index`, or End() if it's out of bounds.
+        ConstIterator IteratorAt(size_t index) const
+        {
+            if (index >= Length())
+                return End();
+            const Slice* slice = m_Slices+FindSlice(index);
+            return ConstIterator(slice, m_Slices+m_LastSlice, SliceIndex(*slice, index));
+        }
+        // Gives this list its own copy of all shared chunks.
+        MutableIterator Begin()
+        {
+            for (size_t i = m_FirstSlice; i < m_LastSlice; i++)
+                Own(m_Slices[i]);
+            return MutableIterator(m_Slices+m_FirstSlice, m_Slices+m_LastSlice);
+        }
+        MutableIterator End() { return MutableIterator(m_Slices+m_LastSlice, m_Slices+m_LastSlice); }
+
+        PULSAR_ITERABLE_IMPL(Self, ConstIterator, MutableIterator)
+
+    public:
+        template<typename TSlice, typename TValue>
+        class BaseIterator
+        {
+        public:
+            BaseIterator(TSlice* slice, TSlice* sliceEnd)
+                : m_Slice(slice), m_SliceEnd(sliceEnd), m_Index(slice < sliceEnd ? slice->Begin : 0) {}
+            BaseIterator(TSlice* slice, TSlice* sliceEnd, uint32_t index)
+                : m_Slice(slice), m_SliceEnd(sliceEnd), m_Index(index) {}
+
+            bool operator==(const BaseIterator& other) const { return m_Slice == other.m_Slice && m_Index == other.m_Index; }
+            bool operator!=(const BaseIterator& other) const { return !(*this == other); }
+            TValue& operator*() const { return m_Slice->Data->Items()[m_Index]; }
+
+            BaseIterator& operator++()
+            {
+                PULSAR_ASSERT(m_Slice < m_SliceEnd, "Called ++ChunkedList<T>::Iterator on complete iterator.");
+                if (++m_Index >= m_Slice->End) {
+                    ++m_Slice;
+                    m_Index = m_Slice < m_SliceEnd ? m_Slice->Begin : 0;
+                }
+                return *this;
+            }
+
+            BaseIterator operator++(int)
+            {
+                BaseIterator ret = *this;
+                ++(*this);
+                return ret;
+            }
+        private:
+            TSlice* m_Slice;
+            TSlice* m_SliceEnd;
+            uint32_t m_Index;
+        };
+
+        class ConstIterator : public BaseIterator<const Slice, const T>
+        {
+        public:
+            ConstIterator(const Slice* slice, const Slice* sliceEnd)
+                : BaseIterator<const Slice, const T>(slice, sliceEnd) {}
+            ConstIterator(const Slice* slice, const Slice* sliceEnd, uint32_t index)
+                : BaseIterator<const Slice, const T>(slice, sliceEnd, index) {}
+        };
+
+        class MutableIterator : public BaseIterator<Slice, T>
+        {
+        public:
+            MutableIterator(Slice* slice, Slice* sliceEnd)
+                : BaseIterator<Slice, T>(slice, sliceEnd) {}
+        };
+
+    private:
+        static Chunk* NewChunk(size_t capacity)
+        {
+            Chunk* chunk = (Chunk*)PULSAR_MALLOC(Chunk::ItemsOffset() + capacity*sizeof(T));
+            PULSAR_PLACEMENT_NEW(RefCount, &chunk->RefCount, 1 | RefCount::LOCAL);
+            chunk->Capacity = (uint32_t)capacity;
+            chunk->Begin = 0;
+            chunk->End   = 0;
+            return chunk;
+        }
+
+        static void DestroyItems(Chunk* chunk, uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+                chunk->Items()[i].~T();
+        }
+
+        static void ReleaseChunk(Chunk* chunk)
+        {
+            if (chunk->RefCount.Decrement() > 1)
+                return;
+            DestroyItems(chunk, chunk->Begin, chunk->End);
+            chunk->RefCount.~RefCount();
+            PULSAR_FREE((void*)chunk);
+        }
+
+        static bool IsOwned(const Slice& slice) { return slice.Data->RefCount.Count() == 1; }
+
+        // Destroys the elements of an owned chunk which are not part of `slice`.
+        static void TrimChunk(Slice& slice)
+        {
+            Chunk* chunk = slice.Data;
+            DestroyItems(chunk, chunk->Begin, slice.Begin);
+            DestroyItems(chunk, slice.End, chunk->End);
+            chunk->Begin = slice.Begin;
+            chunk->End   = slice.End;
+        }
+
+        // Returns true if the chunk of `slice` is owned by this list and only holds its elements.
+        static bool TryOwn(Slice& slice)
+        {
+            if (!IsOwned(slice))
+                return false;
+            // Elements which are added to the chunk may be local.
+            slice.Data->RefCount.MakeLocal();
+            TrimChunk(slice);
+            return true;
+        }
+
+        // Makes sure that the chunk of `slice` is owned by this list, copying it if it's shared.
+        static void Own(Slice& slice)
+        {
+            if (TryOwn(slice))
+                return;
+            Chunk* copy = NewChunk(slice.Data->Capacity);
+            for (uint32_t i = slice.Begin; i < slice.End; i++)
+                PULSAR_PLACEMENT_NEW(T, &copy->Items()[i], slice.Data->Items()[i]);
+            copy->Begin = slice.Begin;
+            copy->End   = slice.End;
+            ReleaseChunk(slice.Data);
+            slice.Data = copy;
+        }
+
+        // Chunks grow with the list, so that small lists don't waste space.
+        size_t NextChunkCapacity() const
+        {
+            return m_Length < MIN_CHUNK_CAPACITY ? MIN_CHUNK_CAPACITY
+                : m_Length > MAX_CHUNK_CAPACITY ? MAX_CHUNK_CAPACITY
+                : m_Length;
+        }
+
+        // Offset of the slice which would follow the last one.
+        int64_t EndOffset() const
+        {
+            if (IsEmpty())
+                return 0;
+            const Slice& back = m_Slices[m_LastSlice-1];
+            return back.Offset + (int64_t)(back.End - back.Begin);
+        }
+
+        // Returns the index within m_Slices of the slice which holds the element at `index`.
+        size_t FindSlice(size_t index) const
+        {
+            int64_t offset = m_Slices[m_FirstSlice].Offset + (int64_t)index;
+            size_t lo = m_FirstSlice;
+            size_t hi = m_LastSlice;
+            while (hi - lo > 1) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (m_Slices[mid].Offset <= offset)
+                    lo = mid;
+                else hi = mid;
+            }
+            return lo;
+        }
+
+        // Returns the index within the chunk of `slice` of the element at `index`.
+        uint32_t SliceIndex(const Slice& slice, size_t index) const
+        {
+            int64_t offset = m_Slices[m_FirstSlice].Offset + (int64_t)index;
+            return slice.Begin + (uint32_t)(offset - slice.Offset);
+        }
+
+        // Makes space for `count` slices at the back.
+        void ReserveSlices(size_t count)
+        {
+            if (m_LastSlice+count <= m_SliceCapacity)
+                return;
+            size_t sliceCount = m_LastSlice - m_FirstSlice;
+            size_t newCapacity = (sliceCount+count)*3/2+1;
+            Slice* newSlices = (Slice*)PULSAR_MALLOC(newCapacity*sizeof(Slice));
+            if (m_Slices)
+                PULSAR_MEMCPY((void*)newSlices, (void*)(m_Slices+m_FirstSlice), sliceCount*sizeof(Slice));
+            PULSAR_FREE((void*)m_Slices);
+            m_Slices = newSlices;
+            m_SliceCapacity = newCapacity;
+            m_FirstSlice = 0;
+            m_LastSlice  = sliceCount;
+        }
+
+        void PushBackSlice(const Slice& slice)
+        {
+            ReserveSlices(1);
+            m_Slices[m_LastSlice++] = slice;
+        }
+
+        void PushFrontSlice(const Slice& slice)
+        {
+            if (m_FirstSlice == 0) {
+                // Leave as much space at the front as there are slices, so that prepending is amortized O(1).
+                size_t sliceCount = m_LastSlice;
+                size_t frontSpace = sliceCount+1;
+                size_t newCapacity = frontSpace+sliceCount*3/2+1;
+                Slice* newSlices = (Slice*)PULSAR_MALLOC(newCapacity*sizeof(Slice));
+                if (m_Slices)
+                    PULSAR_MEMCPY((void*)(newSlices+frontSpace), (void*)m_Slices, sliceCount*sizeof(Slice));
+                PULSAR_FREE((void*)m_Slices);
+                m_Slices = newSlices;
+                m_SliceCapacity = newCapacity;
+                m_FirstSlice = frontSpace;
+                m_LastSlice  = frontSpace+sliceCount;
+            }
+            m_Slices[--m_FirstSlice] = slice;
+        }
+
+    private:
+        Slice* m_Slices = nullptr;
+        size_t m_SliceCapacity = 0;
+        // Range of the slices within m_Slices.
+        size_t m_FirstSlice = 0;
+        size_t m_LastSlice  = 0;
+        size_t m_Length = 0;
+    };
+}
+
+#endif // _PULSAR_STRUCTURES_CHUNKEDLIST_H
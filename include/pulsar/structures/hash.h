@@ -0,0 +1,20 @@
+#ifndef _PULSAR_STRUCTURES_HASH_H
+#define _PULSAR_STRUCTURES_HASH_H
+
+#include "pulsar/core.h"
+
+namespace Pulsar::Hash
+{
+    // Hashes `size` bytes in the style of wyhash, it's not meant to be cryptographically secure.
+    uint64_t Bytes(const void* data, size_t size, uint64_t seed=0);
+
+    // Spreads the bits of a hash which may be weak (e.g. std::hash of integers is usually the identity).
+    // Both the highest and lowest bits of the result depend on all bits of `hash`.
+    inline uint64_t Mix(uint64_t hash)
+    {
+        hash *= 0x9e3779b97f4a7c15;
+        return hash ^ (hash >> 32);
+    }
+}
+
+#endif // _PULSAR_STRUCTURES_HASH_H
@@ -3,7 +3,7 @@
 
 #include "pulsar/core.h"
 
-#include "pulsar/structures/list.h"
+#include "pulsar/structures/hash.h"
 
 namespace Pulsar
 {
@@ -18,102 +18,98 @@ namespace Pulsar
         using Map = HashMap<K, V>;
         friend Map;
 
-        HashMapBucket()
-            : m_KeyStorage{}, m_ValueStorage{} { };
-        ~HashMapBucket() { Delete(); }
+        template<typename KArg, typename ...Args>
+        HashMapBucket(std::piecewise_construct_t, KArg&& key, Args&& ...args)
+            : m_Key(std::forward<KArg>(key)), m_Value(MakeValue(std::forward<Args>(args)...)) { }
 
-        HashMapBucket(const Self& other)
-        {
-            if (other.IsPopulated()) {
-                Fill(other.m_Key, other.m_Value);
-            } else {
-                m_IsFilled = other.m_IsFilled;
-                m_IsDeleted = other.m_IsDeleted;
-            }
-        }
-
-        HashMapBucket(Self&& other)
-        {
-            if (other.IsPopulated()) {
-                Fill(std::move(other.m_Key), std::move(other.m_Value));
-            } else {
-                m_IsFilled = other.m_IsFilled;
-                m_IsDeleted = other.m_IsDeleted;
-            }
-            other.Delete();
-        }
+        HashMapBucket(const Self& other) = default;
+        HashMapBucket(Self&& other) = default;
 
         Self& operator=(const Self& other) = delete;
         Self& operator=(Self&& other) = delete;
 
-        void Delete()
+        const K& Key() const   { return m_Key; }
+        V& Value()             { return m_Value; }
+        const V& Value() const { return m_Value; }
+
+    private:
+        // Aggregates are initialized like PULSAR_PLACEMENT_NEW does.
+        template<typename ...Args>
+        static V MakeValue(Args&& ...args)
         {
-            if (IsPopulated()) {
-                m_Key.~K();
-                m_Value.~V();
-            }
-            m_IsDeleted = true;
+            if constexpr (std::is_aggregate<V>())
+                return V{std::forward<Args>(args)...};
+            else return V(std::forward<Args>(args)...);
         }
 
-        bool IsDeleted() const { return m_IsDeleted; }
-        bool IsPopulated() const { return m_IsFilled && !m_IsDeleted; }
-
-        operator bool() const { return IsPopulated(); }
+    private:
+        K m_Key;
+        V m_Value;
+    };
 
-        // V& operator*() { return Value(); }
-        // const V& operator*() const { return Value(); }
+    /**
+     * The control bytes of WIDTH consecutive buckets of a HashMap, which are matched all at once.
+     * A control byte is either EMPTY or holds the 7 highest bits of the hash of the key within the bucket.
+     */
+    class HashMapGroup
+    {
+    public:
+        static constexpr size_t WIDTH = 16;
+        static constexpr int8_t EMPTY = -128;
 
-        const K& Key() const
-        {
-            PULSAR_ASSERT(IsPopulated(), "Trying to get the key of an empty HashMapBucket.");
-            return m_Key;
-        }
+        // The control bytes of maps which have no buckets.
+        static inline int8_t EmptyGroup[WIDTH] = {
+            EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+            EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+        };
 
-        V& Value()
+        explicit HashMapGroup(const int8_t* control)
         {
-            PULSAR_ASSERT(IsPopulated(), "Trying to get the value of an empty HashMapBucket.");
-            return m_Value;
+#ifdef PULSAR_HAS_SSE2
+            m_Control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+#else // PULSAR_HAS_SSE2
+            PULSAR_MEMCPY(m_Control, control, WIDTH);
+#endif // PULSAR_HAS_SSE2
         }
 
-        const V& Value() const
+        // Bit i is set if the i-th control byte is `tag`.
+        uint32_t Match(int8_t tag) const
         {
-            PULSAR_ASSERT(IsPopulated(), "Trying to get the value of an empty HashMapBucket.");
-            return m_Value;
+#ifdef PULSAR_HAS_SSE2
+            return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), m_Control));
+#else // PULSAR_HAS_SSE2
+            uint32_t mask = 0;
+            for (size_t i = 0; i < WIDTH; i++)
+                mask |= (uint32_t)(m_Control[i] == tag) << i;
+            return mask;
+#endif // PULSAR_HAS_SSE2
         }
 
-    protected:
-        template<typename ...Args>
-        void Fill(const K& key, Args&& ...args) { K _k = key; Fill(std::move(_k), std::forward<Args>(args)...); }
-
-        template<typename ...Args>
-        void Fill(K&& key, Args&& ...args)
+        uint32_t MatchEmpty() const
         {
-            if (IsPopulated()) {
-                Delete();
-            }
-
-            m_IsFilled = true;
-            m_IsDeleted = false;
-
-            PULSAR_PLACEMENT_NEW(K, &m_Key, std::move(key));
-            PULSAR_PLACEMENT_NEW(V, &m_Value, std::forward<Args>(args)...);
+#ifdef PULSAR_HAS_SSE2
+            // EMPTY is the only control byte with its sign bit set.
+            return (uint32_t)_mm_movemask_epi8(m_Control);
+#else // PULSAR_HAS_SSE2
+            return Match(EMPTY);
+#endif // PULSAR_HAS_SSE2
         }
 
     private:
-        bool m_IsFilled  = false;
-        bool m_IsDeleted = false;
-        union
-        {
-            K m_Key;
-            uint8_t m_KeyStorage[sizeof(K)];
-        };
-        union
-        {
-            V m_Value;
-            uint8_t m_ValueStorage[sizeof(V)];
-        };     
+#ifdef PULSAR_HAS_SSE2
+        __m128i m_Control;
+#else // PULSAR_HAS_SSE2
+        int8_t m_Control[WIDTH];
+#endif // PULSAR_HAS_SSE2
     };
 
+    /**
+     * Open addressing hash map with linear probing over a power of two number of buckets.
+     * Lookups go through the control bytes of the buckets (see HashMapGroup) a group at a time,
+     *  keys are only compared when their control byte matches the hash of the key being looked up.
+     * Removing a key moves the following keys of its probe sequence back, so no tombstones are left behind.
+     * Inserting or removing keys invalidates pointers to buckets.
+     */
     template<typename K, typename V>
     class HashMap
     {
@@ -130,42 +126,74 @@ namespace Pulsar
             V Value;
         };
 
-        HashMap() { Clear(); }
+        static constexpr size_t MIN_CAPACITY = 8;
+
+        HashMap() = default;
         HashMap(std::initializer_list<Pair> init)
             : HashMap()
         {
+            Reserve(init.size());
             for (auto it = init.begin(); it != init.end(); it++)
                 Insert(it->Key, it->Value);
         }
 
-        ~HashMap() = default;
+        ~HashMap() { Clear(); }
 
-        // Capacity cannot be == 0
-        // So if newCapacity is 0, 1 is the value used
-        void Reserve(size_t newCapacity)
+        HashMap(const Self& other)
+            : HashMap()
         {
-            if (newCapacity == Capacity())
-                return;
-            else if (newCapacity < Capacity()) {
-                size_t count = Count();
-                if (newCapacity < count)
-                    return;
-            }
+            *this = other;
+        }
 
-            // Force Capacity to be 1
-            if (newCapacity <= 0)
-                newCapacity = 1;
-
-            List<Bucket> buckets(std::move(m_Buckets));
-            m_Buckets.Reserve(newCapacity);
-            m_Buckets.Resize(newCapacity);
-            for (size_t i = 0; i < buckets.Size(); i++) {
-                if (buckets[i].IsPopulated()) {
-                    Emplace(
-                        std::move(buckets[i].m_Key),
-                        std::move(buckets[i].m_Value));
-                }
+        HashMap(Self&& other)
+            : HashMap()
+        {
+            *this = std::move(other);
+        }
+
+        Self& operator=(const Self& other)
+        {
+            if (this == &other)
+                return *this;
+            Clear();
+            if (other.m_Count == 0)
+                return *this;
+
+            AllocateTable(other.m_Capacity);
+            PULSAR_MEMCPY(m_Control, other.m_Control, m_Capacity + HashMapGroup::WIDTH);
+            for (size_t i = 0; i < m_Capacity; i++) {
+                if (m_Control[i] != HashMapGroup::EMPTY)
+                    PULSAR_PLACEMENT_NEW(Bucket, &m_Buckets[i], other.m_Buckets[i]);
             }
+            m_Count = other.m_Count;
+            return *this;
+        }
+
+        Self& operator=(Self&& other)
+        {
+            if (this == &other)
+                return *this;
+            Clear();
+            m_Control  = other.m_Control;
+            m_Buckets  = other.m_Buckets;
+            m_Capacity = other.m_Capacity;
+            m_Count    = other.m_Count;
+            other.m_Control  = HashMapGroup::EmptyGroup;
+            other.m_Buckets  = nullptr;
+            other.m_Capacity = 0;
+            other.m_Count    = 0;
+            return *this;
+        }
+
+        // Makes room for `count` keys, so that inserting them won't rehash the map.
+        void Reserve(size_t count)
+        {
+            if (count <= MaxCount(m_Capacity))
+                return;
+            size_t newCapacity = m_Capacity > 0 ? m_Capacity : MIN_CAPACITY;
+            while (MaxCount(newCapacity) < count)
+                newCapacity *= 2;
+            Rehash(newCapacity);
         }
 
         Bucket& Insert(const K& key, const V& value) { return Emplace(key, value); }
@@ -174,255 +202,294 @@ namespace Pulsar
         Bucket& Insert(K&& key, V&& value)           { return Emplace(std::move(key), std::move(value)); }
 
         template<typename ...Args>
-        Bucket& Emplace(const K& key, Args&& ...args) { K _k = key; return Emplace(std::move(_k), std::forward<Args>(args)...); }
+        Bucket& Emplace(const K& key, Args&& ...args) { return EmplaceKey(key, std::forward<Args>(args)...); }
 
         template<typename ...Args>
-        Bucket& Emplace(K&& key, Args&& ...args)
-        {
-            size_t keyHash = HashKey(key);
-            for (size_t probeIdx = 0; probeIdx < m_Buckets.Size(); probeIdx++) {
-                size_t hash = HashProbe(keyHash, probeIdx);
-                Bucket& bucket = m_Buckets[hash];
-                if (!bucket.IsPopulated()) {
-                    bucket.Fill(
-                        std::move(key),
-                        std::forward<Args>(args)...);
-                    return bucket;
-                } else if (bucket.Key() == key) {
-                    bucket.m_Value.~V();
-                    PULSAR_PLACEMENT_NEW(V, &bucket.m_Value, std::forward<Args>(args)...);
-                    return bucket;
-                }
-            }
-
-            // No free buckets! Reserve and repeat.
-            Reserve(Capacity()*3/2+1);
-
-            return Emplace(std::move(key), std::forward<Args>(args)...);
-        }
+        Bucket& Emplace(K&& key, Args&& ...args) { return EmplaceKey(std::move(key), std::forward<Args>(args)...); }
 
-        /**
-         * Returns nullptr if key is not in this map.
-         * If the returned value is not nullptr then the method Bucket::IsPopulated() must return true.
-         * Which means that the value returned by the Value() method is valid.
-         */
+        // Returns nullptr if key is not in this map.
         Bucket* Find(const K& key)
         {
-            size_t keyHash = HashKey(key);
-            for (size_t probeIdx = 0; probeIdx < m_Buckets.Size(); probeIdx++) {
-                size_t hash = HashProbe(keyHash, probeIdx);
-                Bucket& bucket = m_Buckets[hash];
-                if (bucket.IsDeleted()) {
-                    continue;
-                } else if (!bucket.IsPopulated()) {
-                    break;
-                } else if (bucket.Key() == key) {
-                    return &bucket;
-                }
-            }
-            return nullptr;
+            size_t idx = FindIndex(key, HashKey(key));
+            return idx != NOT_FOUND ? &m_Buckets[idx] : nullptr;
         }
 
         const Bucket* Find(const K& key) const
         {
-            size_t keyHash = HashKey(key);
-            for (size_t probeIdx = 0; probeIdx < m_Buckets.Size(); probeIdx++) {
-                size_t hash = HashProbe(keyHash, probeIdx);
-                const Bucket& bucket = m_Buckets[hash];
-                if (bucket.IsDeleted()) {
-                    continue;
-                } else if (!bucket.IsPopulated()) {
-                    break;
-                } else if (bucket.Key() == key) {
-                    return &bucket;
-                }
-            }
-            return nullptr;
+            size_t idx = FindIndex(key, HashKey(key));
+            return idx != NOT_FOUND ? &m_Buckets[idx] : nullptr;
         }
 
         bool Remove(const K& key)
         {
-            Bucket* bucket = Find(key);
-            if (bucket) {
-                PULSAR_ASSERT(bucket->IsPopulated(), "HashMap::Find returned a non-populated bucket.");
-                bucket->Delete();
-                return true;
+            size_t idx = FindIndex(key, HashKey(key));
+            if (idx == NOT_FOUND)
+                return false;
+            m_Buckets[idx].~Bucket();
+
+            // Moves back the following keys of the probe sequence which may be placed in the emptied bucket,
+            //  so that lookups can stop at the first empty bucket.
+            size_t hole = idx;
+            for (size_t next = (idx+1) & Mask(); m_Control[next] != HashMapGroup::EMPTY; next = (next+1) & Mask()) {
+                size_t home = HashKey(m_Buckets[next].m_Key) & Mask();
+                if (((next-home) & Mask()) < ((next-hole) & Mask()))
+                    continue;
+                SetControl(hole, m_Control[next]);
+                PULSAR_PLACEMENT_NEW(Bucket, &m_Buckets[hole], std::move(m_Buckets[next]));
+                m_Buckets[next].~Bucket();
+                hole = next;
             }
-            return false;
+
+            SetControl(hole, HashMapGroup::EMPTY);
+            m_Count--;
+            return true;
         }
 
         void ReHash()
         {
-            List<Bucket> buckets(std::move(m_Buckets));
-            m_Buckets.Reserve(buckets.Size());
-            m_Buckets.Resize(buckets.Size());
-            for (size_t i = 0; i < buckets.Size(); i++) {
-                if (buckets[i].IsPopulated()) {
-                    Emplace(
-                        std::move(buckets[i].m_Key),
-                        std::move(buckets[i].m_Value));
-                }
-            }
+            if (m_Capacity > 0)
+                Rehash(m_Capacity);
         }
 
         void ForEach(std::function<void(const Bucket&)> fn) const
         {
-            for (size_t i = 0; i < m_Buckets.Size(); i++) {
-                if (m_Buckets[i].IsPopulated())
+            for (size_t i = 0; i < m_Capacity; i++) {
+                if (m_Control[i] != HashMapGroup::EMPTY)
                     fn(m_Buckets[i]);
             }
         }
 
         void ForEach(std::function<void(Bucket&)> fn)
         {
-            for (size_t i = 0; i < m_Buckets.Size(); i++) {
-                if (m_Buckets[i].IsPopulated())
+            for (size_t i = 0; i < m_Capacity; i++) {
+                if (m_Control[i] != HashMapGroup::EMPTY)
                     fn(m_Buckets[i]);
             }
         }
 
         void Clear()
         {
-            m_Buckets.Clear();
-            m_Buckets.Resize(1);
-        }
-
-        size_t Count() const
-        {
-            size_t count = 0;
-            for (size_t i = 0; i < m_Buckets.Size(); i++) {
-                if (m_Buckets[i].IsPopulated())
-                    count++;
+            for (size_t i = 0; i < m_Capacity; i++) {
+                if (m_Control[i] != HashMapGroup::EMPTY)
+                    m_Buckets[i].~Bucket();
             }
-            return count;
+            FreeTable(m_Control, m_Capacity);
+            m_Control  = HashMapGroup::EmptyGroup;
+            m_Buckets  = nullptr;
+            m_Capacity = 0;
+            m_Count    = 0;
         }
 
-        size_t Capacity() const { return m_Buckets.Size(); }
-
-        /** Computes the full hash from a specific key and probe index. */
-        size_t Hash(const K& key, size_t probeIdx) const {
-            return HashProbe(HashKey(key), probeIdx);
-        }
+        size_t Count() const    { return m_Count; }
+        size_t Capacity() const { return m_Capacity; }
 
         /** Computes the hash for a specific key. */
-        size_t HashKey(const K& key) const {
-            size_t keyHash = std::hash<K>{}(key);
-            return keyHash % Capacity();
-        }
-
-        /** Computes the hash for a specific probe of a key hash. */
-        size_t HashProbe(size_t keyHash, size_t probeIdx) const {
-            // TODO: Use a better probing method.
-            // See: https://en.wikipedia.org/wiki/Open_addressing
-            return (keyHash + probeIdx) % Capacity();
-        }
-
-        ConstIterator Begin() const
+        size_t HashKey(const K& key) const
         {
-            auto it = m_Buckets.Begin();
-            for (; it != m_Buckets.End() && !(*it).IsPopulated(); ++it);
-            return ConstIterator(it, m_Buckets.End());
+            return (size_t)Hash::Mix(std::hash<K>{}(key));
         }
 
-        ConstIterator End() const { return ConstIterator(m_Buckets.End(), m_Buckets.End()); }
+        ConstIterator Begin() const { return ConstIterator(m_Control, m_Buckets, m_Buckets+m_Capacity); }
+        ConstIterator End() const   { return ConstIterator(m_Control+m_Capacity, m_Buckets+m_Capacity, m_Buckets+m_Capacity); }
 
-        MutableIterator Begin()
-        {
-            auto it = m_Buckets.Begin();
-            for (; it != m_Buckets.End() && !(*it).IsPopulated(); ++it);
-            return MutableIterator(it, m_Buckets.End());
-        }
-
-        MutableIterator End() { return MutableIterator(m_Buckets.End(), m_Buckets.End()); }
+        MutableIterator Begin() { return MutableIterator(m_Control, m_Buckets, m_Buckets+m_Capacity); }
+        MutableIterator End()   { return MutableIterator(m_Control+m_Capacity, m_Buckets+m_Capacity, m_Buckets+m_Capacity); }
 
         PULSAR_ITERABLE_IMPL(Self, ConstIterator, MutableIterator)
 
     public:
-        class ConstIterator
+        template<typename TBucket, typename TPair>
+        class BaseIterator
         {
         public:
-            using BucketIterator = List<Bucket>::ConstIterator;
-            struct Pair
+            BaseIterator(const int8_t* control, TBucket* bucket, TBucket* end)
+                : m_Control(control), m_Bucket(bucket), m_End(end)
             {
-                const K& Key;
-                const V& Value;
-            };
+                SkipEmpty();
+            }
 
-            explicit ConstIterator(BucketIterator begin, BucketIterator end)
-                : m_Begin(begin), m_End(end) {}
+            bool operator==(const BaseIterator& other) const { return m_Bucket == other.m_Bucket; }
+            bool operator!=(const BaseIterator& other) const { return m_Bucket != other.m_Bucket; }
 
-            bool operator==(const ConstIterator& other) const = default;
-            bool operator!=(const ConstIterator& other) const = default;
-            Pair operator*() const
+            TPair operator*() const
             {
-                PULSAR_ASSERT(m_Begin && m_Begin->IsPopulated(), "Called *HashMap<K, V>::ConstIterator on invalid data.");
-                return { m_Begin->Key(), m_Begin->Value() };
+                PULSAR_ASSERT(m_Bucket != m_End, "Called *HashMap<K, V>::Iterator on invalid data.");
+                return { m_Bucket->Key(), m_Bucket->Value() };
             }
 
-            ConstIterator& operator++()
+            BaseIterator& operator++()
             {
-                PULSAR_ASSERT(m_Begin != m_End, "Called ++HashMap<K, V>::ConstIterator on complete iterator.");
-                for (++m_Begin; m_Begin != m_End && !m_Begin->IsPopulated(); ++m_Begin);
+                PULSAR_ASSERT(m_Bucket != m_End, "Called ++HashMap<K, V>::Iterator on complete iterator.");
+                ++m_Control;
+                ++m_Bucket;
+                SkipEmpty();
                 return *this;
             }
 
-            ConstIterator operator++(int)
+        private:
+            void SkipEmpty()
             {
-                ConstIterator ret = *this;
-                ++(*this);
-                return ret;
+                for (; m_Bucket != m_End && *m_Control == HashMapGroup::EMPTY; ++m_Control, ++m_Bucket);
             }
+
         private:
-            BucketIterator m_Begin;
-            BucketIterator m_End;
+            const int8_t* m_Control;
+            TBucket* m_Bucket;
+            TBucket* m_End;
+        };
+
+        struct ConstPair
+        {
+            const K& Key;
+            const V& Value;
         };
 
-        class MutableIterator
+        struct MutablePair
+        {
+            const K& Key;
+            V& Value;
+        };
+
+        class ConstIterator : public BaseIterator<const Bucket, ConstPair>
         {
         public:
-            using BucketIterator = List<Bucket>::MutableIterator;
-            struct Pair
-            {
-                const K& Key;
-                V& Value;
-            };
+            using Pair = ConstPair;
+            using BaseIterator<const Bucket, ConstPair>::BaseIterator;
+        };
+
+        class MutableIterator : public BaseIterator<Bucket, MutablePair>
+        {
+        public:
+            using Pair = MutablePair;
+            using BaseIterator<Bucket, MutablePair>::BaseIterator;
+        };
+
+    private:
+        static constexpr size_t NOT_FOUND = (size_t)-1;
 
-            explicit MutableIterator(BucketIterator begin, BucketIterator end)
-                : m_Begin(begin), m_End(end) {}
+        // Keeps at least 1/8 of the buckets empty, so that probing always finds an empty one.
+        static size_t MaxCount(size_t capacity) { return capacity - capacity/8; }
+        static int8_t Tag(size_t hash) { return (int8_t)(hash >> (sizeof(size_t)*8-7)); }
 
-            bool operator==(const MutableIterator& other) const = default;
-            bool operator!=(const MutableIterator& other) const = default;
-            Pair operator*()
-            {
-                PULSAR_ASSERT(m_Begin && m_Begin->IsPopulated(), "Called *HashMap<K, V>::MutableIterator on invalid data.");
-                return { m_Begin->Key(), m_Begin->Value() };
+        size_t Mask() const { return m_Capacity > 0 ? m_Capacity-1 : 0; }
+
+        size_t FindIndex(const K& key, size_t hash) const
+        {
+            int8_t tag = Tag(hash);
+            size_t pos = hash & Mask();
+            for (;;) {
+                HashMapGroup group(m_Control+pos);
+                for (uint32_t match = group.Match(tag); match; match &= match-1) {
+                    size_t idx = (pos + (size_t)std::countr_zero(match)) & Mask();
+                    if (m_Buckets[idx].m_Key == key)
+                        return idx;
+                }
+                if (group.MatchEmpty())
+                    return NOT_FOUND;
+                pos = (pos + HashMapGroup::WIDTH) & Mask();
             }
-            ConstIterator::Pair operator*() const
-            {
-                PULSAR_ASSERT(m_Begin && m_Begin->IsPopulated(), "Called *HashMap<K, V>::MutableIterator on invalid data.");
-                return { m_Begin->Key(), m_Begin->Value() };
+        }
+
+        // Returns the first empty bucket of the probe sequence of `hash`.
+        size_t FindEmpty(size_t hash) const
+        {
+            size_t pos = hash & Mask();
+            for (;;) {
+                uint32_t empty = HashMapGroup(m_Control+pos).MatchEmpty();
+                if (empty)
+                    return (pos + (size_t)std::countr_zero(empty)) & Mask();
+                pos = (pos + HashMapGroup::WIDTH) & Mask();
             }
+        }
 
-            MutableIterator& operator++()
-            {
-                PULSAR_ASSERT(m_Begin != m_End, "Called ++HashMap<K, V>::MutableIterator on complete iterator.");
-                for (++m_Begin; m_Begin != m_End && !m_Begin->IsPopulated(); ++m_Begin);
-                return *this;
+        template<typename KArg, typename ...Args>
+        Bucket& EmplaceKey(KArg&& key, Args&& ...args)
+        {
+            size_t hash = HashKey(key);
+            size_t idx = FindIndex(key, hash);
+            if (idx != NOT_FOUND) {
+                // `args` may refer to the old value (e.g. `map.Emplace(k, map[k])`), so it's replaced after the new one is built.
+                Bucket& bucket = m_Buckets[idx];
+                bucket.m_Value = Bucket::MakeValue(std::forward<Args>(args)...);
+                return bucket;
             }
 
-            MutableIterator operator++(int)
-            {
-                MutableIterator ret = *this;
-                ++(*this);
-                return ret;
+            if (m_Count >= MaxCount(m_Capacity)) {
+                // Same goes for values which are moved by Rehash.
+                V value = Bucket::MakeValue(std::forward<Args>(args)...);
+                Rehash(m_Capacity > 0 ? m_Capacity*2 : MIN_CAPACITY);
+                return EmplaceNew(hash, std::forward<KArg>(key), std::move(value));
             }
-        private:
-            BucketIterator m_Begin;
-            BucketIterator m_End;
-        };
+            return EmplaceNew(hash, std::forward<KArg>(key), std::forward<Args>(args)...);
+        }
+
+        // `key` must not be within the map, which must have room for it.
+        template<typename KArg, typename ...Args>
+        Bucket& EmplaceNew(size_t hash, KArg&& key, Args&& ...args)
+        {
+            size_t idx = FindEmpty(hash);
+            SetControl(idx, Tag(hash));
+            PULSAR_PLACEMENT_NEW(Bucket, &m_Buckets[idx], std::piecewise_construct,
+                std::forward<KArg>(key), std::forward<Args>(args)...);
+            m_Count++;
+            return m_Buckets[idx];
+        }
+
+        void SetControl(size_t idx, int8_t control)
+        {
+            m_Control[idx] = control;
+            // The first WIDTH control bytes are repeated after the last one, so that groups can be loaded past it.
+            for (size_t i = idx; i < HashMapGroup::WIDTH; i += m_Capacity)
+                m_Control[m_Capacity+i] = control;
+        }
+
+        // Buckets are stored right after the control bytes.
+        static size_t ControlSize(size_t capacity)
+        {
+            return (capacity + HashMapGroup::WIDTH + alignof(Bucket)-1) / alignof(Bucket) * alignof(Bucket);
+        }
+
+        // Replaces the table with an empty one of `capacity` buckets, the old one must be freed by the caller.
+        void AllocateTable(size_t capacity)
+        {
+            uint8_t* table = (uint8_t*)PULSAR_MALLOC(ControlSize(capacity) + capacity*sizeof(Bucket));
+            m_Control  = (int8_t*)table;
+            m_Buckets  = (Bucket*)(table + ControlSize(capacity));
+            m_Capacity = capacity;
+            PULSAR_MEMSET(m_Control, HashMapGroup::EMPTY, capacity + HashMapGroup::WIDTH);
+        }
+
+        static void FreeTable(int8_t* control, size_t capacity)
+        {
+            if (capacity > 0)
+                PULSAR_FREE((void*)control);
+        }
+
+        void Rehash(size_t newCapacity)
+        {
+            int8_t* oldControl = m_Control;
+            Bucket* oldBuckets = m_Buckets;
+            size_t oldCapacity = m_Capacity;
+
+            AllocateTable(newCapacity);
+            for (size_t i = 0; i < oldCapacity; i++) {
+                if (oldControl[i] == HashMapGroup::EMPTY)
+                    continue;
+                Bucket& bucket = oldBuckets[i];
+                size_t hash = HashKey(bucket.m_Key);
+                size_t idx = FindEmpty(hash);
+                SetControl(idx, Tag(hash));
+                PULSAR_PLACEMENT_NEW(Bucket, &m_Buckets[idx], std::move(bucket));
+                bucket.~Bucket();
+            }
+            FreeTable(oldControl, oldCapacity);
+        }
 
     private:
-        List<Bucket> m_Buckets;
+        int8_t* m_Control = HashMapGroup::EmptyGroup;
+        Bucket* m_Buckets = nullptr;
+        size_t m_Capacity = 0;
+        size_t m_Count    = 0;
     };
 }
 
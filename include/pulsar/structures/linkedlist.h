@@ -20,7 +20,8 @@ namespace Pulsar
         template<typename ...Args>
         LinkedListNode(Args&& ...init)
             : m_Value(init...) { }
-        ~LinkedListNode() { PULSAR_DELETE(Self, m_Next); }
+        // Only destroys this node, LinkedList frees whole chains.
+        ~LinkedListNode() = default;
 
         // Delete Copy & Move Constructors/Assignments
         LinkedListNode(const Self&) = delete;
@@ -70,7 +71,7 @@ namespace Pulsar
         class MutableIterator;
 
         LinkedList() = default;
-        ~LinkedList() { PULSAR_DELETE(Node, m_Start); }
+        ~LinkedList() { DeleteChain(m_Start); }
 
         explicit LinkedList(const List<T>& list)
             : LinkedList()
@@ -88,10 +89,9 @@ namespace Pulsar
         LinkedList(const Self& other) { *this = other; }
         Self& operator=(const Self& other)
         {
-            if (m_Start)
-                PULSAR_DELETE(Node, m_Start);
-            m_Start = nullptr;
-            m_End = nullptr;
+            if (this == &other)
+                return *this;
+            Clear();
             Node* next = other.m_Start;
             while (next) {
                 Append()->m_Value = next->m_Value;
@@ -103,8 +103,9 @@ namespace Pulsar
         LinkedList(Self&& other) { *this = std::move(other); }
         Self& operator=(Self&& other)
         {
-            if (m_Start)
-                PULSAR_DELETE(Node, m_Start);
+            if (this == &other)
+                return *this;
+            DeleteChain(m_Start);
             m_Start = other.m_Start;
             m_End = other.m_End;
             other.m_Start = nullptr;
@@ -177,9 +178,7 @@ namespace Pulsar
                 newStart = newStart->m_Next;
 
             if (!newStart) {
-                PULSAR_DELETE(Node, m_Start);
-                m_Start = nullptr;
-                m_End = nullptr;
+                Clear();
                 return *this;
             }
 
@@ -189,7 +188,7 @@ namespace Pulsar
             newStart->m_Prev = nullptr;
 
             // Delete previous nodes
-            PULSAR_DELETE(Node, m_Start);
+            DeleteChain(m_Start);
             m_Start = newStart;
 
             return *this;
@@ -205,9 +204,7 @@ namespace Pulsar
                 newEnd = newEnd->m_Prev;
 
             if (!newEnd) {
-                PULSAR_DELETE(Node, m_Start);
-                m_Start = nullptr;
-                m_End = nullptr;
+                Clear();
                 return *this;
             }
 
@@ -218,7 +215,7 @@ namespace Pulsar
             newEnd->m_Next = nullptr;
 
             // Delete previous nodes
-            PULSAR_DELETE(Node, chainToDelete);
+            DeleteChain(chainToDelete);
             m_End = newEnd;
 
             return *this;
@@ -229,7 +226,7 @@ namespace Pulsar
         Node* Back()              { return m_End; }
         const Node* Back() const  { return m_End; }
 
-        void Clear()          { PULSAR_DELETE(Node, m_Start); m_Start = nullptr; m_End = nullptr; }
+        void Clear()          { DeleteChain(m_Start); m_Start = nullptr; m_End = nullptr; }
         size_t Length() const { return m_Start ? m_Start->Length() : 0; }
 
         ConstIterator Begin() const { return ConstIterator(m_Start); }
@@ -295,6 +292,17 @@ namespace Pulsar
             Node* m_Node;
         };
 
+    private:
+        // Deletes `node` and all the ones which follow it without recursion.
+        static void DeleteChain(Node* node)
+        {
+            while (node) {
+                Node* next = node->m_Next;
+                PULSAR_DELETE(Node, node);
+                node = next;
+            }
+        }
+
     private:
         Node* m_Start = nullptr;
         Node* m_End = nullptr;
@@ -68,9 +68,13 @@ namespace Pulsar
         }
 
         List(Self&& other)
-            : List()
+            : m_Data(other.m_Data)
+            , m_Size(other.m_Size)
+            , m_Capacity(other.m_Capacity)
         {
-            *this = std::move(other);
+            other.m_Data = nullptr;
+            other.m_Size = 0;
+            other.m_Capacity = 0;
         }
 
         Self& operator=(const Self& other)
@@ -85,17 +89,21 @@ namespace Pulsar
             return *this;
         }
 
+        // Takes ownership of the buffer of `other`, which is left empty.
         Self& operator=(Self&& other)
         {
-            size_t oldSize = m_Size;
-            ResizeUninitialized(other.Size());
-            for (size_t i = 0; i < other.Size(); i++) {
-                if (i < oldSize)
-                    m_Data[i].~T();
-                PULSAR_PLACEMENT_NEW(T, &m_Data[i], std::move(other.m_Data[i]));
-                other.m_Data[i].~T();
+            if (this == &other)
+                return *this;
+            if (m_Data) {
+                Clear();
+                PULSAR_FREE((void*)m_Data);
             }
-            other.m_Size = 0;
+            m_Data     = other.m_Data;
+            m_Size     = other.m_Size;
+            m_Capacity = other.m_Capacity;
+            other.m_Data     = nullptr;
+            other.m_Size     = 0;
+            other.m_Capacity = 0;
             return *this;
         }
 
@@ -5,9 +5,81 @@
 
 namespace Pulsar
 {
+    /**
+     * RefCounts are atomic unless they're created with the LOCAL flag set (e.g. RefCount{1 | RefCount::LOCAL}).
+     * Local RefCounts are updated without atomic read-modify-write operations, so they must only be
+     *  accessed by one thread at a time until they're promoted through ::PromoteToAtomic().
+     * Frozen RefCounts are atomic and mark values which are deeply immutable (see Pulsar::Value::Freeze()).
+     */
     struct RefCount
     {
+        // Stored within the count.
+        static constexpr size_t LOCAL  = (size_t)1 << (sizeof(size_t)*8-1);
+        static constexpr size_t FROZEN = (size_t)1 << (sizeof(size_t)*8-2);
+        static constexpr size_t FLAGS  = LOCAL | FROZEN;
+
         PULSAR_ATOMIC_SIZE_T SharedRefs = 0;
+
+#ifdef PULSAR_NO_ATOMIC
+        size_t Count() const    { return SharedRefs & ~FLAGS; }
+        bool IsLocal() const    { return SharedRefs & LOCAL; }
+        bool IsFrozen() const   { return SharedRefs & FROZEN; }
+        void Increment()        { SharedRefs++; }
+        // Returns the count before decrementing it.
+        size_t Decrement()      { return SharedRefs-- & ~FLAGS; }
+        void PromoteToAtomic()  { SharedRefs &= ~LOCAL; }
+        void Freeze()           { SharedRefs = (SharedRefs & ~LOCAL) | FROZEN; }
+        void MakeLocal()        { SharedRefs = (SharedRefs & ~FROZEN) | LOCAL; }
+#else // PULSAR_NO_ATOMIC
+        size_t Count() const    { return SharedRefs.load(std::memory_order_acquire) & ~FLAGS; }
+        bool IsLocal() const    { return SharedRefs.load(std::memory_order_acquire) & LOCAL; }
+        bool IsFrozen() const   { return SharedRefs.load(std::memory_order_acquire) & FROZEN; }
+
+        void Increment()
+        {
+            size_t count = SharedRefs.load(std::memory_order_relaxed);
+            if (count & LOCAL)
+                SharedRefs.store(count+1, std::memory_order_relaxed);
+            else SharedRefs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Returns the count before decrementing it.
+        size_t Decrement()
+        {
+            size_t count = SharedRefs.load(std::memory_order_relaxed);
+            if (count & LOCAL) {
+                SharedRefs.store(count-1, std::memory_order_relaxed);
+                return count & ~FLAGS;
+            }
+            return SharedRefs.fetch_sub(1, std::memory_order_acq_rel) & ~FLAGS;
+        }
+
+        // May be called by multiple threads at once, as long as none of them updates the count as local.
+        // Writes made before promoting the count are visible to threads which see it as atomic through ::IsLocal().
+        void PromoteToAtomic()
+        {
+            size_t count = SharedRefs.load(std::memory_order_relaxed);
+            while ((count & LOCAL) && !SharedRefs.compare_exchange_weak(count, count & ~LOCAL,
+                std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        // Promotes the count and marks it as frozen, the same rules as ::PromoteToAtomic() apply.
+        void Freeze()
+        {
+            size_t count = SharedRefs.load(std::memory_order_relaxed);
+            while (!(count & FROZEN) && !SharedRefs.compare_exchange_weak(count, (count & ~LOCAL) | FROZEN,
+                std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        // Must only be called by the thread which holds the only reference (i.e. Count() == 1).
+        // Since nobody else can see the value, it's no longer frozen.
+        void MakeLocal()
+        {
+            size_t count = SharedRefs.load(std::memory_order_relaxed);
+            if ((count & FLAGS) != LOCAL)
+                SharedRefs.store((count & ~FROZEN) | LOCAL, std::memory_order_relaxed);
+        }
+#endif // PULSAR_NO_ATOMIC
     };
 
     template <typename T>
@@ -71,6 +143,9 @@ namespace Pulsar
 
         SharedRef<T>& operator=(SharedRef<T>&& o)
         {
+            if (this == &o)
+                return *this;
+            this->DecrementRefCount();
             m_Value = o.m_Value;
             m_RefCount = o.m_RefCount;
             o.m_Value = nullptr;
@@ -111,7 +186,7 @@ namespace Pulsar
         T* Get() const { return m_Value; }
         size_t SharedCount() const
         {
-            return m_RefCount ? (size_t)m_RefCount->SharedRefs : 1;
+            return m_RefCount ? m_RefCount->Count() : 1;
         }
 
     private:
@@ -124,12 +199,12 @@ namespace Pulsar
         void IncrementRefCount() const
         {
             if (m_RefCount)
-                m_RefCount->SharedRefs++;
+                m_RefCount->Increment();
         }
 
         void DecrementRefCount()
         {
-            if (m_RefCount && m_RefCount->SharedRefs-- <= 1) {
+            if (m_RefCount && m_RefCount->Decrement() <= 1) {
                 (*m_RefCount).~RefCount();
                 (*m_Value).~T();
                 PULSAR_FREE(m_RefCount);
@@ -3,14 +3,23 @@
 
 #include "pulsar/core.h"
 
+#include "pulsar/structures/hash.h"
+
 namespace Pulsar
 {
+    /**
+     * Strings of up to SMALL_CAPACITY chars are stored within the object itself,
+     *  longer ones are stored on the heap.
+     * Data() always points to a null-terminated buffer, even if the String is empty.
+     */
     class String
     {
     public:
         using ConstIterator   = const char*;
         using MutableIterator = char*;
 
+        static constexpr size_t SMALL_CAPACITY = 23;
+
         String();
         ~String();
 
@@ -26,13 +35,13 @@ namespace Pulsar
 
         char operator[](size_t idx) const
         {
-            PULSAR_ASSERT(idx < Length(), "String index out of bounds.");
+            PULSAR_ASSERT(idx < m_Length, "String index out of bounds.");
             return m_Data[idx];
         }
 
         char& operator[](size_t idx)
         {
-            PULSAR_ASSERT(idx < Length(), "String index out of bounds.");
+            PULSAR_ASSERT(idx < m_Length, "String index out of bounds.");
             return m_Data[idx];
         }
 
@@ -56,10 +65,10 @@ namespace Pulsar
         char* Data()             { return m_Data; }
         const char* Data() const { return m_Data; }
 
-        const char* CString() const { return m_Data ? m_Data : ""; }
+        const char* CString() const { return m_Data; }
 
-        size_t Length() const { return m_Length; }
-        size_t Capacity() const { return m_Capacity; }
+        size_t Length() const   { return m_Length; }
+        size_t Capacity() const { return IsSmall() ? SMALL_CAPACITY : m_Capacity; }
 
         ConstIterator Begin() const { return m_Data; }
         ConstIterator End()   const { return m_Data+m_Length; }
@@ -69,9 +78,17 @@ namespace Pulsar
         PULSAR_ITERABLE_IMPL(String, ConstIterator, MutableIterator)
 
     private:
+        bool IsSmall() const { return m_Data == m_Small; }
+
+    private:
+        // Points to m_Small or to a buffer on the heap.
         char* m_Data;
         size_t m_Length;
-        size_t m_Capacity;
+        union
+        {
+            size_t m_Capacity;
+            char m_Small[SMALL_CAPACITY+1];
+        };
     };
 
     String UIntToString(uint64_t n);
@@ -84,10 +101,7 @@ struct std::hash<Pulsar::String>
 {
     size_t operator()(const Pulsar::String& str) const
     {
-        size_t hash = 0;
-        for (size_t i = 0; i < str.Length(); i++)
-            hash += std::hash<char>{}(str[i]);
-        return hash;
+        return (size_t)Pulsar::Hash::Bytes(str.Data(), str.Length());
     }
 };
 
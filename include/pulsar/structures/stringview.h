@@ -3,6 +3,7 @@
 
 #include "pulsar/core.h"
 
+#include "pulsar/structures/hash.h"
 #include "pulsar/structures/string.h"
 
 namespace Pulsar
@@ -95,10 +96,7 @@ struct std::hash<Pulsar::StringView>
 {
     size_t operator()(const Pulsar::StringView& strView) const
     {
-        size_t hash = 0;
-        for (size_t i = 0; i < strView.Length(); i++)
-            hash += std::hash<char>{}(strView[i]);
-        return hash;
+        return (size_t)Pulsar::Hash::Bytes(strView.Data(), strView.Length());
     }
 };
 
@@ -0,0 +1,91 @@
+#ifndef _PULSAR_STRUCTURES_VERSIONEDLIST_H
+#define _PULSAR_STRUCTURES_VERSIONEDLIST_H
+
+#include "pulsar/core.h"
+
+#include "pulsar/structures/list.h"
+
+namespace Pulsar
+{
+    /**
+     * A List which counts its modifications, so that data derived from its items can tell when it's stale.
+     * Any access through a non-const method counts as a modification.
+     * Appending items is told apart from other modifications, so that derived data may be extended instead of rebuilt.
+     */
+    template<typename T>
+    class VersionedList
+    {
+    public:
+        using Self = VersionedList<T>;
+        using ConstIterator   = typename List<T>::ConstIterator;
+        using MutableIterator = typename List<T>::MutableIterator;
+
+        VersionedList() = default;
+        VersionedList(std::initializer_list<T> init)
+            : m_List(init) {}
+
+        // Returns the underlying List, which is assumed to be modified.
+        List<T>& Edit()             { Touch(); return m_List; }
+        const List<T>& Get() const  { return m_List; }
+        operator const List<T>&() const { return m_List; }
+
+        template<typename ...Args>
+        void Resize(size_t newSize, Args ...args)
+        {
+            if (newSize < m_List.Size()) Touch();
+            else Append();
+            m_List.Resize(newSize, args...);
+        }
+
+        void Reserve(size_t newCapacity) { m_List.Reserve(newCapacity); }
+
+        void PushBack(const T& value) { Append(); m_List.PushBack(value); }
+        void PushBack(T&& value)      { Append(); m_List.PushBack(std::move(value)); }
+
+        // The returned reference may be used to fill in the new item until derived data is updated.
+        template<typename ...Args>
+        T& EmplaceBack(Args&& ...args)
+        {
+            Append();
+            return m_List.EmplaceBack(std::forward<Args>(args)...);
+        }
+
+        void PopBack() { Touch(); m_List.PopBack(); }
+        void Clear()   { Touch(); m_List.Clear(); }
+
+        T& operator[](size_t index)             { Touch(); return m_List[index]; }
+        const T& operator[](size_t index) const { return m_List[index]; }
+
+        T& Back()             { Touch(); return m_List.Back(); }
+        const T& Back() const { return m_List.Back(); }
+
+        T* Data()               { Touch(); return m_List.Data(); }
+        const T* Data() const   { return m_List.Data(); }
+        size_t Size() const     { return m_List.Size(); }
+        size_t Capacity() const { return m_List.Capacity(); }
+        bool IsEmpty() const    { return m_List.IsEmpty(); }
+
+        ConstIterator Begin() const { return m_List.Begin(); }
+        ConstIterator End()   const { return m_List.End(); }
+        MutableIterator Begin() { Touch(); return m_List.Begin(); }
+        MutableIterator End()   { Touch(); return m_List.End(); }
+
+        PULSAR_ITERABLE_IMPL(Self, ConstIterator, MutableIterator)
+
+        // Changed by any modification.
+        uint64_t Version() const     { return m_Version; }
+        // The value of ::Version() after the last modification which was not an append.
+        uint64_t EditVersion() const { return m_EditVersion; }
+
+    private:
+        void Append() { ++m_Version; }
+        void Touch()  { m_EditVersion = ++m_Version; }
+
+    private:
+        List<T> m_List;
+        uint64_t m_Version = 0;
+        uint64_t m_EditVersion = 0;
+    };
+}
+
+#endif // _PULSAR_STRUCTURES_VERSIONEDLIST_H
@@ -0,0 +1,101 @@
+#ifndef _PULSAR_VERIFIER_H
+#define _PULSAR_VERIFIER_H
+
+#include "pulsar/core.h"
+
+#include "pulsar/runtime.h"
+#include "pulsar/structures/list.h"
+
+namespace Pulsar
+{
+    /**
+     * The Verifier statically checks the code of functions within a Module.
+     * A function is verified if it's proven that, for every reachable instruction:
+     * - Local, global, constant, function and native indices are within bounds;
+     * - Globals written to are not constant;
+     * - Jumps land within the function (jumping to its end is a return);
+     * - The stack holds enough values for the instruction to be executed.
+     *   `icall` is checked at runtime, after it the stack depth is considered unknown.
+     *
+     * Verified functions are run by the ExecutionContext with the above checks compiled out.
+     * Dynamic checks (types, list/string bounds, unbound natives, ...) are still performed.
+     * Therefore, any change to a verified function or to the definitions it references
+     *  (except for appending new ones) requires the Module to be verified again.
+     *
+     * The Verifier also computes FunctionDefinition::MaxStackSize with the same stack-effect analysis,
+     *  which is used by the CallStack to allocate the Stack of a Frame only once.
+     */
+    class Verifier
+    {
+    public:
+        // Max size returned by ComputeMaxStackSize, bigger values should not be trusted when read.
+        static constexpr size_t MAX_COMPUTED_STACK_SIZE = 1 << 12;
+        static constexpr size_t UNKNOWN_DEPTH = size_t(-1);
+
+    public:
+        Verifier() = default;
+        ~Verifier() = default;
+
+        // Verifies all functions in `module` and updates their FunctionDefinition::Verified flag.
+        // FunctionDefinition::MaxStackSize is computed for the functions which don't have one.
+        // Returns true if all functions were verified.
+        bool Verify(Module& module);
+
+        // Returns true if `function` can be run in `module` without static checks.
+        // Does not change the FunctionDefinition::Verified flag.
+        bool VerifyFunction(const Module& module, const FunctionDefinition& function);
+
+        // Returns the max size the stack can reach while running `function`.
+        // `icall` is assumed to push at most the max amount of values any function can add.
+        // Returns 0 if unknown (e.g. the stack grows within a loop or is bigger than MAX_COMPUTED_STACK_SIZE).
+        size_t ComputeMaxStackSize(const Module& module, const FunctionDefinition& function);
+
+        // Stores into `outDepths` the stack depth before each instruction of `function`,
+        //  the last entry refers to the end of the function.
+        // A depth is UNKNOWN_DEPTH if the instruction is unreachable, can be reached with different depths
+        //  or is only reachable after an `icall`.
+        // Returns false if `function` could not be verified.
+        bool ComputeStackDepths(const Module& module, const FunctionDefinition& function, List<size_t>& outDepths);
+
+    private:
+        struct StackEffect
+        {
+            size_t Pops   = 0;
+            size_t Pushes = 0;
+            // False if the next instruction can't be reached from this one.
+            bool Continues = true;
+            // True if the instruction may jump to its index + Arg0.
+            bool Jumps = false;
+            // True if the stack depth after this instruction depends on runtime values (i.e. icall).
+            bool IsDynamic = false;
+        };
+
+        // Returns false if `instr` is unknown or any of its operands is out of bounds.
+        static bool GetStackEffect(const Module& module, const FunctionDefinition& function, const Instruction& instr, StackEffect& out);
+        // Returns the max amount of values any function in `module` adds to the stack of its caller.
+        static size_t GetMaxCallGrowth(const Module& module);
+
+
+        static constexpr size_t UNVISITED = size_t(-1);
+        // Stack depths are clamped to this value, lowering a depth is always safe.
+        static constexpr size_t MAX_TRACKED_DEPTH = 1 << 16;
+
+        // Lowers the min stack depth of `instructionIdx` to `depth` and schedules it for a visit.
+        void Visit(size_t instructionIdx, size_t depth);
+        // Raises the max stack depth of `instructionIdx` to `depth` and schedules it for a visit.
+        void VisitMax(size_t instructionIdx, size_t depth);
+        // Sets the stack depth of `instructionIdx` to `depth` and schedules it for a visit.
+        // If it was already set to a different value, it's marked as conflicting.
+        void VisitExact(List<size_t>& depths, size_t instructionIdx, size_t depth);
+
+    private:
+        // m_MinStackDepth[i] is the min stack depth before executing the i-th instruction.
+        // The last entry refers to the end of the function.
+        List<size_t> m_MinStackDepth;
+        // m_MaxStackDepth[i] is the max stack depth before executing the i-th instruction.
+        List<size_t> m_MaxStackDepth;
+        List<size_t> m_ToVisit;
+    };
+}
+
+#endif // _PULSAR_VERIFIER_H
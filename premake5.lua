@@ -27,7 +27,9 @@ workspace "pulsar"
 include "projects/pulsar"
 include "projects/pulsar-bindings"
 include "projects/pulsar-demo"
+include "projects/pulsar-jit"
 include "projects/pulsar-lsp"
+include "projects/pulsar-tests"
 include "projects/pulsar-tools"
 
 include "projects/cpulsar"
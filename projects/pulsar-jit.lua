@@ -0,0 +1,21 @@
+require("premake", ">=5.0.0-beta4")
+
+local buildpath = require "common/buildpath"
+local cflags    = require "common/cflags"
+
+include "pulsar"
+
+-- Optional baseline JIT compiler, see PulsarJit::Compiler.
+-- It can be built on any platform, though it only compiles code on x86-64.
+project "pulsar-jit"
+  kind "StaticLib"
+  language "C++"
+  cppdialect "C++20"
+
+  buildpath.setup("pulsar-jit")
+
+  includedirs "../include"
+  files { "../src/pulsar-jit/**.cpp", "../include/pulsar-jit/**.h" }
+  links "pulsar"
+
+  cflags()
@@ -0,0 +1,20 @@
+require("premake", ">=5.0.0-beta4")
+
+local buildpath = require "common/buildpath"
+local cflags    = require "common/cflags"
+
+include "pulsar"
+include "pulsar-bindings"
+
+project "pulsar-tests"
+  kind "ConsoleApp"
+  language "C++"
+  cppdialect "C++20"
+
+  buildpath.setup("pulsar-tests")
+
+  includedirs "../include"
+  files "../src/pulsar-tests/**.cpp"
+  links { "pulsar-bindings", "pulsar" }
+
+  cflags()
@@ -23,6 +23,7 @@ end
 
 include "pulsar"
 include "pulsar-bindings"
+include "pulsar-jit"
 include "cpulsar"
 
 project "pulsar-tools"
@@ -44,6 +45,6 @@ project "pulsar-tools"
     "../src/pulsar-tools/**.cpp", "../include/pulsar-tools/**.h",
     "../libs/argue/argue.hpp"
   }
-  links { "pulsar-bindings", "pulsar" }
+  links { "pulsar-bindings", "pulsar-jit", "pulsar" }
 
   cflags()
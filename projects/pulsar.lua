@@ -18,5 +18,8 @@ project "pulsar"
   -- You can also define PULSAR_NO_ATOMIC to disable the usage of the Atomic header.
   -- Atomics are mainly used by Pulsar::SharedRef to support multi-threading.
   --   defines "PULSAR_NO_ATOMIC"
+  -- On GCC and Clang the VM dispatches instructions using computed gotos.
+  -- Define PULSAR_NO_COMPUTED_GOTO to force the portable switch-based dispatch.
+  --   defines "PULSAR_NO_COMPUTED_GOTO"
 
   cflags()
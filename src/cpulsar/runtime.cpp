@@ -136,6 +136,11 @@ CPULSAR_API CPulsar_RuntimeState CPULSAR_CALL CPulsar_ExecutionContext_Run(CPuls
     return (CPulsar_RuntimeState)CPULSAR_UNWRAP(_self).Run();
 }
 
+CPULSAR_API CPulsar_RuntimeState CPULSAR_CALL CPulsar_ExecutionContext_RunFor(CPulsar_ExecutionContext* _self, uint64_t maxInstructions)
+{
+    return (CPulsar_RuntimeState)CPULSAR_UNWRAP(_self).RunFor(maxInstructions);
+}
+
 CPULSAR_API CPulsar_RuntimeState CPULSAR_CALL CPulsar_ExecutionContext_GetState(const CPulsar_ExecutionContext* _self)
 {
     return (CPulsar_RuntimeState)CPULSAR_UNWRAP(_self).GetState();
@@ -184,6 +189,8 @@ static Pulsar::RuntimeState CRuntimeStateToCppRuntimeState(CPulsar_RuntimeState
         return Pulsar::RuntimeState::InvalidCustomTypeHandle;
     case CPulsar_RuntimeState_InvalidCustomTypeReference:
         return Pulsar::RuntimeState::InvalidCustomTypeReference;
+    case CPulsar_RuntimeState_Yielded:
+        return Pulsar::RuntimeState::Yielded;
     default:
         return Pulsar::RuntimeState::Error;
     }
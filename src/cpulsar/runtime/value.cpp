@@ -144,11 +144,24 @@ CPULSAR_API void CPULSAR_CALL CPulsar_ValueList_Delete(CPulsar_ValueList* _self)
     PULSAR_DELETE(Pulsar::Value::List, &CPULSAR_UNWRAP(_self));
 }
 
+CPULSAR_API size_t CPULSAR_CALL CPulsar_ValueList_Length(const CPulsar_ValueList* _self)
+{
+    return CPULSAR_UNWRAP(_self).Length();
+}
+
+CPULSAR_API CPulsar_Value* CPULSAR_CALL CPulsar_ValueList_Get(CPulsar_ValueList* _self, size_t index)
+{
+    Pulsar::Value::List& self = CPULSAR_UNWRAP(_self);
+    if (index >= self.Length())
+        return NULL;
+    return CPULSAR_WRAP(self[index]);
+}
+
 CPULSAR_API CPulsar_Value* CPULSAR_CALL CPulsar_ValueList_Pop(CPulsar_ValueList* _self)
 {
     Pulsar::Value::List& self = CPULSAR_UNWRAP(_self);
     CPulsar_Value* value = CPULSAR_WRAP(*PULSAR_NEW(
-        Pulsar::Value, std::move(self.Back()->Value())
+        Pulsar::Value, std::move(self.Back())
     ));
     self.RemoveBack(1);
     return value;
@@ -156,8 +169,7 @@ CPULSAR_API CPulsar_Value* CPULSAR_CALL CPulsar_ValueList_Pop(CPulsar_ValueList*
 
 CPULSAR_API CPulsar_Value* CPULSAR_CALL CPulsar_ValueList_PushEmpty(CPulsar_ValueList* _self)
 {
-    Pulsar::Value::List::Node* node = CPULSAR_UNWRAP(_self).Append();
-    return CPULSAR_WRAP(node->Value());
+    return CPULSAR_WRAP(CPULSAR_UNWRAP(_self).Append());
 }
 
 CPULSAR_API void CPULSAR_CALL CPulsar_ValueList_Push(CPulsar_ValueList* _self, CPulsar_Value* _value)
@@ -2,13 +2,10 @@
 
 std::optional<uint64_t> PulsarBindings::CustomTypeResolver::ResolveType(const Pulsar::String& typeName) const
 {
-    std::optional<uint64_t> result = std::nullopt;
-    m_Module.CustomTypes.ForEach([&result, &typeName](const auto& idTypePair) {
-        if (!result && idTypePair.Value().Name == typeName) {
-            result = idTypePair.Key();
-        }
-    });
-    return result;
+    uint64_t typeId = m_Module.FindCustomTypeByName(typeName);
+    if (typeId == 0)
+        return std::nullopt;
+    return typeId;
 }
 
 void PulsarBindings::Binding::BindTypes(Pulsar::Module& module) const
@@ -29,6 +26,16 @@ void PulsarBindings::Binding::BindFunctions(Pulsar::Module& module) const
 
     CustomTypeResolver typeResolver(module);
     for (const auto& nativeFnBinding : m_NativeFunctionsPool) {
+        if (nativeFnBinding.FastFunction) {
+            void* userData = nullptr;
+            if (nativeFnBinding.FastFunctionTypeName.Length() > 0) {
+                auto typeId = typeResolver.ResolveType(nativeFnBinding.FastFunctionTypeName);
+                PULSAR_ASSERT(typeId, "Trying to access invalid type.");
+                userData = (void*)(uintptr_t)*typeId;
+            }
+            module.BindFastNativeFunction(nativeFnBinding.Definition, nativeFnBinding.FastFunction, userData);
+            continue;
+        }
         module.BindNativeFunction(
                 nativeFnBinding.Definition,
                 nativeFnBinding.CreateFunction(typeResolver));
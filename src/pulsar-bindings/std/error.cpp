@@ -65,9 +65,7 @@ Pulsar::RuntimeState PulsarBindings::Std::Error::FTryCall(Pulsar::ExecutionConte
 
     int64_t functionIdx = functionReference.AsInteger();
 
-    Pulsar::ExecutionContext context(eContext.GetModule(), false);
-    context.GetAllCustomTypeGlobalData() = std::move(eContext.GetAllCustomTypeGlobalData());
-    context.GetGlobals() = std::move(eContext.GetGlobals());
+    Pulsar::ExecutionContext context = eContext.ForkShared();
 
     context.GetStack() = Pulsar::Stack(std::move(childStack.AsList()));
     context.CallFunction(functionIdx);
@@ -81,8 +79,8 @@ Pulsar::RuntimeState PulsarBindings::Std::Error::FTryCall(Pulsar::ExecutionConte
     frame.Stack.Push(std::move(childStack));
     frame.Stack.EmplaceInteger((int64_t)callState);
 
-    eContext.GetAllCustomTypeGlobalData() = std::move(context.GetAllCustomTypeGlobalData());
-    eContext.GetGlobals() = std::move(context.GetGlobals());
+    // Globals which were written to by the call were copied by it.
+    eContext.SwapGlobals(context);
 
     return Pulsar::RuntimeState::OK;
 }
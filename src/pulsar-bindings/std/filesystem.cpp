@@ -14,7 +14,7 @@ PulsarBindings::Std::FileSystem::FileSystem()
 Pulsar::RuntimeState PulsarBindings::Std::FileSystem::FExists(Pulsar::ExecutionContext& eContext)
 {
     Pulsar::Frame& frame = eContext.CurrentFrame();
-    Pulsar::Value& filePath = frame.Locals[0];
+    const Pulsar::Value& filePath = frame.Locals[0];
     if (filePath.Type() != Pulsar::ValueType::String)
         return Pulsar::RuntimeState::TypeError;
 
@@ -27,7 +27,7 @@ Pulsar::RuntimeState PulsarBindings::Std::FileSystem::FExists(Pulsar::ExecutionC
 Pulsar::RuntimeState PulsarBindings::Std::FileSystem::FReadAll(Pulsar::ExecutionContext& eContext)
 {
     Pulsar::Frame& frame = eContext.CurrentFrame();
-    Pulsar::Value& filePath = frame.Locals[0];
+    const Pulsar::Value& filePath = frame.Locals[0];
     if (filePath.Type() != Pulsar::ValueType::String)
         return Pulsar::RuntimeState::TypeError;
     
@@ -16,7 +16,7 @@ Pulsar::RuntimeState PulsarBindings::Std::Lexer::FFromFile(Pulsar::ExecutionCont
 {
     Pulsar::Frame& frame = eContext.CurrentFrame();
 
-    Pulsar::Value& filePath = frame.Locals[0];
+    const Pulsar::Value& filePath = frame.Locals[0];
     if (filePath.Type() != Pulsar::ValueType::String)
         return Pulsar::RuntimeState::TypeError;
 
@@ -53,18 +53,18 @@ Pulsar::RuntimeState PulsarBindings::Std::Lexer::FNextToken(Pulsar::ExecutionCon
     Pulsar::Token token = (**lexer).NextToken();
 
     Pulsar::Value::List tokenAsList;
-    tokenAsList.Append()->Value().SetInteger((int64_t)token.Type);
-    tokenAsList.Append()->Value().SetString(Pulsar::TokenTypeToString(token.Type));
+    tokenAsList.Append().SetInteger((int64_t)token.Type);
+    tokenAsList.Append().SetString(Pulsar::TokenTypeToString(token.Type));
     switch (token.Type) {
     case Pulsar::TokenType::IntegerLiteral:
-        tokenAsList.Append()->Value().SetInteger(token.IntegerVal);
+        tokenAsList.Append().SetInteger(token.IntegerVal);
         break;
     case Pulsar::TokenType::DoubleLiteral:
-        tokenAsList.Append()->Value().SetDouble(token.DoubleVal);
+        tokenAsList.Append().SetDouble(token.DoubleVal);
         break;
     default:
         if (token.StringVal.Length() > 0)
-            tokenAsList.Append()->Value().SetString(token.StringVal);
+            tokenAsList.Append().SetString(token.StringVal);
     }
 
     frame.Stack.EmplaceList(std::move(tokenAsList));
@@ -14,7 +14,7 @@ PulsarBindings::Std::Module::Module()
 Pulsar::RuntimeState PulsarBindings::Std::Module::FFromFile(Pulsar::ExecutionContext& eContext, uint64_t moduleTypeId)
 {
     Pulsar::Frame& frame = eContext.CurrentFrame();
-    Pulsar::Value& modulePath = frame.Locals[0];
+    const Pulsar::Value& modulePath = frame.Locals[0];
     if (modulePath.Type() != Pulsar::ValueType::String)
         return Pulsar::RuntimeState::TypeError;
 
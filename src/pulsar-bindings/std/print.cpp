@@ -3,24 +3,24 @@
 PulsarBindings::Std::Print::Print()
     : Binding()
 {
-    BindNativeFunction({ "print!",   1, 0 }, FPrint);
-    BindNativeFunction({ "println!", 1, 0 }, FPrintln);
+    BindFastNativeFunction({ "print!",   1, 0 }, FPrint);
+    BindFastNativeFunction({ "println!", 1, 0 }, FPrintln);
 }
 
-Pulsar::RuntimeState PulsarBindings::Std::Print::FPrint(Pulsar::ExecutionContext& eContext)
+Pulsar::RuntimeState PulsarBindings::Std::Print::FPrint(Pulsar::NativeCall& call, void* userData)
 {
-    Pulsar::Frame& frame = eContext.CurrentFrame();
-    Pulsar::Value& val = frame.Locals[0];
-    Pulsar::String out = val.ToString({ .Module = &eContext.GetModule() });
+    PULSAR_UNUSED(userData);
+    Pulsar::Value& val = call.Argument(0);
+    Pulsar::String out = val.ToString({ .Module = &call.GetContext().GetModule() });
     fputs(out.CString(), stdout);
     return Pulsar::RuntimeState::OK;
 }
 
-Pulsar::RuntimeState PulsarBindings::Std::Print::FPrintln(Pulsar::ExecutionContext& eContext)
+Pulsar::RuntimeState PulsarBindings::Std::Print::FPrintln(Pulsar::NativeCall& call, void* userData)
 {
-    Pulsar::Frame& frame = eContext.CurrentFrame();
-    Pulsar::Value& val = frame.Locals[0];
-    Pulsar::String out = val.ToString({ .Module = &eContext.GetModule() });
+    PULSAR_UNUSED(userData);
+    Pulsar::Value& val = call.Argument(0);
+    Pulsar::String out = val.ToString({ .Module = &call.GetContext().GetModule() });
     out += '\n';
     fputs(out.CString(), stdout);
     return Pulsar::RuntimeState::OK;
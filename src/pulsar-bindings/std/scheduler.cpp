@@ -0,0 +1,349 @@
+#include "pulsar-bindings/std/scheduler.h"
+
+#include <algorithm>
+
+#ifdef PULSAR_PLATFORM_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <ctime>
+#endif // PULSAR_PLATFORM_LINUX
+
+// How many times Waiter::Block() checks for a notification before sleeping.
+static constexpr size_t WAITER_SPIN_COUNT = 128;
+
+static thread_local PulsarBindings::Std::Scheduler::Task::Ref t_CurrentTask = nullptr;
+// The Scheduler which owns this thread, if it's a worker.
+static thread_local PulsarBindings::Std::Scheduler* t_WorkerOf = nullptr;
+static std::atomic_size_t s_DefaultWorkerCount = 0;
+
+PulsarBindings::Std::Scheduler::Scheduler(size_t workerCount)
+    : m_WorkerCount(workerCount)
+{
+    std::unique_lock lock(m_Mutex);
+    m_Workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; i++)
+        StartWorker();
+}
+
+PulsarBindings::Std::Scheduler::~Scheduler()
+{
+    std::unique_lock lock(m_Mutex);
+    m_Stopping = true;
+    lock.unlock();
+
+    // Workers exit once their current time slice ends.
+    m_ReadyCV.notify_all();
+    for (std::thread& worker : m_Workers)
+        worker.join();
+}
+
+void PulsarBindings::Std::Scheduler::Spawn(Task::Ref task)
+{
+    task->IsRunning.store(true);
+    Enqueue(std::move(task));
+}
+
+void PulsarBindings::Std::Scheduler::Wait(Task& task)
+{
+    auto isDone = [&task]() { return task.m_State == Task::State::Done; };
+    std::unique_lock taskLock(task.m_Mutex);
+    if (isDone()) return;
+    taskLock.unlock();
+
+    BeginBlocking();
+    taskLock.lock();
+    task.m_DoneCV.wait(taskLock, isDone);
+    taskLock.unlock();
+    EndBlocking();
+}
+
+void PulsarBindings::Std::Scheduler::OnDone(Task& task, DoneFn fn)
+{
+    std::unique_lock taskLock(task.m_Mutex);
+    if (task.m_State != Task::State::Done) {
+        task.m_OnDone.emplace_back(std::move(fn));
+        return;
+    }
+    taskLock.unlock();
+    fn();
+}
+
+void PulsarBindings::Std::Scheduler::Park(Task& task)
+{
+    std::unique_lock taskLock(task.m_Mutex);
+    task.m_ParkRequested = true;
+    task.Context.Stop();
+}
+
+void PulsarBindings::Std::Scheduler::Wake(Task::Ref task, ResumeFn onResume)
+{
+    std::unique_lock taskLock(task->m_Mutex);
+    task->m_OnResume = std::move(onResume);
+    if (task->m_State != Task::State::Parked) {
+        // Its worker is still returning from the native function which parked it.
+        task->m_WakeRequested = true;
+        return;
+    }
+
+    task->m_State = Task::State::Ready;
+    taskLock.unlock();
+    Enqueue(std::move(task));
+}
+
+void PulsarBindings::Std::Scheduler::NotifyAt(Waiter::Ref waiter, Clock::time_point deadline)
+{
+    std::unique_lock lock(m_Mutex);
+    m_Timers.push({ deadline, std::move(waiter) });
+    lock.unlock();
+
+    // An idle worker has to wait for the new deadline.
+    m_ReadyCV.notify_one();
+}
+
+void PulsarBindings::Std::Scheduler::BeginBlocking()
+{
+    Scheduler* scheduler = t_WorkerOf;
+    if (!scheduler) return;
+    std::unique_lock lock(scheduler->m_Mutex);
+    scheduler->m_BlockedWorkers++;
+    if (!scheduler->m_Stopping && scheduler->m_LiveWorkers-scheduler->m_BlockedWorkers < scheduler->m_WorkerCount)
+        scheduler->StartWorker();
+}
+
+void PulsarBindings::Std::Scheduler::EndBlocking()
+{
+    Scheduler* scheduler = t_WorkerOf;
+    if (!scheduler) return;
+    std::unique_lock lock(scheduler->m_Mutex);
+    scheduler->m_BlockedWorkers--;
+    lock.unlock();
+
+    // There may be one worker too many now, an idle one can exit right away.
+    scheduler->m_ReadyCV.notify_one();
+}
+
+PulsarBindings::Std::Scheduler::Task::Ref PulsarBindings::Std::Scheduler::GetParkableTask(const Pulsar::ExecutionContext& context)
+{
+    if (t_CurrentTask && &t_CurrentTask->Context == &context)
+        return t_CurrentTask;
+    return nullptr;
+}
+
+bool PulsarBindings::Std::Scheduler::CanSpin()
+{
+    static const bool s_CanSpin = std::thread::hardware_concurrency() > 1;
+    return s_CanSpin;
+}
+
+PulsarBindings::Std::Scheduler& PulsarBindings::Std::Scheduler::Get()
+{
+    static Scheduler s_Scheduler([]() -> size_t {
+        size_t workerCount = s_DefaultWorkerCount.load();
+        if (workerCount > 0) return workerCount;
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }());
+    return s_Scheduler;
+}
+
+void PulsarBindings::Std::Scheduler::SetDefaultWorkerCount(size_t workerCount)
+{
+    s_DefaultWorkerCount.store(workerCount);
+}
+
+void PulsarBindings::Std::Scheduler::StartWorker()
+{
+    // Exited workers are joined here so that their threads don't pile up, they don't need m_Mutex to exit.
+    for (std::thread::id workerId : m_ExitedWorkers) {
+        auto worker = std::find_if(m_Workers.begin(), m_Workers.end(),
+            [workerId](const std::thread& w) { return w.get_id() == workerId; });
+        worker->join();
+        m_Workers.erase(worker);
+    }
+    m_ExitedWorkers.clear();
+
+    m_LiveWorkers++;
+    m_Workers.emplace_back([this]() { RunWorker(); });
+}
+
+void PulsarBindings::Std::Scheduler::Enqueue(Task::Ref task)
+{
+    std::unique_lock lock(m_Mutex);
+    m_Ready.emplace_back(std::move(task));
+    lock.unlock();
+
+    m_ReadyCV.notify_one();
+}
+
+PulsarBindings::Std::Scheduler::Task::Ref PulsarBindings::Std::Scheduler::NextTask()
+{
+    std::unique_lock lock(m_Mutex);
+    for (;;) {
+        if (m_Stopping) return nullptr;
+        // Workers started while others were blocked exit once those are running again.
+        if (m_LiveWorkers-m_BlockedWorkers > m_WorkerCount) {
+            m_LiveWorkers--;
+            m_ExitedWorkers.emplace_back(std::this_thread::get_id());
+            return nullptr;
+        }
+        // Timers are checked in between time slices, so they're late by at most TIME_SLICE if all workers are busy.
+        if (!m_Timers.empty() && m_Timers.top().Deadline <= Clock::now()) {
+            Waiter::Ref waiter = m_Timers.top().Target;
+            m_Timers.pop();
+            lock.unlock();
+            waiter->TryNotify();
+            lock.lock();
+            continue;
+        }
+
+        if (!m_Ready.empty()) {
+            Task::Ref task = std::move(m_Ready.front());
+            m_Ready.pop_front();
+            return task;
+        }
+
+        if (m_Timers.empty()) m_ReadyCV.wait(lock);
+        else m_ReadyCV.wait_until(lock, m_Timers.top().Deadline);
+    }
+}
+
+void PulsarBindings::Std::Scheduler::RunWorker()
+{
+    t_WorkerOf = this;
+    for (;;) {
+        Task::Ref task = NextTask();
+        if (!task) return;
+
+        std::unique_lock taskLock(task->m_Mutex);
+        task->m_State = Task::State::Running;
+        ResumeFn onResume = std::move(task->m_OnResume);
+        task->m_OnResume = nullptr;
+        taskLock.unlock();
+
+        t_CurrentTask = task;
+        if (onResume && !onResume(task->Context)) {
+            t_CurrentTask = nullptr;
+            // It may have been woken up while `onResume` was running.
+            taskLock.lock();
+            if (!task->m_WakeRequested) {
+                task->m_State = Task::State::Parked;
+                continue;
+            }
+            task->m_WakeRequested = false;
+            task->m_State = Task::State::Ready;
+            taskLock.unlock();
+            Enqueue(std::move(task));
+            continue;
+        }
+
+        task->Context.RunUntil(std::chrono::steady_clock::now() + TIME_SLICE);
+        t_CurrentTask = nullptr;
+
+        if (task->Context.IsDone() || task->Context.GetState() != Pulsar::RuntimeState::OK) {
+            Finish(*task);
+            continue;
+        }
+
+        taskLock.lock();
+        if (task->m_ParkRequested) {
+            task->m_ParkRequested = false;
+            if (!task->m_WakeRequested) {
+                task->m_State = Task::State::Parked;
+                continue;
+            }
+            task->m_WakeRequested = false;
+        }
+        task->m_State = Task::State::Ready;
+        taskLock.unlock();
+        Enqueue(std::move(task));
+    }
+}
+
+void PulsarBindings::Std::Scheduler::Finish(Task& task)
+{
+    std::unique_lock taskLock(task.m_Mutex);
+    task.m_State = Task::State::Done;
+    task.IsRunning.store(false);
+    std::vector<DoneFn> onDone = std::move(task.m_OnDone);
+    task.m_OnDone.clear();
+    taskLock.unlock();
+
+    task.m_DoneCV.notify_all();
+    for (DoneFn& fn : onDone)
+        fn();
+}
+
+void PulsarBindings::Std::Scheduler::Waiter::Notify()
+{
+    if (m_Task) {
+        Scheduler::Get().Wake(m_Task, m_OnResume);
+        return;
+    }
+
+#ifdef PULSAR_PLATFORM_LINUX
+    m_Signal.store(1, std::memory_order_release);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_Signal), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else // PULSAR_PLATFORM_LINUX
+    std::unique_lock lock(m_Mutex);
+    m_Signal.store(1, std::memory_order_release);
+    lock.unlock();
+    m_SignalCV.notify_one();
+#endif // PULSAR_PLATFORM_LINUX
+}
+
+bool PulsarBindings::Std::Scheduler::Waiter::TryNotify()
+{
+    if (!Claim())
+        return false;
+    Notify();
+    return true;
+}
+
+bool PulsarBindings::Std::Scheduler::Waiter::Block(Clock::time_point deadline)
+{
+    size_t spinCount = CanSpin() ? WAITER_SPIN_COUNT : 0;
+    for (size_t i = 0; i < spinCount; i++) {
+        if (m_Signal.load(std::memory_order_acquire))
+            return true;
+#ifdef PULSAR_HAS_SSE2
+        _mm_pause();
+#else // PULSAR_HAS_SSE2
+        std::this_thread::yield();
+#endif // PULSAR_HAS_SSE2
+    }
+
+    BeginBlocking();
+    bool notified = Sleep(deadline);
+    EndBlocking();
+    return notified;
+}
+
+bool PulsarBindings::Std::Scheduler::Waiter::Sleep(Clock::time_point deadline)
+{
+#ifdef PULSAR_PLATFORM_LINUX
+    while (!m_Signal.load(std::memory_order_acquire)) {
+        struct timespec timeout;
+        struct timespec* timeoutPtr = nullptr;
+        if (deadline != Clock::time_point::max()) {
+            auto remaining = deadline - Clock::now();
+            if (remaining <= Clock::duration::zero())
+                return false;
+            auto remainingNs = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+            timeout.tv_sec  = (time_t)(remainingNs / 1000000000);
+            timeout.tv_nsec = (long)(remainingNs % 1000000000);
+            timeoutPtr = &timeout;
+        }
+        // Returns right away if the signal was set after it was checked.
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_Signal), FUTEX_WAIT_PRIVATE, 0, timeoutPtr, nullptr, 0);
+    }
+    return true;
+#else // PULSAR_PLATFORM_LINUX
+    std::unique_lock lock(m_Mutex);
+    auto isSignaled = [this]() { return m_Signal.load(std::memory_order_acquire) != 0; };
+    if (deadline == Clock::time_point::max()) {
+        m_SignalCV.wait(lock, isSignaled);
+        return true;
+    }
+    return m_SignalCV.wait_until(lock, deadline, isSignaled);
+#endif // PULSAR_PLATFORM_LINUX
+}
@@ -31,7 +31,7 @@ Pulsar::RuntimeState PulsarBindings::Std::Stdio::FInRead(Pulsar::ExecutionContex
 Pulsar::RuntimeState PulsarBindings::Std::Stdio::FOutWrite(Pulsar::ExecutionContext& eContext)
 {
     Pulsar::Frame& frame = eContext.CurrentFrame();
-    Pulsar::Value& message = frame.Locals[0];
+    const Pulsar::Value& message = frame.Locals[0];
     if (message.Type() != Pulsar::ValueType::String)
         return Pulsar::RuntimeState::TypeError;
     std::cout << message.AsString().CString() << std::flush;
@@ -41,7 +41,7 @@ Pulsar::RuntimeState PulsarBindings::Std::Stdio::FOutWrite(Pulsar::ExecutionCont
 Pulsar::RuntimeState PulsarBindings::Std::Stdio::FOutWriteLn(Pulsar::ExecutionContext& eContext)
 {
     Pulsar::Frame& frame = eContext.CurrentFrame();
-    Pulsar::Value& message = frame.Locals[0];
+    const Pulsar::Value& message = frame.Locals[0];
     if (message.Type() != Pulsar::ValueType::String)
         return Pulsar::RuntimeState::TypeError;
     std::cout << message.AsString().CString() << std::endl;
@@ -1,6 +1,9 @@
 #include "pulsar-bindings/std/thread.h"
 
+#include <algorithm>
+#include <bit>
 #include <chrono>
+#include <memory>
 
 PulsarBindings::Std::Thread::Thread()
     : Binding()
@@ -26,8 +29,23 @@ Pulsar::RuntimeState PulsarBindings::Std::Thread::FThisSleep(Pulsar::ExecutionCo
         return Pulsar::RuntimeState::TypeError;
     int64_t delayMs = delay.Type() == Pulsar::ValueType::Double ?
         (int64_t)delay.AsDouble() : (int64_t)delay.AsInteger();
-    if (delayMs > 0)
-        std::this_thread::sleep_for(std::chrono::duration<int64_t, std::milli>(delayMs));
+    if (delayMs <= 0)
+        return Pulsar::RuntimeState::OK;
+
+    std::chrono::duration<int64_t, std::milli> duration(delayMs);
+    Scheduler::Task::Ref task = Scheduler::GetParkableTask(eContext);
+    if (!task) {
+        Scheduler::BeginBlocking();
+        std::this_thread::sleep_for(duration);
+        Scheduler::EndBlocking();
+        return Pulsar::RuntimeState::OK;
+    }
+
+    // Threads run by the Scheduler are parked on a timer instead of blocking its worker.
+    Scheduler& scheduler = Scheduler::Get();
+    scheduler.Park(*task);
+    auto waiter = Scheduler::Waiter::Ref::New(std::move(task), [](Pulsar::ExecutionContext&) { return true; });
+    scheduler.NotifyAt(std::move(waiter), Scheduler::Clock::now() + duration);
     return Pulsar::RuntimeState::OK;
 }
 
@@ -47,20 +65,18 @@ Pulsar::RuntimeState PulsarBindings::Std::Thread::FRun(Pulsar::ExecutionContext&
         return Pulsar::RuntimeState::TypeError;
 
     const Pulsar::FunctionDefinition& threadFn = module.Functions[(size_t)threadFnIdx];
+    // The new thread shares Globals and arguments with this one.
+    eContext.PromoteGlobalsToAtomic();
+    threadFnArgs.PromoteToAtomic();
     Pulsar::SharedRef<ThreadContext> threadContext = Pulsar::SharedRef<ThreadContext>::New(eContext.Fork());
 
     threadContext->Context.GetStack() = Pulsar::Stack(std::move(threadFnArgs.AsList()));
-
-    threadContext->IsRunning.store(true);
-    std::thread nativeThread = std::thread([threadFn, threadContext]() {
-        threadContext->Context.CallFunction(threadFn);
-        threadContext->Context.Run();
-        threadContext->IsRunning.store(false);
-    });
+    threadContext->Context.CallFunction(threadFn);
+    Scheduler::Get().Spawn(threadContext);
 
     frame.Stack.EmplaceCustom({
             .Type=threadTypeId,
-            .Data=ThreadType::Ref::New(std::move(nativeThread), std::move(threadContext))
+            .Data=ThreadType::Ref::New(std::move(threadContext))
         });
 
     return Pulsar::RuntimeState::OK;
@@ -76,33 +92,62 @@ Pulsar::RuntimeState PulsarBindings::Std::Thread::FJoin(Pulsar::ExecutionContext
         return Pulsar::RuntimeState::TypeError;
     if (!thread) return Pulsar::RuntimeState::InvalidCustomTypeReference;
 
-    Join(thread, frame.Stack);
+    Scheduler::Task::Ref task = Scheduler::GetParkableTask(eContext);
+    if (!task) {
+        Join(thread, frame.Stack);
+        return Pulsar::RuntimeState::OK;
+    }
+
+    // Threads run by the Scheduler wait without blocking its worker.
+    Scheduler& scheduler = Scheduler::Get();
+    scheduler.Park(*task);
+    scheduler.OnDone(*thread->ThreadContext, [&scheduler, task, thread]() {
+        scheduler.Wake(task, [thread](Pulsar::ExecutionContext& context) {
+            Join(thread, context.CurrentFrame().Stack);
+            return true;
+        });
+    });
     return Pulsar::RuntimeState::OK;
 }
 
 Pulsar::RuntimeState PulsarBindings::Std::Thread::FJoinAll(Pulsar::ExecutionContext& eContext, uint64_t threadTypeId)
 {
     Pulsar::Frame& frame = eContext.CurrentFrame();
-    Pulsar::Value& threadReferencesList = frame.Locals[0];
+    const Pulsar::Value& threadReferencesList = frame.Locals[0];
     if (threadReferencesList.Type() != Pulsar::ValueType::List)
         return Pulsar::RuntimeState::TypeError;
 
-    Pulsar::Value::List threadResults;
-    for (Pulsar::Value& threadReference : threadReferencesList.AsList()) {
+    std::vector<ThreadType::Ref> threads;
+    threads.reserve(threadReferencesList.AsList().Length());
+    for (const Pulsar::Value& threadReference : threadReferencesList.AsList()) {
         ThreadType::Ref thread;
         if (!threadReference.GetCustomAs(threadTypeId, thread))
             return Pulsar::RuntimeState::TypeError;
         if (!thread) return Pulsar::RuntimeState::InvalidCustomTypeReference;
+        threads.emplace_back(std::move(thread));
+    }
 
-        Join(thread, frame.Stack);
-        Pulsar::Value::List threadResult;
-        threadResult.Append(frame.Stack.Pop());
-        threadResult.Append(frame.Stack.Pop());
-
-        threadResults.Append()->Value().SetList(std::move(threadResult));
+    Scheduler::Task::Ref task = Scheduler::GetParkableTask(eContext);
+    if (!task || threads.empty()) {
+        JoinAll(threads, frame.Stack);
+        return Pulsar::RuntimeState::OK;
     }
 
-    frame.Stack.EmplaceList(std::move(threadResults));
+    // Woken up by the last thread which finishes.
+    Scheduler& scheduler = Scheduler::Get();
+    scheduler.Park(*task);
+    auto runningThreads = std::make_shared<std::atomic_size_t>(threads.size());
+    auto sharedThreads = std::make_shared<std::vector<ThreadType::Ref>>(std::move(threads));
+    for (const ThreadType::Ref& thread : *sharedThreads) {
+        scheduler.OnDone(*thread->ThreadContext, [&scheduler, task, runningThreads, sharedThreads]() {
+            if (runningThreads->fetch_sub(1) != 1)
+                return;
+            scheduler.Wake(task, [sharedThreads](Pulsar::ExecutionContext& context) {
+                JoinAll(*sharedThreads, context.CurrentFrame().Stack);
+                return true;
+            });
+        });
+    }
     return Pulsar::RuntimeState::OK;
 }
 
@@ -135,7 +180,7 @@ Pulsar::RuntimeState PulsarBindings::Std::Thread::FIsValid(Pulsar::ExecutionCont
 
 void PulsarBindings::Std::Thread::Join(Pulsar::SharedRef<ThreadData> thread, Pulsar::Stack& stack)
 {
-    thread->Thread.join();
+    Scheduler::Get().Wait(*thread->ThreadContext);
     Pulsar::Value::List threadResult;
     Pulsar::RuntimeState threadState = thread->ThreadContext->Context.GetState();
     if (threadState != Pulsar::RuntimeState::OK) {
@@ -147,24 +192,324 @@ void PulsarBindings::Std::Thread::Join(Pulsar::SharedRef<ThreadData> thread, Pul
 
     Pulsar::Value::List returnValues;
     Pulsar::Stack& threadStack = thread->ThreadContext->Context.GetStack();
-    for (Pulsar::Value& value : threadStack) returnValues.Append(std::move(value));
+    // Return values may share data with the context of the thread, which may be destroyed by any thread holding a reference to it.
+    for (Pulsar::Value& value : threadStack) {
+        value.PromoteToAtomic();
+        returnValues.Append(std::move(value));
+    }
 
     stack.EmplaceList(std::move(returnValues));
     stack.EmplaceInteger(0);
 }
 
+void PulsarBindings::Std::Thread::JoinAll(const std::vector<ThreadType::Ref>& threads, Pulsar::Stack& stack)
+{
+    Pulsar::Value::List threadResults;
+    for (const ThreadType::Ref& thread : threads) {
+        Join(thread, stack);
+        Pulsar::Value::List threadResult;
+        threadResult.Append(stack.Pop());
+        threadResult.Append(stack.Pop());
+
+        threadResults.Append().SetList(std::move(threadResult));
+    }
+
+    stack.EmplaceList(std::move(threadResults));
+}
+
+PulsarBindings::Std::Channel::ChannelData::ChannelData(size_t capacity)
+    : m_IsBounded(capacity != UNBOUNDED)
+{
+    if (!m_IsBounded)
+        capacity = UNBOUNDED_QUEUE_CAPACITY;
+    capacity = std::bit_ceil(std::clamp(capacity, (size_t)2, MAX_CAPACITY));
+    m_Slots = std::make_unique<Slot[]>(capacity);
+    m_Mask = capacity-1;
+    for (size_t i = 0; i < capacity; i++)
+        m_Slots[i].Sequence.store(i, std::memory_order_relaxed);
+}
+
+bool PulsarBindings::Std::Channel::ChannelData::TrySend(Pulsar::Value& value)
+{
+    if (m_IsBounded)
+        return TrySendToQueue(value);
+    // Values which were sent to the overflow list must be received first.
+    if (m_Overflow.Count.load(std::memory_order_seq_cst) == 0 && TrySendToQueue(value))
+        return true;
+
+    std::unique_lock overflowLock(m_OverflowMutex);
+    m_Overflow.Values.push_back(std::move(value));
+    m_Overflow.Count.store(m_Overflow.Values.size(), std::memory_order_seq_cst);
+    overflowLock.unlock();
+
+    if (m_Receivers.Count.load(std::memory_order_seq_cst) > 0)
+        NotifyOne(m_Receivers);
+    return true;
+}
+
+bool PulsarBindings::Std::Channel::ChannelData::TryReceive(Pulsar::Value& value)
+{
+    if (TryReceiveFromQueue(value))
+        return true;
+    if (m_IsBounded || m_Overflow.Count.load(std::memory_order_seq_cst) == 0)
+        return false;
+
+    // Values within the queue were sent before the ones in the overflow list, and it's empty.
+    std::unique_lock overflowLock(m_OverflowMutex);
+    if (m_Overflow.Values.empty())
+        return false;
+    value = std::move(m_Overflow.Values.front());
+    m_Overflow.Values.pop_front();
+    m_Overflow.Count.store(m_Overflow.Values.size(), std::memory_order_seq_cst);
+    return true;
+}
+
+bool PulsarBindings::Std::Channel::ChannelData::TrySendToQueue(Pulsar::Value& value)
+{
+    size_t position = m_SendPosition.Value.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &m_Slots[position & m_Mask];
+        size_t sequence = slot->Sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)position;
+        if (diff == 0) {
+            // Sequentially consistent so that receivers which are about to wait see it, see ::AddWaiter().
+            if (m_SendPosition.Value.compare_exchange_weak(position, position+1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // The slot still holds the value sent Capacity() positions ago.
+            return false;
+        } else position = m_SendPosition.Value.load(std::memory_order_relaxed);
+    }
+
+    slot->Value = std::move(value);
+    slot->Sequence.store(position+1, std::memory_order_release);
+
+    if (m_Receivers.Count.load(std::memory_order_seq_cst) > 0)
+        NotifyOne(m_Receivers);
+    return true;
+}
+
+bool PulsarBindings::Std::Channel::ChannelData::TryReceiveFromQueue(Pulsar::Value& value)
+{
+    size_t position = m_ReceivePosition.Value.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &m_Slots[position & m_Mask];
+        size_t sequence = slot->Sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(position+1);
+        if (diff == 0) {
+            if (m_ReceivePosition.Value.compare_exchange_weak(position, position+1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // Nothing was sent to the slot yet.
+            return false;
+        } else position = m_ReceivePosition.Value.load(std::memory_order_relaxed);
+    }
+
+    // Moving leaves Void within the slot, so it doesn't keep the value alive.
+    value = std::move(slot->Value);
+    slot->Sequence.store(position+m_Mask+1, std::memory_order_release);
+
+    if (m_Senders.Count.load(std::memory_order_seq_cst) > 0)
+        NotifyOne(m_Senders);
+    return true;
+}
+
+void PulsarBindings::Std::Channel::ChannelData::Close()
+{
+    m_IsClosed.store(true, std::memory_order_seq_cst);
+    NotifyAll(m_Receivers);
+    NotifyAll(m_Senders);
+}
+
+bool PulsarBindings::Std::Channel::ChannelData::IsEmpty() const
+{
+    size_t receivePosition = m_ReceivePosition.Value.load(std::memory_order_seq_cst);
+    return m_SendPosition.Value.load(std::memory_order_seq_cst) == receivePosition
+        && m_Overflow.Count.load(std::memory_order_seq_cst) == 0;
+}
+
+bool PulsarBindings::Std::Channel::ChannelData::IsFull() const
+{
+    if (!m_IsBounded)
+        return false;
+    size_t receivePosition = m_ReceivePosition.Value.load(std::memory_order_seq_cst);
+    return m_SendPosition.Value.load(std::memory_order_seq_cst) - receivePosition > m_Mask;
+}
+
+void PulsarBindings::Std::Channel::ChannelData::AddWaiter(WaiterList& list, const Scheduler::Waiter::Ref& waiter)
+{
+    std::unique_lock waitersLock(m_WaitersMutex);
+    // Waiters which were notified by something else (e.g. another Channel) are dropped.
+    std::erase_if(list.Waiters, [](const Scheduler::Waiter::Ref& w) { return w->IsClaimed(); });
+    list.Waiters.push_back(waiter);
+    // Either the caller sees a value which was sent after this (through ::IsEmpty()), or its sender sees the waiter.
+    // The caller must check if it still has to wait after this.
+    list.Count.store(list.Waiters.size(), std::memory_order_seq_cst);
+}
+
+void PulsarBindings::Std::Channel::ChannelData::NotifyOne(WaiterList& list)
+{
+    std::unique_lock waitersLock(m_WaitersMutex);
+    while (!list.Waiters.empty()) {
+        Scheduler::Waiter::Ref waiter = std::move(list.Waiters.front());
+        list.Waiters.pop_front();
+        list.Count.store(list.Waiters.size(), std::memory_order_relaxed);
+        if (waiter->Claim()) {
+            waitersLock.unlock();
+            waiter->Notify();
+            return;
+        }
+    }
+}
+
+void PulsarBindings::Std::Channel::ChannelData::NotifyAll(WaiterList& list)
+{
+    std::unique_lock waitersLock(m_WaitersMutex);
+    std::deque<Scheduler::Waiter::Ref> waiters = std::move(list.Waiters);
+    list.Waiters.clear();
+    list.Count.store(0, std::memory_order_relaxed);
+    waitersLock.unlock();
+
+    for (const Scheduler::Waiter::Ref& waiter : waiters)
+        waiter->TryNotify();
+}
+
+// How many times a channel operation is retried before waiting.
+static constexpr size_t CHANNEL_SPIN_COUNT = 64;
+
+
+namespace
+{
+    using PulsarBindings::Std::Scheduler;
+    using ChannelRef = PulsarBindings::Std::Channel::ChannelType::Ref;
+
+    // A blocking operation on one or more Channels, which is attempted until it completes.
+    struct ChannelOperation
+    {
+        std::vector<ChannelRef> Channels;
+        // Whether it waits for the Channels to have room for a value, or to have one.
+        bool IsSend = false;
+        Scheduler::Clock::time_point Deadline = Scheduler::Clock::time_point::max();
+        // Returns true once the operation completes, after pushing its return values onto `stack`.
+        std::function<bool(Pulsar::Stack& stack)> Attempt;
+        // Pushes the return values of an operation which timed out.
+        std::function<void(Pulsar::Stack& stack)> OnTimeout;
+    };
+
+    using ChannelOperationRef = std::shared_ptr<ChannelOperation>;
+}
+
+// Adds `waiter` to the Channels of `op`, notifying it right away if `op` may complete.
+static void WaitOn(const ChannelOperation& op, const Scheduler::Waiter::Ref& waiter)
+{
+    for (const ChannelRef& channel : op.Channels) {
+        if (op.IsSend) channel->AddSender(waiter);
+        else channel->AddReceiver(waiter);
+        if (channel->IsClosed() || (op.IsSend ? !channel->IsFull() : !channel->IsEmpty())) {
+            waiter->TryNotify();
+            return;
+        }
+    }
+}
+
+// Parks `task` until `op` may complete, it's attempted again before resuming the task.
+static void ParkOn(Scheduler::Task::Ref task, ChannelOperationRef op)
+{
+    auto waiter = Scheduler::Waiter::Ref::New(std::move(task), [op](Pulsar::ExecutionContext& context) {
+        Pulsar::Stack& stack = context.CurrentFrame().Stack;
+        if (op->Attempt(stack))
+            return true;
+        if (Scheduler::Clock::now() >= op->Deadline) {
+            op->OnTimeout(stack);
+            return true;
+        }
+        // Another receiver (or sender) got there first.
+        ParkOn(Scheduler::GetParkableTask(context), op);
+        return false;
+    });
+
+    if (op->Deadline != Scheduler::Clock::time_point::max())
+        Scheduler::Get().NotifyAt(waiter, op->Deadline);
+    WaitOn(*op, waiter);
+}
+
+// Completes `op` pushing its return values onto `stack`. Tasks are parked instead of blocking their worker.
+static void RunChannelOperation(Pulsar::ExecutionContext& eContext, Pulsar::Stack& stack, ChannelOperationRef op)
+{
+    if (op->Attempt(stack))
+        return;
+
+    // Waiting is expensive compared to spinning for a while, the other side is likely running on another core.
+    // Tasks don't spin if there's only one worker, it would keep the other side from running.
+    Scheduler::Task::Ref task = Scheduler::GetParkableTask(eContext);
+    if (Scheduler::CanSpin() && (!task || Scheduler::Get().GetWorkerCount() > 1)) {
+        for (size_t i = 0; i < CHANNEL_SPIN_COUNT; i++) {
+#ifdef PULSAR_HAS_SSE2
+            _mm_pause();
+#else // PULSAR_HAS_SSE2
+            std::this_thread::yield();
+#endif // PULSAR_HAS_SSE2
+            if (op->Attempt(stack))
+                return;
+        }
+    }
+
+    if (task) {
+        Scheduler::Get().Park(*task);
+        ParkOn(std::move(task), std::move(op));
+        return;
+    }
+
+    for (;;) {
+        auto waiter = Scheduler::Waiter::Ref::New(nullptr, nullptr);
+        WaitOn(*op, waiter);
+        // Claiming it prevents Channels from notifying it after it timed out.
+        if (!waiter->Block(op->Deadline))
+            waiter->Claim();
+        if (op->Attempt(stack))
+            return;
+        if (Scheduler::Clock::now() >= op->Deadline) {
+            op->OnTimeout(stack);
+            return;
+        }
+    }
+}
+
+// Pushes the received value, or Void if the Channel is closed and empty.
+static bool AttemptReceive(PulsarBindings::Std::Channel::ChannelData& channel, Pulsar::Stack& stack)
+{
+    Pulsar::Value value;
+    if (channel.TryReceive(value)) {
+        stack.Push(std::move(value));
+        return true;
+    }
+    if (!channel.IsClosed())
+        return false;
+    // Values which were sent before the Channel was closed are still received.
+    if (channel.TryReceive(value)) stack.Push(std::move(value));
+    else stack.Emplace();
+    return true;
+}
+
 PulsarBindings::Std::Channel::Channel()
     : Binding()
 {
     BindCustomType("PulsarStd/Channel");
 
-    BindNativeFunction({ "channel/new",     0, 1 }, CreateTypeBoundFactory(FNew,      "PulsarStd/Channel"));
-    BindNativeFunction({ "channel/send!",   2, 0 }, CreateTypeBoundFactory(FSend,     "PulsarStd/Channel"));
-    BindNativeFunction({ "channel/receive", 1, 1 }, CreateTypeBoundFactory(FReceive,  "PulsarStd/Channel"));
-    BindNativeFunction({ "channel/close!",  1, 0 }, CreateTypeBoundFactory(FClose,    "PulsarStd/Channel"));
-    BindNativeFunction({ "channel/empty?",  1, 1 }, CreateTypeBoundFactory(FIsEmpty,  "PulsarStd/Channel"));
-    BindNativeFunction({ "channel/closed?", 1, 1 }, CreateTypeBoundFactory(FIsClosed, "PulsarStd/Channel"));
-    BindNativeFunction({ "channel/valid?",  1, 1 }, CreateTypeBoundFactory(FIsValid,  "PulsarStd/Channel"));
+    BindNativeFunction({ "channel/new",             0, 1 }, CreateTypeBoundFactory(FNew,            "PulsarStd/Channel"));
+    BindNativeFunction({ "channel/with-capacity",   1, 1 }, CreateTypeBoundFactory(FWithCapacity,   "PulsarStd/Channel"));
+    BindFastNativeFunction({ "channel/send!",       2, 0 }, FSend,       "PulsarStd/Channel");
+    BindFastNativeFunction({ "channel/try-send!",   2, 1 }, FTrySend,    "PulsarStd/Channel");
+    BindNativeFunction({ "channel/receive",         1, 1 }, CreateTypeBoundFactory(FReceive,        "PulsarStd/Channel"));
+    BindFastNativeFunction({ "channel/try-receive", 1, 2 }, FTryReceive, "PulsarStd/Channel");
+    BindNativeFunction({ "channel/receive-timeout", 2, 2 }, CreateTypeBoundFactory(FReceiveTimeout, "PulsarStd/Channel"));
+    BindNativeFunction({ "channel/select",          1, 2 }, CreateTypeBoundFactory(FSelect,         "PulsarStd/Channel"));
+    BindNativeFunction({ "channel/close!",          1, 0 }, CreateTypeBoundFactory(FClose,          "PulsarStd/Channel"));
+    BindNativeFunction({ "channel/empty?",          1, 1 }, CreateTypeBoundFactory(FIsEmpty,        "PulsarStd/Channel"));
+    BindNativeFunction({ "channel/closed?",         1, 1 }, CreateTypeBoundFactory(FIsClosed,       "PulsarStd/Channel"));
+    BindNativeFunction({ "channel/valid?",          1, 1 }, CreateTypeBoundFactory(FIsValid,        "PulsarStd/Channel"));
 }
 
 Pulsar::RuntimeState PulsarBindings::Std::Channel::FNew(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId)
@@ -176,23 +521,58 @@ Pulsar::RuntimeState PulsarBindings::Std::Channel::FNew(Pulsar::ExecutionContext
     return Pulsar::RuntimeState::OK;
 }
 
-Pulsar::RuntimeState PulsarBindings::Std::Channel::FSend(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId)
+Pulsar::RuntimeState PulsarBindings::Std::Channel::FWithCapacity(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId)
 {
     Pulsar::Frame& frame = eContext.CurrentFrame();
-    Pulsar::Value& channelReference = frame.Locals[1];
+    Pulsar::Value& capacity = frame.Locals[0];
+    if (capacity.Type() != Pulsar::ValueType::Integer)
+        return Pulsar::RuntimeState::TypeError;
+
+    ChannelType::Ref channel = ChannelType::Ref::New((size_t)std::max(capacity.AsInteger(), (int64_t)1));
+    frame.Stack.EmplaceCustom({ channelTypeId, channel });
+    return Pulsar::RuntimeState::OK;
+}
+
+Pulsar::RuntimeState PulsarBindings::Std::Channel::FSend(Pulsar::NativeCall& call, void* channelTypeId)
+{
+    Pulsar::Value& channelReference = call.Argument(1);
 
     ChannelType::Ref channel;
-    if (!channelReference.GetCustomAs(channelTypeId, channel))
+    if (!channelReference.GetCustomAs(TypeIdOf(channelTypeId), channel))
         return Pulsar::RuntimeState::TypeError;
     if (!channel) return Pulsar::RuntimeState::InvalidCustomTypeReference;
 
-    std::unique_lock channelLock(channel->Mutex);
-    if (channel->IsClosed)
+    Pulsar::Value& value = call.Argument(0);
+    value.PromoteToAtomic();
+    // Values sent to a closed Channel are dropped.
+    if (channel->IsClosed() || channel->TrySend(value))
         return Pulsar::RuntimeState::OK;
-    channel->Pipe.Append(std::move(frame.Locals[0]));
-    channelLock.unlock();
 
-    channel->CV.notify_one();
+    // Blocks (or parks) until the Channel has room for the value.
+    auto op = std::make_shared<ChannelOperation>();
+    op->Channels.emplace_back(channel);
+    op->IsSend = true;
+    op->Attempt = [channel, value = std::move(value)](Pulsar::Stack&) mutable {
+        return channel->IsClosed() || channel->TrySend(value);
+    };
+
+    Pulsar::ExecutionContext& eContext = call.GetContext();
+    RunChannelOperation(eContext, eContext.CurrentFrame().Stack, std::move(op));
+    return Pulsar::RuntimeState::OK;
+}
+
+Pulsar::RuntimeState PulsarBindings::Std::Channel::FTrySend(Pulsar::NativeCall& call, void* channelTypeId)
+{
+    Pulsar::Value& channelReference = call.Argument(1);
+
+    ChannelType::Ref channel;
+    if (!channelReference.GetCustomAs(TypeIdOf(channelTypeId), channel))
+        return Pulsar::RuntimeState::TypeError;
+    if (!channel) return Pulsar::RuntimeState::InvalidCustomTypeReference;
+
+    Pulsar::Value& value = call.Argument(0);
+    value.PromoteToAtomic();
+    call.PushInteger(!channel->IsClosed() && channel->TrySend(value) ? 1 : 0);
     return Pulsar::RuntimeState::OK;
 }
 
@@ -206,19 +586,124 @@ Pulsar::RuntimeState PulsarBindings::Std::Channel::FReceive(Pulsar::ExecutionCon
         return Pulsar::RuntimeState::TypeError;
     if (!channel) return Pulsar::RuntimeState::InvalidCustomTypeReference;
 
-    std::unique_lock channelLock(channel->Mutex);
-    channel->CV.wait(channelLock, [&channel]() {
-        // Wait for Channel to have items or to be closed
-        return channel->Pipe.Front() || channel->IsClosed;
-    });
+    if (AttemptReceive(*channel, frame.Stack))
+        return Pulsar::RuntimeState::OK;
+
+    auto op = std::make_shared<ChannelOperation>();
+    op->Channels.emplace_back(channel);
+    op->Attempt = [channel](Pulsar::Stack& stack) { return AttemptReceive(*channel, stack); };
+    RunChannelOperation(eContext, frame.Stack, std::move(op));
+    return Pulsar::RuntimeState::OK;
+}
+
+Pulsar::RuntimeState PulsarBindings::Std::Channel::FTryReceive(Pulsar::NativeCall& call, void* channelTypeId)
+{
+    Pulsar::Value& channelReference = call.Argument(0);
 
-    if (channel->IsClosed && !channel->Pipe.Front()) {
-        frame.Stack.Emplace(); // Push Void
+    ChannelType::Ref channel;
+    if (!channelReference.GetCustomAs(TypeIdOf(channelTypeId), channel))
+        return Pulsar::RuntimeState::TypeError;
+    if (!channel) return Pulsar::RuntimeState::InvalidCustomTypeReference;
+
+    Pulsar::Value value;
+    bool received = channel->TryReceive(value);
+    call.PushResult(std::move(value));
+    call.PushInteger(received ? 1 : 0);
+    return Pulsar::RuntimeState::OK;
+}
+
+Pulsar::RuntimeState PulsarBindings::Std::Channel::FReceiveTimeout(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId)
+{
+    Pulsar::Frame& frame = eContext.CurrentFrame();
+    Pulsar::Value& channelReference = frame.Locals[0];
+
+    ChannelType::Ref channel;
+    if (!channelReference.GetCustomAs(channelTypeId, channel))
+        return Pulsar::RuntimeState::TypeError;
+    if (!channel) return Pulsar::RuntimeState::InvalidCustomTypeReference;
+
+    Pulsar::Value& timeout = frame.Locals[1];
+    if (!Pulsar::IsNumericValueType(timeout.Type()))
+        return Pulsar::RuntimeState::TypeError;
+    double timeoutMs = timeout.Type() == Pulsar::ValueType::Double ?
+        timeout.AsDouble() : (double)timeout.AsInteger();
+
+    // Like channel/receive, but Void and 0 are pushed if it times out or the Channel is closed and empty.
+    auto op = std::make_shared<ChannelOperation>();
+    op->Channels.emplace_back(channel);
+    op->Deadline = Scheduler::Clock::now() + std::chrono::duration_cast<Scheduler::Clock::duration>(
+        std::chrono::duration<double, std::milli>(std::max(timeoutMs, 0.0)));
+    op->Attempt = [channel](Pulsar::Stack& stack) {
+        Pulsar::Value value;
+        if (channel->TryReceive(value)) {
+            stack.Push(std::move(value));
+            stack.EmplaceInteger(1);
+            return true;
+        }
+        if (!channel->IsClosed())
+            return false;
+        bool received = channel->TryReceive(value);
+        stack.Push(std::move(value));
+        stack.EmplaceInteger(received ? 1 : 0);
+        return true;
+    };
+    op->OnTimeout = [](Pulsar::Stack& stack) {
+        stack.Emplace();
+        stack.EmplaceInteger(0);
+    };
+
+    if (timeoutMs <= 0.0) {
+        if (!op->Attempt(frame.Stack))
+            op->OnTimeout(frame.Stack);
         return Pulsar::RuntimeState::OK;
     }
 
-    frame.Stack.Push(std::move(channel->Pipe.Front()->Value()));
-    channel->Pipe.RemoveFront(1);
+    RunChannelOperation(eContext, frame.Stack, std::move(op));
+    return Pulsar::RuntimeState::OK;
+}
+
+Pulsar::RuntimeState PulsarBindings::Std::Channel::FSelect(Pulsar::ExecutionContext& eContext, uint64_t channelTypeId)
+{
+    Pulsar::Frame& frame = eContext.CurrentFrame();
+    const Pulsar::Value& channelReferencesList = frame.Locals[0];
+    if (channelReferencesList.Type() != Pulsar::ValueType::List)
+        return Pulsar::RuntimeState::TypeError;
+
+    auto op = std::make_shared<ChannelOperation>();
+    op->Channels.reserve(channelReferencesList.AsList().Length());
+    for (const Pulsar::Value& channelReference : channelReferencesList.AsList()) {
+        ChannelType::Ref channel;
+        if (!channelReference.GetCustomAs(channelTypeId, channel))
+            return Pulsar::RuntimeState::TypeError;
+        if (!channel) return Pulsar::RuntimeState::InvalidCustomTypeReference;
+        op->Channels.emplace_back(std::move(channel));
+    }
+
+    // Pushes the value received from the first Channel which has one and its index.
+    // Void and -1 are pushed once all Channels are closed and empty.
+    op->Attempt = [channels = op->Channels, start = (size_t)0](Pulsar::Stack& stack) mutable {
+        bool allClosed = true;
+        // The first Channel which is checked changes on each attempt, so that busy ones don't starve the others.
+        for (size_t i = 0; i < channels.size(); i++) {
+            size_t channelIdx = (start+i) % channels.size();
+            Pulsar::Value value;
+            if (channels[channelIdx]->TryReceive(value)) {
+                start = channelIdx+1;
+                stack.Push(std::move(value));
+                stack.EmplaceInteger((int64_t)channelIdx);
+                return true;
+            }
+            allClosed = allClosed && channels[channelIdx]->IsClosed();
+        }
+        start++;
+        if (!allClosed)
+            return false;
+        stack.Emplace();
+        stack.EmplaceInteger(-1);
+        return true;
+    };
+
+    RunChannelOperation(eContext, frame.Stack, std::move(op));
     return Pulsar::RuntimeState::OK;
 }
 
@@ -232,9 +717,8 @@ Pulsar::RuntimeState PulsarBindings::Std::Channel::FClose(Pulsar::ExecutionConte
         return Pulsar::RuntimeState::TypeError;
     if (!channel) return Pulsar::RuntimeState::InvalidCustomTypeReference;
 
-    std::unique_lock channelLock(channel->Mutex);
-    channel->IsClosed = true;
-    channel->CV.notify_all();
+    // Waiting receivers get Void, waiting senders drop their value.
+    channel->Close();
     return Pulsar::RuntimeState::OK;
 }
 
@@ -248,8 +732,7 @@ Pulsar::RuntimeState PulsarBindings::Std::Channel::FIsEmpty(Pulsar::ExecutionCon
         return Pulsar::RuntimeState::TypeError;
     if (!channel) return Pulsar::RuntimeState::InvalidCustomTypeReference;
 
-    std::unique_lock channelLock(channel->Mutex);
-    frame.Stack.EmplaceInteger(channel->Pipe.Front() ? 0 : 1);
+    frame.Stack.EmplaceInteger(channel->IsEmpty() ? 1 : 0);
     return Pulsar::RuntimeState::OK;
 }
 
@@ -263,8 +746,7 @@ Pulsar::RuntimeState PulsarBindings::Std::Channel::FIsClosed(Pulsar::ExecutionCo
         return Pulsar::RuntimeState::TypeError;
     if (!channel) return Pulsar::RuntimeState::InvalidCustomTypeReference;
 
-    std::unique_lock channelLock(channel->Mutex);
-    frame.Stack.EmplaceInteger(channel->IsClosed ? 1 : 0);
+    frame.Stack.EmplaceInteger(channel->IsClosed() ? 1 : 0);
     return Pulsar::RuntimeState::OK;
 }
 
@@ -6,42 +6,41 @@
 PulsarBindings::Std::Time::Time()
     : Binding()
 {
-    BindNativeFunction({ "time", 0, 1 }, FTime);
-    BindNativeFunction({ "time/steady", 0, 1 }, FSteady);
-    BindNativeFunction({ "time/micros", 0, 1 }, FMicros);
+    BindFastNativeFunction({ "time", 0, 1 }, FTime);
+    BindFastNativeFunction({ "time/steady", 0, 1 }, FSteady);
+    BindFastNativeFunction({ "time/micros", 0, 1 }, FMicros);
 }
 
-Pulsar::RuntimeState PulsarBindings::Std::Time::FTime(Pulsar::ExecutionContext& eContext)
+Pulsar::RuntimeState PulsarBindings::Std::Time::FTime(Pulsar::NativeCall& call, void* userData)
 {
+    PULSAR_UNUSED(userData);
     auto time = std::chrono::system_clock::now();
     auto timeSinceEpoch = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch());
-    eContext.CurrentFrame()
-        .Stack.EmplaceInteger((int64_t)timeSinceEpoch.count());
+    call.PushInteger((int64_t)timeSinceEpoch.count());
     return Pulsar::RuntimeState::OK;
 }
 
-Pulsar::RuntimeState PulsarBindings::Std::Time::FSteady(Pulsar::ExecutionContext& eContext)
+Pulsar::RuntimeState PulsarBindings::Std::Time::FSteady(Pulsar::NativeCall& call, void* userData)
 {
+    PULSAR_UNUSED(userData);
     auto time = std::chrono::steady_clock::now();
     auto timeSinceEpoch = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch());
-    eContext.CurrentFrame()
-        .Stack.EmplaceInteger((int64_t)timeSinceEpoch.count());
+    call.PushInteger((int64_t)timeSinceEpoch.count());
     return Pulsar::RuntimeState::OK;
 }
 
-Pulsar::RuntimeState PulsarBindings::Std::Time::FMicros(Pulsar::ExecutionContext& eContext)
+Pulsar::RuntimeState PulsarBindings::Std::Time::FMicros(Pulsar::NativeCall& call, void* userData)
 {
+    PULSAR_UNUSED(userData);
     // Use the high resolution clock only if it's monotonic
     if constexpr (std::chrono::high_resolution_clock::is_steady) {
         auto time = std::chrono::high_resolution_clock::now();
         auto timeSinceEpoch = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch());
-        eContext.CurrentFrame()
-            .Stack.EmplaceInteger((int64_t)timeSinceEpoch.count());
+        call.PushInteger((int64_t)timeSinceEpoch.count());
     } else {
         auto time = std::chrono::steady_clock::now();
         auto timeSinceEpoch = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch());
-        eContext.CurrentFrame()
-            .Stack.EmplaceInteger((int64_t)timeSinceEpoch.count());
+        call.PushInteger((int64_t)timeSinceEpoch.count());
     }
     return Pulsar::RuntimeState::OK;
 }
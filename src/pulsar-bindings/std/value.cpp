@@ -0,0 +1,25 @@
+#include "pulsar-bindings/std/value.h"
+
+PulsarBindings::Std::Value::Value()
+    : Binding()
+{
+    BindFastNativeFunction({ "value/freeze",  1, 1 }, FFreeze);
+    BindFastNativeFunction({ "value/frozen?", 1, 1 }, FIsFrozen);
+}
+
+Pulsar::RuntimeState PulsarBindings::Std::Value::FFreeze(Pulsar::NativeCall& call, void* userData)
+{
+    PULSAR_UNUSED(userData);
+    // Pushing the result invalidates references to the arguments.
+    Pulsar::Value value = std::move(call.Argument(0));
+    value.Freeze();
+    call.PushResult(std::move(value));
+    return Pulsar::RuntimeState::OK;
+}
+
+Pulsar::RuntimeState PulsarBindings::Std::Value::FIsFrozen(Pulsar::NativeCall& call, void* userData)
+{
+    PULSAR_UNUSED(userData);
+    call.PushInteger(call.Argument(0).IsFrozen() ? 1 : 0);
+    return Pulsar::RuntimeState::OK;
+}
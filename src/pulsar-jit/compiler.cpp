@@ -0,0 +1,44 @@
+#include "pulsar-jit/compiler.h"
+
+#include "pulsar/architecture.h"
+#include "pulsar/platform.h"
+
+#include "pulsar-jit/x64/translator.h"
+
+// Code is only generated for x86-64 on platforms with an executable memory implementation.
+#if defined(PULSAR_ARCHITECTURE_AMD64) && (defined(PULSAR_PLATFORM_WINDOWS) || defined(PULSAR_PLATFORM_UNIX))
+#  define PULSARJIT_X64
+#endif
+
+Pulsar::CompiledFunction::EntryPoint PulsarJit::NativeFunction::GetEntryPoint() const
+{
+    return reinterpret_cast<EntryPoint>(const_cast<void*>(m_Memory.Data()));
+}
+
+bool PulsarJit::Compiler::IsSupported()
+{
+#ifdef PULSARJIT_X64
+    return true;
+#else // PULSARJIT_X64
+    return false;
+#endif // PULSARJIT_X64
+}
+
+Pulsar::CompiledFunction::Ref PulsarJit::Compiler::Compile(const Pulsar::Module& module, const Pulsar::FunctionDefinition& function)
+{
+#ifdef PULSARJIT_X64
+    // A new Translator is created for each function, so no state is shared between threads.
+    X64::Translator translator(module, function);
+    if (!translator.Translate())
+        return nullptr;
+
+    const Pulsar::List<uint8_t>& code = translator.GetCode();
+    ExecutableMemory memory;
+    if (!memory.Load(code.Data(), code.Size()))
+        return nullptr;
+    return Pulsar::SharedRef<NativeFunction>::New(std::move(memory));
+#else // PULSARJIT_X64
+    PULSAR_UNUSED(module, function);
+    return nullptr;
+#endif // PULSARJIT_X64
+}
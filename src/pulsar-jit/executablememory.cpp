@@ -0,0 +1,64 @@
+#include "pulsar-jit/executablememory.h"
+
+#include <cstring> // memcpy
+
+#include "pulsar/platform.h"
+
+#if defined(PULSAR_PLATFORM_WINDOWS)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#elif defined(PULSAR_PLATFORM_UNIX)
+#  include <sys/mman.h>
+#endif // PULSAR_PLATFORM_*
+
+bool PulsarJit::ExecutableMemory::Load(const uint8_t* code, size_t size)
+{
+    Free();
+    if (size == 0)
+        return false;
+
+    // Pages are never writable and executable at the same time.
+#if defined(PULSAR_PLATFORM_WINDOWS)
+    void* data = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!data)
+        return false;
+    std::memcpy(data, code, size);
+    DWORD oldProtect;
+    if (!VirtualProtect(data, size, PAGE_EXECUTE_READ, &oldProtect)) {
+        VirtualFree(data, 0, MEM_RELEASE);
+        return false;
+    }
+    FlushInstructionCache(GetCurrentProcess(), data, size);
+#elif defined(PULSAR_PLATFORM_UNIX)
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED)
+        return false;
+    std::memcpy(data, code, size);
+    if (mprotect(data, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(data, size);
+        return false;
+    }
+#else // PULSAR_PLATFORM_*
+    // Executable memory is not supported.
+    PULSAR_UNUSED(code);
+    void* data = nullptr;
+    return false;
+#endif // PULSAR_PLATFORM_*
+
+    m_Data = data;
+    m_Size = size;
+    return true;
+}
+
+void PulsarJit::ExecutableMemory::Free()
+{
+    if (!m_Data)
+        return;
+#if defined(PULSAR_PLATFORM_WINDOWS)
+    VirtualFree(m_Data, 0, MEM_RELEASE);
+#elif defined(PULSAR_PLATFORM_UNIX)
+    munmap(m_Data, m_Size);
+#endif // PULSAR_PLATFORM_*
+    m_Data = nullptr;
+    m_Size = 0;
+}
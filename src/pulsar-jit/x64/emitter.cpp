@@ -0,0 +1,347 @@
+#include "pulsar-jit/x64/emitter.h"
+
+PulsarJit::X64::Emitter::Label PulsarJit::X64::Emitter::NewLabel()
+{
+    m_LabelPositions.PushBack(UNBOUND);
+    return m_LabelPositions.Size()-1;
+}
+
+void PulsarJit::X64::Emitter::Bind(Label label)
+{
+    PULSAR_ASSERT(!IsBound(label), "Binding an already bound label.");
+    m_LabelPositions[label] = m_Code.Size();
+}
+
+bool PulsarJit::X64::Emitter::Finalize()
+{
+    for (size_t i = 0; i < m_Fixups.Size(); i++) {
+        const Fixup& fixup = m_Fixups[i];
+        if (!IsBound(fixup.Target))
+            return false;
+
+        int64_t base;
+        if (fixup.Base == NO_LABEL) {
+            base = (int64_t)fixup.Position + 4;
+        } else if (IsBound(fixup.Base)) {
+            base = (int64_t)m_LabelPositions[fixup.Base];
+        } else return false;
+
+        int64_t offset = (int64_t)m_LabelPositions[fixup.Target] - base;
+        if (offset < INT32_MIN || offset > INT32_MAX)
+            return false;
+        uint32_t value = (uint32_t)(int32_t)offset;
+        for (size_t j = 0; j < 4; j++)
+            m_Code[fixup.Position+j] = (uint8_t)(value >> (8*j));
+    }
+    m_Fixups.Clear();
+    return true;
+}
+
+void PulsarJit::X64::Emitter::Push(Reg reg)
+{
+    EmitRex(false, 0, 0, (uint8_t)reg);
+    Emit8(0x50 | ((uint8_t)reg & 7));
+}
+
+void PulsarJit::X64::Emitter::Pop(Reg reg)
+{
+    EmitRex(false, 0, 0, (uint8_t)reg);
+    Emit8(0x58 | ((uint8_t)reg & 7));
+}
+
+void PulsarJit::X64::Emitter::Ret()
+{
+    Emit8(0xC3);
+}
+
+void PulsarJit::X64::Emitter::Align(size_t alignment)
+{
+    while (m_Code.Size() % alignment != 0)
+        Emit8(0xCC);
+}
+
+void PulsarJit::X64::Emitter::Mov64(Reg dst, Reg src)
+{
+    EmitRex(true, (uint8_t)src, 0, (uint8_t)dst);
+    Emit8(0x89);
+    EmitModRMReg((uint8_t)src, (uint8_t)dst);
+}
+
+void PulsarJit::X64::Emitter::Mov64(Reg dst, Mem src)
+{
+    EmitRex(true, (uint8_t)dst, 0, (uint8_t)src.Base);
+    Emit8(0x8B);
+    EmitModRM((uint8_t)dst, src);
+}
+
+void PulsarJit::X64::Emitter::Mov64(Mem dst, Reg src)
+{
+    EmitRex(true, (uint8_t)src, 0, (uint8_t)dst.Base);
+    Emit8(0x89);
+    EmitModRM((uint8_t)src, dst);
+}
+
+void PulsarJit::X64::Emitter::Mov64(Reg dst, int64_t imm)
+{
+    EmitRex(true, 0, 0, (uint8_t)dst);
+    Emit8(0xB8 | ((uint8_t)dst & 7));
+    Emit64((uint64_t)imm);
+}
+
+void PulsarJit::X64::Emitter::Mov64(Mem dst, int32_t imm)
+{
+    EmitRex(true, 0, 0, (uint8_t)dst.Base);
+    Emit8(0xC7);
+    EmitModRM(0, dst);
+    Emit32((uint32_t)imm);
+}
+
+void PulsarJit::X64::Emitter::Mov32(Reg dst, Mem src)
+{
+    EmitRex(false, (uint8_t)dst, 0, (uint8_t)src.Base);
+    Emit8(0x8B);
+    EmitModRM((uint8_t)dst, src);
+}
+
+void PulsarJit::X64::Emitter::Mov32(Mem dst, Reg src)
+{
+    EmitRex(false, (uint8_t)src, 0, (uint8_t)dst.Base);
+    Emit8(0x89);
+    EmitModRM((uint8_t)src, dst);
+}
+
+void PulsarJit::X64::Emitter::Mov32(Mem dst, int32_t imm)
+{
+    EmitRex(false, 0, 0, (uint8_t)dst.Base);
+    Emit8(0xC7);
+    EmitModRM(0, dst);
+    Emit32((uint32_t)imm);
+}
+
+void PulsarJit::X64::Emitter::Alu64(AluOp op, Reg dst, Reg src)
+{
+    // op r/m64, r64
+    EmitRex(true, (uint8_t)src, 0, (uint8_t)dst);
+    Emit8(((uint8_t)op << 3) | 0x01);
+    EmitModRMReg((uint8_t)src, (uint8_t)dst);
+}
+
+void PulsarJit::X64::Emitter::Alu64(AluOp op, Reg dst, Mem src)
+{
+    // op r64, r/m64
+    EmitRex(true, (uint8_t)dst, 0, (uint8_t)src.Base);
+    Emit8(((uint8_t)op << 3) | 0x03);
+    EmitModRM((uint8_t)dst, src);
+}
+
+void PulsarJit::X64::Emitter::Alu64(AluOp op, Mem dst, int32_t imm)
+{
+    EmitRex(true, 0, 0, (uint8_t)dst.Base);
+    Emit8(0x81);
+    EmitModRM((uint8_t)op, dst);
+    Emit32((uint32_t)imm);
+}
+
+void PulsarJit::X64::Emitter::Alu32(AluOp op, Reg dst, Mem src)
+{
+    EmitRex(false, (uint8_t)dst, 0, (uint8_t)src.Base);
+    Emit8(((uint8_t)op << 3) | 0x03);
+    EmitModRM((uint8_t)dst, src);
+}
+
+void PulsarJit::X64::Emitter::Alu32(AluOp op, Reg dst, int32_t imm)
+{
+    EmitRex(false, 0, 0, (uint8_t)dst);
+    Emit8(0x81);
+    EmitModRMReg((uint8_t)op, (uint8_t)dst);
+    Emit32((uint32_t)imm);
+}
+
+void PulsarJit::X64::Emitter::Alu32(AluOp op, Mem dst, int32_t imm)
+{
+    EmitRex(false, 0, 0, (uint8_t)dst.Base);
+    Emit8(0x81);
+    EmitModRM((uint8_t)op, dst);
+    Emit32((uint32_t)imm);
+}
+
+void PulsarJit::X64::Emitter::Cmp8(Mem dst, int8_t imm)
+{
+    EmitRex(false, 0, 0, (uint8_t)dst.Base);
+    Emit8(0x80);
+    EmitModRM((uint8_t)AluOp::Cmp, dst);
+    Emit8((uint8_t)imm);
+}
+
+void PulsarJit::X64::Emitter::Imul64(Reg dst, Mem src)
+{
+    EmitRex(true, (uint8_t)dst, 0, (uint8_t)src.Base);
+    Emit8(0x0F);
+    Emit8(0xAF);
+    EmitModRM((uint8_t)dst, src);
+}
+
+void PulsarJit::X64::Emitter::Not64(Mem dst)
+{
+    EmitRex(true, 0, 0, (uint8_t)dst.Base);
+    Emit8(0xF7);
+    EmitModRM(2, dst);
+}
+
+void PulsarJit::X64::Emitter::Test64(Reg a, Reg b)
+{
+    EmitRex(true, (uint8_t)b, 0, (uint8_t)a);
+    Emit8(0x85);
+    EmitModRMReg((uint8_t)b, (uint8_t)a);
+}
+
+void PulsarJit::X64::Emitter::SetCC(Condition cond, Reg dst)
+{
+    // SPL, BPL, SIL and DIL require a REX prefix.
+    if ((uint8_t)dst >= 4)
+        Emit8(0x40 | (((uint8_t)dst >> 3) & 1));
+    Emit8(0x0F);
+    Emit8(0x90 | (uint8_t)cond);
+    EmitModRMReg(0, (uint8_t)dst);
+}
+
+void PulsarJit::X64::Emitter::Movzx32(Reg dst, Reg src)
+{
+    if ((uint8_t)src >= 4 || (uint8_t)dst >= 8)
+        Emit8(0x40 | ((((uint8_t)dst >> 3) & 1) << 2) | (((uint8_t)src >> 3) & 1));
+    Emit8(0x0F);
+    Emit8(0xB6);
+    EmitModRMReg((uint8_t)dst, (uint8_t)src);
+}
+
+void PulsarJit::X64::Emitter::Movsd(XmmReg dst, Mem src)
+{
+    Emit8(0xF2);
+    EmitRex(false, (uint8_t)dst, 0, (uint8_t)src.Base);
+    Emit8(0x0F);
+    Emit8(0x10);
+    EmitModRM((uint8_t)dst, src);
+}
+
+void PulsarJit::X64::Emitter::Movsd(Mem dst, XmmReg src)
+{
+    Emit8(0xF2);
+    EmitRex(false, (uint8_t)src, 0, (uint8_t)dst.Base);
+    Emit8(0x0F);
+    Emit8(0x11);
+    EmitModRM((uint8_t)src, dst);
+}
+
+void PulsarJit::X64::Emitter::Sse(SseOp op, XmmReg dst, Mem src)
+{
+    Emit8(0xF2);
+    EmitRex(false, (uint8_t)dst, 0, (uint8_t)src.Base);
+    Emit8(0x0F);
+    Emit8((uint8_t)op);
+    EmitModRM((uint8_t)dst, src);
+}
+
+void PulsarJit::X64::Emitter::Ucomisd(XmmReg a, XmmReg b)
+{
+    Emit8(0x66);
+    Emit8(0x0F);
+    Emit8(0x2E);
+    EmitModRMReg((uint8_t)a, (uint8_t)b);
+}
+
+void PulsarJit::X64::Emitter::Xorpd(XmmReg dst, XmmReg src)
+{
+    Emit8(0x66);
+    Emit8(0x0F);
+    Emit8(0x57);
+    EmitModRMReg((uint8_t)dst, (uint8_t)src);
+}
+
+void PulsarJit::X64::Emitter::Jmp(Label target)
+{
+    Emit8(0xE9);
+    EmitFixup(target, NO_LABEL);
+}
+
+void PulsarJit::X64::Emitter::Jmp(Reg target)
+{
+    EmitRex(false, 0, 0, (uint8_t)target);
+    Emit8(0xFF);
+    EmitModRMReg(4, (uint8_t)target);
+}
+
+void PulsarJit::X64::Emitter::Jcc(Condition cond, Label target)
+{
+    Emit8(0x0F);
+    Emit8(0x80 | (uint8_t)cond);
+    EmitFixup(target, NO_LABEL);
+}
+
+void PulsarJit::X64::Emitter::LeaRip(Reg dst, Label target)
+{
+    EmitRex(true, (uint8_t)dst, 0, 0);
+    Emit8(0x8D);
+    // mod = 00, rm = 101 is [RIP + disp32]
+    Emit8((uint8_t)((((uint8_t)dst & 7) << 3) | 0x05));
+    EmitFixup(target, NO_LABEL);
+}
+
+void PulsarJit::X64::Emitter::Movsxd(Reg dst, Reg base, Reg index)
+{
+    PULSAR_ASSERT(((uint8_t)base & 7) != 5, "Base of Movsxd cannot be RBP or R13.");
+    PULSAR_ASSERT(index != Reg::RSP, "Index of Movsxd cannot be RSP.");
+    EmitRex(true, (uint8_t)dst, (uint8_t)index, (uint8_t)base);
+    Emit8(0x63);
+    // mod = 00, rm = 100 (SIB), scale = 4
+    Emit8((uint8_t)((((uint8_t)dst & 7) << 3) | 0x04));
+    Emit8((uint8_t)(0x80 | (((uint8_t)index & 7) << 3) | ((uint8_t)base & 7)));
+}
+
+void PulsarJit::X64::Emitter::EmitLabelOffset(Label target, Label base)
+{
+    EmitFixup(target, base);
+}
+
+void PulsarJit::X64::Emitter::Emit32(uint32_t value)
+{
+    for (size_t i = 0; i < 4; i++)
+        Emit8((uint8_t)(value >> (8*i)));
+}
+
+void PulsarJit::X64::Emitter::Emit64(uint64_t value)
+{
+    for (size_t i = 0; i < 8; i++)
+        Emit8((uint8_t)(value >> (8*i)));
+}
+
+void PulsarJit::X64::Emitter::EmitRex(bool wide, uint8_t reg, uint8_t index, uint8_t base)
+{
+    uint8_t rex = 0x40
+        | (wide ? 0x08 : 0)
+        | (((reg   >> 3) & 1) << 2)
+        | (((index >> 3) & 1) << 1)
+        | ((base   >> 3) & 1);
+    if (rex != 0x40)
+        Emit8(rex);
+}
+
+void PulsarJit::X64::Emitter::EmitModRM(uint8_t reg, Mem mem)
+{
+    // mod = 10 is [base + disp32]
+    Emit8((uint8_t)(0x80 | ((reg & 7) << 3) | ((uint8_t)mem.Base & 7)));
+    // RSP and R12 can only be encoded as base through a SIB byte.
+    if (((uint8_t)mem.Base & 7) == 4)
+        Emit8(0x24);
+    Emit32((uint32_t)mem.Disp);
+}
+
+void PulsarJit::X64::Emitter::EmitModRMReg(uint8_t reg, uint8_t rm)
+{
+    Emit8((uint8_t)(0xC0 | ((reg & 7) << 3) | (rm & 7)));
+}
+
+void PulsarJit::X64::Emitter::EmitFixup(Label target, Label base)
+{
+    m_Fixups.PushBack({ m_Code.Size(), target, base });
+    Emit32(0);
+}
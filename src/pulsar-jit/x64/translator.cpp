@@ -0,0 +1,642 @@
+#include "pulsar-jit/x64/translator.h"
+
+#include <algorithm> // std::min
+#include <cstddef> // offsetof
+#include <cstring> // memcpy
+
+#include "pulsar/platform.h"
+
+using PulsarJit::X64::Reg;
+using PulsarJit::X64::XmmReg;
+using PulsarJit::X64::Mem;
+using PulsarJit::X64::AluOp;
+using PulsarJit::X64::SseOp;
+using PulsarJit::X64::Condition;
+using Pulsar::InstructionCode;
+using Pulsar::ValueType;
+
+// These registers are callee-saved on both the System V and the Windows x64 ABIs.
+static constexpr Reg REG_STATE  = Reg::RBX;
+static constexpr Reg REG_LOCALS = Reg::R12;
+static constexpr Reg REG_STACK  = Reg::R13;
+
+#ifdef PULSAR_PLATFORM_WINDOWS
+static constexpr Reg REG_ARG0 = Reg::RCX;
+#else // PULSAR_PLATFORM_WINDOWS
+static constexpr Reg REG_ARG0 = Reg::RDI;
+#endif // PULSAR_PLATFORM_WINDOWS
+
+static constexpr Mem STATE_STACK_SIZE        { REG_STATE, (int32_t)offsetof(Pulsar::CompiledFrameState, StackSize) };
+static constexpr Mem STATE_INSTRUCTION_INDEX { REG_STATE, (int32_t)offsetof(Pulsar::CompiledFrameState, InstructionIndex) };
+
+static_assert(sizeof(Pulsar::ValueType) == sizeof(int32_t));
+// Trivial Values are the ones with a type <= MAX_TRIVIAL_TYPE.
+static constexpr int32_t MAX_TRIVIAL_TYPE = (int32_t)ValueType::NativeFunctionReference;
+static_assert((int32_t)ValueType::Void == 0 && (int32_t)ValueType::Integer == 1 && (int32_t)ValueType::Double == 2);
+static_assert((int32_t)ValueType::FunctionReference == 3 && (int32_t)ValueType::NativeFunctionReference == 4);
+static_assert((int32_t)ValueType::List > MAX_TRIVIAL_TYPE && (int32_t)ValueType::String > MAX_TRIVIAL_TYPE);
+static_assert((int32_t)ValueType::Custom > MAX_TRIVIAL_TYPE);
+
+// Condition met by (value <=> 0) for each jump.
+static Condition GetIntegerCondition(InstructionCode jumpCode)
+{
+    switch (jumpCode) {
+    case InstructionCode::JZ:
+        return Condition::E;
+    case InstructionCode::JNZ:
+        return Condition::NE;
+    case InstructionCode::JGZ:
+        return Condition::G;
+    case InstructionCode::JGEZ:
+        return Condition::GE;
+    case InstructionCode::JLZ:
+        return Condition::L;
+    case InstructionCode::JLEZ:
+    default:
+        return Condition::LE;
+    }
+}
+
+// Jumps to `target` if XMM0 satisfies `jumpCode`, XMM1 must be 0.0.
+// NaN only satisfies JNZ, like Pulsar::ShouldJump.
+static void EmitDoubleBranch(PulsarJit::X64::Emitter& emitter, InstructionCode jumpCode, PulsarJit::X64::Emitter::Label target)
+{
+    switch (jumpCode) {
+    case InstructionCode::JZ: {
+        auto notTaken = emitter.NewLabel();
+        emitter.Ucomisd(XmmReg::XMM0, XmmReg::XMM1);
+        emitter.Jcc(Condition::P, notTaken);
+        emitter.Jcc(Condition::E, target);
+        emitter.Bind(notTaken);
+    } break;
+    case InstructionCode::JNZ:
+        emitter.Ucomisd(XmmReg::XMM0, XmmReg::XMM1);
+        emitter.Jcc(Condition::P, target);
+        emitter.Jcc(Condition::NE, target);
+        break;
+    case InstructionCode::JGZ:
+        emitter.Ucomisd(XmmReg::XMM0, XmmReg::XMM1);
+        emitter.Jcc(Condition::A, target);
+        break;
+    case InstructionCode::JGEZ:
+        emitter.Ucomisd(XmmReg::XMM0, XmmReg::XMM1);
+        emitter.Jcc(Condition::AE, target);
+        break;
+    case InstructionCode::JLZ:
+        emitter.Ucomisd(XmmReg::XMM1, XmmReg::XMM0);
+        emitter.Jcc(Condition::A, target);
+        break;
+    case InstructionCode::JLEZ:
+        emitter.Ucomisd(XmmReg::XMM1, XmmReg::XMM0);
+        emitter.Jcc(Condition::AE, target);
+        break;
+    default:
+        emitter.Jmp(target);
+        break;
+    }
+}
+
+bool PulsarJit::X64::Translator::Translate()
+{
+    const Pulsar::List<Pulsar::Instruction>& code = m_Function.Code;
+    if (code.IsEmpty() || code.Size() >= (size_t)INT32_MAX)
+        return false;
+    if (!m_Function.Verified || m_Function.MaxStackSize == 0)
+        return false;
+    // Values are addressed with 32-bit displacements.
+    constexpr size_t MAX_VALUES = (size_t)INT32_MAX / sizeof(Pulsar::Value) - 1;
+    if (m_Function.LocalsCount > MAX_VALUES || m_Function.MaxStackSize > MAX_VALUES)
+        return false;
+
+    Pulsar::Verifier verifier;
+    if (!verifier.ComputeStackDepths(m_Module, m_Function, m_Depths))
+        return false;
+
+    m_TypeOffset    = (int32_t)Pulsar::Value::GetTypeOffset();
+    m_PayloadOffset = (int32_t)Pulsar::Value::GetPayloadOffset();
+
+    m_ReturnLabel = m_Emitter.NewLabel();
+    Label tableLabel = m_Emitter.NewLabel();
+    m_InstructionLabels.Clear();
+    m_ExitLabels.Clear();
+    for (size_t i = 0; i < code.Size(); i++)
+        m_InstructionLabels.PushBack(m_Emitter.NewLabel());
+    m_ExitLabels.Resize(code.Size()+1, NO_LABEL);
+
+    // Prologue, jumps to the entry of InstructionIndex.
+    m_Emitter.Push(REG_STATE);
+    m_Emitter.Push(REG_LOCALS);
+    m_Emitter.Push(REG_STACK);
+    m_Emitter.Mov64(REG_STATE, REG_ARG0);
+    m_Emitter.Mov64(REG_LOCALS, Mem{ REG_STATE, (int32_t)offsetof(Pulsar::CompiledFrameState, Locals) });
+    m_Emitter.Mov64(REG_STACK,  Mem{ REG_STATE, (int32_t)offsetof(Pulsar::CompiledFrameState, Stack) });
+    m_Emitter.Alu64(AluOp::Cmp, STATE_INSTRUCTION_INDEX, (int32_t)code.Size());
+    m_Emitter.Jcc(Condition::AE, m_ReturnLabel);
+    m_Emitter.Mov64(Reg::RAX, STATE_INSTRUCTION_INDEX);
+    m_Emitter.LeaRip(Reg::RCX, tableLabel);
+    m_Emitter.Movsxd(Reg::RAX, Reg::RCX, Reg::RAX);
+    m_Emitter.Alu64(AluOp::Add, Reg::RAX, Reg::RCX);
+    m_Emitter.Jmp(Reg::RAX);
+
+    // Epilogue
+    m_Emitter.Bind(m_ReturnLabel);
+    m_Emitter.Pop(REG_STACK);
+    m_Emitter.Pop(REG_LOCALS);
+    m_Emitter.Pop(REG_STATE);
+    m_Emitter.Ret();
+
+    // Entries check that the stack has the expected depth.
+    Pulsar::List<Label> entryLabels;
+    for (size_t i = 0; i < code.Size(); i++) {
+        if (m_Depths[i] == UNKNOWN_DEPTH) {
+            entryLabels.PushBack(m_ReturnLabel);
+            continue;
+        }
+        Label entry = m_Emitter.NewLabel();
+        m_Emitter.Bind(entry);
+        m_Emitter.Alu64(AluOp::Cmp, STATE_STACK_SIZE, (int32_t)m_Depths[i]);
+        m_Emitter.Jcc(Condition::NE, m_ReturnLabel);
+        m_Emitter.Jmp(m_InstructionLabels[i]);
+        entryLabels.PushBack(entry);
+    }
+
+    for (size_t i = 0; i < code.Size(); i++) {
+        // Instructions with an unknown depth are never jumped to.
+        m_Emitter.Bind(m_InstructionLabels[i]);
+        if (m_Depths[i] == UNKNOWN_DEPTH)
+            continue;
+        if (!TranslateInstruction(i))
+            m_Emitter.Jmp(GetExitLabel(i));
+    }
+
+    for (size_t i = 0; i < m_ExitLabels.Size(); i++) {
+        if (m_ExitLabels[i] == NO_LABEL)
+            continue;
+        m_Emitter.Bind(m_ExitLabels[i]);
+        EmitExit(i, m_Depths[i]);
+    }
+
+    m_Emitter.Align(4);
+    m_Emitter.Bind(tableLabel);
+    for (size_t i = 0; i < entryLabels.Size(); i++)
+        m_Emitter.EmitLabelOffset(entryLabels[i], tableLabel);
+
+    return m_Emitter.Finalize();
+}
+
+bool PulsarJit::X64::Translator::TranslateInstruction(size_t instrIdx)
+{
+    const Pulsar::Instruction& instr = m_Function.Code[instrIdx];
+    size_t depth = m_Depths[instrIdx];
+    size_t next  = instrIdx+1;
+
+    switch (instr.Code) {
+    case InstructionCode::PushInt:
+    case InstructionCode::PushDbl:
+    case InstructionCode::PushFunctionReference:
+    case InstructionCode::PushNativeFunctionReference:
+    case InstructionCode::PushConst: {
+        if (!CanTransfer(next, depth+1))
+            return false;
+
+        ValueType type;
+        int64_t payload = instr.Arg0;
+        if (instr.Code == InstructionCode::PushConst) {
+            const Pulsar::Value& constant = m_Module.Constants[(size_t)instr.Arg0];
+            type = constant.Type();
+            if (type == ValueType::Integer) {
+                payload = constant.AsInteger();
+            } else if (type == ValueType::Double) {
+                double value = constant.AsDouble();
+                std::memcpy(&payload, &value, sizeof(payload));
+            } else return false;
+        } else if (instr.Code == InstructionCode::PushInt) {
+            type = ValueType::Integer;
+        } else if (instr.Code == InstructionCode::PushDbl) {
+            type = ValueType::Double;
+        } else if (instr.Code == InstructionCode::PushFunctionReference) {
+            type = ValueType::FunctionReference;
+        } else type = ValueType::NativeFunctionReference;
+
+        Mem slot = StackSlot(depth);
+        EmitSetType(slot, type);
+        m_Emitter.Mov64(Reg::RAX, payload);
+        m_Emitter.Mov64(PayloadOf(slot), Reg::RAX);
+        EmitTransfer(instrIdx, next, depth+1);
+    } return true;
+    case InstructionCode::PushLocal:
+    case InstructionCode::MoveLocal: {
+        if (!CanTransfer(next, depth+1))
+            return false;
+        Mem local = LocalSlot((size_t)instr.Arg0);
+        EmitTrivialGuard(local, GetExitLabel(instrIdx));
+        EmitCopy(StackSlot(depth), local);
+        if (instr.Code == InstructionCode::MoveLocal) {
+            // Moved Values are reset to Void.
+            EmitSetType(local, ValueType::Void);
+            m_Emitter.Mov64(PayloadOf(local), 0);
+        }
+        EmitTransfer(instrIdx, next, depth+1);
+    } return true;
+    case InstructionCode::PushLocal2: {
+        if (!CanTransfer(next, depth+2))
+            return false;
+        Mem first  = LocalSlot(Pulsar::UnpackFirstArg(instr.Arg0));
+        Mem second = LocalSlot(Pulsar::UnpackSecondArg(instr.Arg0));
+        EmitTrivialGuard(first,  GetExitLabel(instrIdx));
+        EmitTrivialGuard(second, GetExitLabel(instrIdx));
+        EmitCopy(StackSlot(depth),   first);
+        EmitCopy(StackSlot(depth+1), second);
+        EmitTransfer(instrIdx, next, depth+2);
+    } return true;
+    case InstructionCode::PopIntoLocal:
+    case InstructionCode::CopyIntoLocal: {
+        size_t depthAfter = instr.Code == InstructionCode::PopIntoLocal ? depth-1 : depth;
+        if (depth < 1 || !CanTransfer(next, depthAfter))
+            return false;
+        Mem local = LocalSlot((size_t)instr.Arg0);
+        Mem top   = StackSlot(depth-1);
+        // The old value of the local is overwritten without being destroyed.
+        EmitTrivialGuard(local, GetExitLabel(instrIdx));
+        EmitTrivialGuard(top,   GetExitLabel(instrIdx));
+        EmitCopy(local, top);
+        EmitTransfer(instrIdx, next, depthAfter);
+    } return true;
+    case InstructionCode::Pop: {
+        size_t popCount = (size_t)(instr.Arg0 > 0 ? instr.Arg0 : 1);
+        if (depth < popCount || !CanTransfer(next, depth-popCount))
+            return false;
+        for (size_t i = 1; i <= popCount; i++)
+            EmitTrivialGuard(StackSlot(depth-i), GetExitLabel(instrIdx));
+        EmitTransfer(instrIdx, next, depth-popCount);
+    } return true;
+    case InstructionCode::Dup: {
+        size_t dupCount = (size_t)(instr.Arg0 > 0 ? instr.Arg0 : 1);
+        if (depth < 1 || !CanTransfer(next, depth+dupCount))
+            return false;
+        Mem top = StackSlot(depth-1);
+        EmitTrivialGuard(top, GetExitLabel(instrIdx));
+        for (size_t i = 0; i < dupCount; i++)
+            EmitCopy(StackSlot(depth+i), top);
+        EmitTransfer(instrIdx, next, depth+dupCount);
+    } return true;
+    case InstructionCode::Swap: {
+        if (depth < 2 || !CanTransfer(next, depth))
+            return false;
+        Mem a = StackSlot(depth-2);
+        Mem b = StackSlot(depth-1);
+        EmitTrivialGuard(a, GetExitLabel(instrIdx));
+        EmitTrivialGuard(b, GetExitLabel(instrIdx));
+        m_Emitter.Mov32(Reg::RAX, TypeOf(a));
+        m_Emitter.Mov32(Reg::RCX, TypeOf(b));
+        m_Emitter.Mov64(Reg::RDX, PayloadOf(a));
+        m_Emitter.Mov64(Reg::R8,  PayloadOf(b));
+        m_Emitter.Mov32(TypeOf(a), Reg::RCX);
+        m_Emitter.Mov32(TypeOf(b), Reg::RAX);
+        m_Emitter.Mov64(PayloadOf(a), Reg::R8);
+        m_Emitter.Mov64(PayloadOf(b), Reg::RDX);
+        EmitTransfer(instrIdx, next, depth);
+    } return true;
+    case InstructionCode::DynSum:
+    case InstructionCode::DynSub:
+    case InstructionCode::DynMul:
+    case InstructionCode::Compare: {
+        if (depth < 2 || !CanTransfer(next, depth-1))
+            return false;
+        Label exitLabel = GetExitLabel(instrIdx);
+        Label doubleLabel = m_Emitter.NewLabel();
+        Label doneLabel = m_Emitter.NewLabel();
+        Mem a = StackSlot(depth-2);
+        Mem b = StackSlot(depth-1);
+
+        // Both operands must be either Integers or Doubles.
+        m_Emitter.Mov32(Reg::RAX, TypeOf(a));
+        m_Emitter.Alu32(AluOp::Cmp, Reg::RAX, TypeOf(b));
+        m_Emitter.Jcc(Condition::NE, exitLabel);
+        m_Emitter.Alu32(AluOp::Cmp, Reg::RAX, (int32_t)ValueType::Integer);
+        m_Emitter.Jcc(Condition::NE, doubleLabel);
+
+        m_Emitter.Mov64(Reg::RCX, PayloadOf(a));
+        if (instr.Code == InstructionCode::DynSum) {
+            m_Emitter.Alu64(AluOp::Add, Reg::RCX, PayloadOf(b));
+        } else if (instr.Code == InstructionCode::DynMul) {
+            m_Emitter.Imul64(Reg::RCX, PayloadOf(b));
+        } else m_Emitter.Alu64(AluOp::Sub, Reg::RCX, PayloadOf(b));
+        m_Emitter.Mov64(PayloadOf(a), Reg::RCX);
+        m_Emitter.Jmp(doneLabel);
+
+        m_Emitter.Bind(doubleLabel);
+        m_Emitter.Alu32(AluOp::Cmp, Reg::RAX, (int32_t)ValueType::Double);
+        m_Emitter.Jcc(Condition::NE, exitLabel);
+        SseOp op = instr.Code == InstructionCode::DynSum ? SseOp::Add
+            : instr.Code == InstructionCode::DynMul ? SseOp::Mul : SseOp::Sub;
+        m_Emitter.Movsd(XmmReg::XMM0, PayloadOf(a));
+        m_Emitter.Sse(op, XmmReg::XMM0, PayloadOf(b));
+        m_Emitter.Movsd(PayloadOf(a), XmmReg::XMM0);
+
+        m_Emitter.Bind(doneLabel);
+        EmitTransfer(instrIdx, next, depth-1);
+    } return true;
+    case InstructionCode::DynDiv: {
+        // Integer division is left to the ExecutionContext.
+        if (depth < 2 || !CanTransfer(next, depth-1))
+            return false;
+        Mem a = StackSlot(depth-2);
+        Mem b = StackSlot(depth-1);
+        EmitTypeGuard(a, ValueType::Double, GetExitLabel(instrIdx));
+        EmitTypeGuard(b, ValueType::Double, GetExitLabel(instrIdx));
+        m_Emitter.Movsd(XmmReg::XMM0, PayloadOf(a));
+        m_Emitter.Sse(SseOp::Div, XmmReg::XMM0, PayloadOf(b));
+        m_Emitter.Movsd(PayloadOf(a), XmmReg::XMM0);
+        EmitTransfer(instrIdx, next, depth-1);
+    } return true;
+    case InstructionCode::BitAnd:
+    case InstructionCode::BitOr:
+    case InstructionCode::BitXor:
+    case InstructionCode::Equals: {
+        // Equals is only handled for Integers.
+        if (depth < 2 || !CanTransfer(next, depth-1))
+            return false;
+        Mem a = StackSlot(depth-2);
+        Mem b = StackSlot(depth-1);
+        EmitTypeGuard(a, ValueType::Integer, GetExitLabel(instrIdx));
+        EmitTypeGuard(b, ValueType::Integer, GetExitLabel(instrIdx));
+        m_Emitter.Mov64(Reg::RCX, PayloadOf(a));
+        if (instr.Code == InstructionCode::Equals) {
+            m_Emitter.Alu64(AluOp::Cmp, Reg::RCX, PayloadOf(b));
+            m_Emitter.SetCC(Condition::E, Reg::RAX);
+            m_Emitter.Movzx32(Reg::RCX, Reg::RAX);
+        } else {
+            AluOp op = instr.Code == InstructionCode::BitAnd ? AluOp::And
+                : instr.Code == InstructionCode::BitOr ? AluOp::Or : AluOp::Xor;
+            m_Emitter.Alu64(op, Reg::RCX, PayloadOf(b));
+        }
+        m_Emitter.Mov64(PayloadOf(a), Reg::RCX);
+        EmitTransfer(instrIdx, next, depth-1);
+    } return true;
+    case InstructionCode::BitNot:
+    case InstructionCode::Floor:
+    case InstructionCode::Ceil: {
+        // Floor and Ceil don't change Integers, Doubles are left to the ExecutionContext.
+        if (depth < 1 || !CanTransfer(next, depth))
+            return false;
+        Mem top = StackSlot(depth-1);
+        EmitTypeGuard(top, ValueType::Integer, GetExitLabel(instrIdx));
+        if (instr.Code == InstructionCode::BitNot)
+            m_Emitter.Not64(PayloadOf(top));
+        EmitTransfer(instrIdx, next, depth);
+    } return true;
+    case InstructionCode::IncLocal:
+    case InstructionCode::DecLocal: {
+        if (!CanTransfer(next, depth))
+            return false;
+        Mem local = LocalSlot((size_t)instr.Arg0);
+        EmitTypeGuard(local, ValueType::Integer, GetExitLabel(instrIdx));
+        AluOp op = instr.Code == InstructionCode::IncLocal ? AluOp::Add : AluOp::Sub;
+        m_Emitter.Alu64(op, PayloadOf(local), 1);
+        EmitTransfer(instrIdx, next, depth);
+    } return true;
+    case InstructionCode::IsVoid:
+    case InstructionCode::IsInteger:
+    case InstructionCode::IsDouble:
+    case InstructionCode::IsFunctionReference:
+    case InstructionCode::IsNativeFunctionReference:
+    case InstructionCode::IsList:
+    case InstructionCode::IsString:
+    case InstructionCode::IsCustom:
+    case InstructionCode::IsNumber:
+    case InstructionCode::IsAnyFunctionReference: {
+        if (depth < 1 || !CanTransfer(next, depth+1))
+            return false;
+        Mem top = StackSlot(depth-1);
+        if (instr.Code == InstructionCode::IsNumber || instr.Code == InstructionCode::IsAnyFunctionReference) {
+            // Both are pairs of consecutive types.
+            ValueType first = instr.Code == InstructionCode::IsNumber ? ValueType::Integer : ValueType::FunctionReference;
+            m_Emitter.Mov32(Reg::RAX, TypeOf(top));
+            m_Emitter.Alu32(AluOp::Sub, Reg::RAX, (int32_t)first);
+            m_Emitter.Alu32(AluOp::Cmp, Reg::RAX, 1);
+            m_Emitter.SetCC(Condition::BE, Reg::RAX);
+        } else {
+            ValueType type = ValueType::Void;
+            switch (instr.Code) {
+            case InstructionCode::IsInteger: type = ValueType::Integer; break;
+            case InstructionCode::IsDouble:  type = ValueType::Double; break;
+            case InstructionCode::IsFunctionReference:       type = ValueType::FunctionReference; break;
+            case InstructionCode::IsNativeFunctionReference: type = ValueType::NativeFunctionReference; break;
+            case InstructionCode::IsList:   type = ValueType::List; break;
+            case InstructionCode::IsString: type = ValueType::String; break;
+            case InstructionCode::IsCustom: type = ValueType::Custom; break;
+            default: break;
+            }
+            m_Emitter.Alu32(AluOp::Cmp, TypeOf(top), (int32_t)type);
+            m_Emitter.SetCC(Condition::E, Reg::RAX);
+        }
+        m_Emitter.Movzx32(Reg::RAX, Reg::RAX);
+        Mem result = StackSlot(depth);
+        EmitSetType(result, ValueType::Integer);
+        m_Emitter.Mov64(PayloadOf(result), Reg::RAX);
+        EmitTransfer(instrIdx, next, depth+1);
+    } return true;
+    case InstructionCode::Return:
+        if (depth < m_Function.Returns)
+            return false;
+        EmitExit(m_Function.Code.Size(), depth);
+        return true;
+    case InstructionCode::J: {
+        size_t target = (size_t)((int64_t)instrIdx + instr.Arg0);
+        if (!CanTransfer(target, depth))
+            return false;
+        EmitTransfer(instrIdx, target, depth);
+    } return true;
+    case InstructionCode::JZ:
+    case InstructionCode::JNZ:
+    case InstructionCode::JGZ:
+    case InstructionCode::JGEZ:
+    case InstructionCode::JLZ:
+    case InstructionCode::JLEZ:
+    case InstructionCode::DupJZ:
+    case InstructionCode::CompareJGZ:
+    case InstructionCode::CompareJGEZ:
+    case InstructionCode::CompareJLZ:
+    case InstructionCode::CompareJLEZ:
+    case InstructionCode::EqualsJZ:
+    case InstructionCode::EqualsJNZ:
+        return TranslateConditionalJump(instrIdx);
+    default:
+        return false;
+    }
+}
+
+bool PulsarJit::X64::Translator::TranslateConditionalJump(size_t instrIdx)
+{
+    const Pulsar::Instruction& instr = m_Function.Code[instrIdx];
+    InstructionCode jumpCode = Pulsar::GetFusedJump(instr.Code);
+    size_t depth  = m_Depths[instrIdx];
+    size_t target = (size_t)((int64_t)instrIdx + instr.Arg0);
+    size_t next   = instrIdx+1;
+
+    size_t pops = 1;
+    if (instr.Code == InstructionCode::DupJZ) {
+        pops = 0;
+    } else if (jumpCode != instr.Code) {
+        pops = 2;
+    }
+    if (depth < 1 || depth < pops)
+        return false;
+    size_t depthAfter = depth-pops;
+    if (!CanTransfer(target, depthAfter) || !CanTransfer(next, depthAfter))
+        return false;
+
+    Label exitLabel     = GetExitLabel(instrIdx);
+    Label takenLabel    = m_Emitter.NewLabel();
+    Label notTakenLabel = m_Emitter.NewLabel();
+    Label doubleLabel   = m_Emitter.NewLabel();
+
+    if (instr.Code == InstructionCode::DupJZ) {
+        Mem top = StackSlot(depth-1);
+        EmitTypeGuard(top, ValueType::Integer, exitLabel);
+        m_Emitter.Alu64(AluOp::Cmp, PayloadOf(top), 0);
+        m_Emitter.Jcc(Condition::E, takenLabel);
+        m_Emitter.Jmp(notTakenLabel);
+    } else if (instr.Code == InstructionCode::EqualsJZ || instr.Code == InstructionCode::EqualsJNZ) {
+        // Only Integers are compared.
+        Mem a = StackSlot(depth-2);
+        Mem b = StackSlot(depth-1);
+        EmitTypeGuard(a, ValueType::Integer, exitLabel);
+        EmitTypeGuard(b, ValueType::Integer, exitLabel);
+        m_Emitter.Mov64(Reg::RCX, PayloadOf(a));
+        m_Emitter.Alu64(AluOp::Cmp, Reg::RCX, PayloadOf(b));
+        // EqualsJZ jumps if the values are not equal.
+        m_Emitter.Jcc(instr.Code == InstructionCode::EqualsJZ ? Condition::NE : Condition::E, takenLabel);
+        m_Emitter.Jmp(notTakenLabel);
+    } else if (pops == 2) {
+        // Compare then jump, both operands must be either Integers or Doubles.
+        Mem a = StackSlot(depth-2);
+        Mem b = StackSlot(depth-1);
+        m_Emitter.Mov32(Reg::RAX, TypeOf(a));
+        m_Emitter.Alu32(AluOp::Cmp, Reg::RAX, TypeOf(b));
+        m_Emitter.Jcc(Condition::NE, exitLabel);
+        m_Emitter.Alu32(AluOp::Cmp, Reg::RAX, (int32_t)ValueType::Integer);
+        m_Emitter.Jcc(Condition::NE, doubleLabel);
+        // Like the ExecutionContext, the sign of the (wrapping) difference is checked.
+        m_Emitter.Mov64(Reg::RCX, PayloadOf(a));
+        m_Emitter.Alu64(AluOp::Sub, Reg::RCX, PayloadOf(b));
+        m_Emitter.Test64(Reg::RCX, Reg::RCX);
+        m_Emitter.Jcc(GetIntegerCondition(jumpCode), takenLabel);
+        m_Emitter.Jmp(notTakenLabel);
+
+        m_Emitter.Bind(doubleLabel);
+        m_Emitter.Alu32(AluOp::Cmp, Reg::RAX, (int32_t)ValueType::Double);
+        m_Emitter.Jcc(Condition::NE, exitLabel);
+        m_Emitter.Movsd(XmmReg::XMM0, PayloadOf(a));
+        m_Emitter.Sse(SseOp::Sub, XmmReg::XMM0, PayloadOf(b));
+        m_Emitter.Xorpd(XmmReg::XMM1, XmmReg::XMM1);
+        EmitDoubleBranch(m_Emitter, jumpCode, takenLabel);
+        m_Emitter.Jmp(notTakenLabel);
+    } else {
+        Mem top = StackSlot(depth-1);
+        m_Emitter.Alu32(AluOp::Cmp, TypeOf(top), (int32_t)ValueType::Integer);
+        m_Emitter.Jcc(Condition::NE, doubleLabel);
+        m_Emitter.Alu64(AluOp::Cmp, PayloadOf(top), 0);
+        m_Emitter.Jcc(GetIntegerCondition(jumpCode), takenLabel);
+        m_Emitter.Jmp(notTakenLabel);
+
+        m_Emitter.Bind(doubleLabel);
+        EmitTypeGuard(top, ValueType::Double, exitLabel);
+        m_Emitter.Movsd(XmmReg::XMM0, PayloadOf(top));
+        m_Emitter.Xorpd(XmmReg::XMM1, XmmReg::XMM1);
+        EmitDoubleBranch(m_Emitter, jumpCode, takenLabel);
+        m_Emitter.Jmp(notTakenLabel);
+    }
+
+    // The doubleLabel may have not been used.
+    if (!m_Emitter.IsBound(doubleLabel))
+        m_Emitter.Bind(doubleLabel);
+
+    m_Emitter.Bind(takenLabel);
+    EmitTransfer(instrIdx, target, depthAfter, false);
+    m_Emitter.Bind(notTakenLabel);
+    EmitTransfer(instrIdx, next, depthAfter);
+    return true;
+}
+
+bool PulsarJit::X64::Translator::CanTransfer(size_t targetIdx, size_t depthAfter) const
+{
+    if (depthAfter > m_Function.MaxStackSize)
+        return false;
+    if (targetIdx == m_Function.Code.Size())
+        return true;
+    return targetIdx < m_Function.Code.Size() && m_Depths[targetIdx] == depthAfter;
+}
+
+void PulsarJit::X64::Translator::EmitTransfer(size_t fromIdx, size_t targetIdx, size_t depthAfter, bool canFallThrough)
+{
+    if (targetIdx == m_Function.Code.Size()) {
+        EmitExit(targetIdx, depthAfter);
+        return;
+    }
+
+    if (targetIdx <= fromIdx) {
+        // Backward jumps return if the budget ran out or a stop was requested.
+        int32_t loopLength = (int32_t)std::min<size_t>(fromIdx-targetIdx+1, INT32_MAX);
+        m_Emitter.Alu64(AluOp::Sub, Mem{ REG_STATE, (int32_t)offsetof(Pulsar::CompiledFrameState, Fuel) }, loopLength);
+        m_Emitter.Jcc(Condition::LE, GetExitLabel(targetIdx));
+        m_Emitter.Mov64(Reg::RAX, Mem{ REG_STATE, (int32_t)offsetof(Pulsar::CompiledFrameState, StopRequested) });
+        m_Emitter.Cmp8(Mem{ Reg::RAX, 0 }, 0);
+        m_Emitter.Jcc(Condition::NE, GetExitLabel(targetIdx));
+    } else if (canFallThrough && targetIdx == fromIdx+1) {
+        // The next instruction is emitted right after this one.
+        return;
+    }
+    m_Emitter.Jmp(m_InstructionLabels[targetIdx]);
+}
+
+void PulsarJit::X64::Translator::EmitExit(size_t instrIdx, size_t depth)
+{
+    m_Emitter.Mov64(STATE_INSTRUCTION_INDEX, (int32_t)instrIdx);
+    m_Emitter.Mov64(STATE_STACK_SIZE, (int32_t)depth);
+    m_Emitter.Jmp(m_ReturnLabel);
+}
+
+PulsarJit::X64::Translator::Label PulsarJit::X64::Translator::GetExitLabel(size_t instrIdx)
+{
+    PULSAR_ASSERT(m_Depths[instrIdx] != UNKNOWN_DEPTH, "Exiting at an instruction with an unknown depth.");
+    if (m_ExitLabels[instrIdx] == NO_LABEL)
+        m_ExitLabels[instrIdx] = m_Emitter.NewLabel();
+    return m_ExitLabels[instrIdx];
+}
+
+void PulsarJit::X64::Translator::EmitTrivialGuard(Mem slot, Label exitLabel)
+{
+    m_Emitter.Alu32(AluOp::Cmp, TypeOf(slot), MAX_TRIVIAL_TYPE);
+    m_Emitter.Jcc(Condition::A, exitLabel);
+}
+
+void PulsarJit::X64::Translator::EmitTypeGuard(Mem slot, ValueType type, Label exitLabel)
+{
+    m_Emitter.Alu32(AluOp::Cmp, TypeOf(slot), (int32_t)type);
+    m_Emitter.Jcc(Condition::NE, exitLabel);
+}
+
+void PulsarJit::X64::Translator::EmitCopy(Mem dst, Mem src)
+{
+    m_Emitter.Mov32(Reg::RAX, TypeOf(src));
+    m_Emitter.Mov32(TypeOf(dst), Reg::RAX);
+    m_Emitter.Mov64(Reg::RCX, PayloadOf(src));
+    m_Emitter.Mov64(PayloadOf(dst), Reg::RCX);
+}
+
+void PulsarJit::X64::Translator::EmitSetType(Mem slot, ValueType type)
+{
+    m_Emitter.Mov32(TypeOf(slot), (int32_t)type);
+}
+
+PulsarJit::X64::Mem PulsarJit::X64::Translator::StackSlot(size_t index) const
+{
+    return Mem{ REG_STACK, (int32_t)(index * sizeof(Pulsar::Value)) };
+}
+
+PulsarJit::X64::Mem PulsarJit::X64::Translator::LocalSlot(size_t index) const
+{
+    return Mem{ REG_LOCALS, (int32_t)(index * sizeof(Pulsar::Value)) };
+}
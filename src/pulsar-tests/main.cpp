@@ -0,0 +1,196 @@
+/*
+Tests which exercise parts of Pulsar that scripts can't reach directly.
+The process exits with the number of failed checks.
+*/
+
+#include <cstdio>
+#include <thread>
+
+#include "pulsar/parser.h"
+#include "pulsar/runtime.h"
+#include "pulsar/runtime/allocator.h"
+#include "pulsar/runtime/module.h"
+
+#include "pulsar-bindings/std/error.h"
+#include "pulsar-bindings/std/scheduler.h"
+#include "pulsar-bindings/std/thread.h"
+
+static size_t s_Failures = 0;
+
+#define PULSAR_TEST_CHECK(cond)                                        \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            std::fprintf(stderr, "%s:%d: CHECK (%s) FAILED\n",         \
+                __FILE__, __LINE__, #cond);                            \
+            s_Failures++;                                              \
+        }                                                              \
+    } while (0)
+
+static constexpr size_t BLOCK_COUNT = 100;
+
+// Blocks freed by a thread the arena is not bound to must be reused by the arena before it reserves a new slab.
+static void TestArenaRemoteFrees()
+{
+    Pulsar::ArenaAllocator arena;
+    Pulsar::Core::Allocator* oldAllocator = Pulsar::Core::SetThreadAllocator(&arena);
+
+    void* blocks[BLOCK_COUNT];
+    for (size_t i = 0; i < BLOCK_COUNT; i++) {
+        blocks[i] = Pulsar::Core::Malloc(16);
+        PULSAR_TEST_CHECK(Pulsar::Core::MemoryRegion::Of(blocks[i]) != nullptr);
+    }
+    PULSAR_TEST_CHECK(arena.GetStats().BytesInUse == BLOCK_COUNT*16);
+
+    std::thread([&blocks]() {
+        for (size_t i = 0; i < BLOCK_COUNT; i++)
+            Pulsar::Core::Free(blocks[i]);
+    }).join();
+
+    // Remote frees are only accounted for once the arena reclaims them.
+    PULSAR_TEST_CHECK(arena.GetStats().BytesInUse == BLOCK_COUNT*16);
+
+    // GetStats allocates through the arena too, though not from the size class of the blocks.
+    size_t reserved = arena.GetStats().BytesReserved;
+    static void* newBlocks[Pulsar::Core::MemoryRegion::REGION_SIZE/16];
+    size_t newBlockCount = 0;
+    size_t reused = 0;
+    while (arena.GetStats().BytesReserved == reserved) {
+        void* block = Pulsar::Core::Malloc(16);
+        for (size_t i = 0; i < BLOCK_COUNT; i++) {
+            if (blocks[i] == block)
+                reused++;
+        }
+        newBlocks[newBlockCount++] = block;
+    }
+    PULSAR_TEST_CHECK(reused == BLOCK_COUNT);
+
+    for (size_t i = 0; i < newBlockCount; i++)
+        Pulsar::Core::Free(newBlocks[i]);
+    Pulsar::Core::SetThreadAllocator(oldAllocator);
+}
+
+// Slabs must outlive their arena until all of their blocks are freed, by any thread.
+static void TestArenaOrphanedSlabs()
+{
+    void* blocks[BLOCK_COUNT];
+    {
+        Pulsar::ArenaAllocator arena;
+        Pulsar::Core::Allocator* oldAllocator = Pulsar::Core::SetThreadAllocator(&arena);
+        for (size_t i = 0; i < BLOCK_COUNT; i++)
+            blocks[i] = Pulsar::Core::Malloc(32);
+        // Some blocks are within the free list of the arena when it's destroyed.
+        for (size_t i = 0; i < BLOCK_COUNT/4; i++)
+            Pulsar::Core::Free(blocks[i]);
+        Pulsar::Core::SetThreadAllocator(oldAllocator);
+
+        // Others were freed remotely but never reclaimed.
+        std::thread([&blocks]() {
+            for (size_t i = BLOCK_COUNT/4; i < BLOCK_COUNT/2; i++)
+                Pulsar::Core::Free(blocks[i]);
+        }).join();
+    }
+
+    PULSAR_TEST_CHECK(Pulsar::Core::MemoryRegion::Of(blocks[BLOCK_COUNT-1]) != nullptr);
+    std::thread([&blocks]() {
+        for (size_t i = BLOCK_COUNT/2; i < BLOCK_COUNT-1; i++)
+            Pulsar::Core::Free(blocks[i]);
+    }).join();
+    PULSAR_TEST_CHECK(Pulsar::Core::MemoryRegion::Of(blocks[BLOCK_COUNT-1]) != nullptr);
+
+    // The last block destroys the slab.
+    Pulsar::Core::Free(blocks[BLOCK_COUNT-1]);
+    PULSAR_TEST_CHECK(Pulsar::Core::MemoryRegion::Of(blocks[BLOCK_COUNT-1]) == nullptr);
+}
+
+// Name lookups must see any modification of the definitions, not only appends.
+static void TestModuleNameIndex()
+{
+    Pulsar::Module module;
+    module.Globals.EmplaceBack("a", Pulsar::Value().SetInteger(0));
+    module.Globals.EmplaceBack("b", Pulsar::Value().SetInteger(1));
+    PULSAR_TEST_CHECK(module.FindGlobalByName("b") == 1);
+
+    module.Globals.EmplaceBack("c", Pulsar::Value().SetInteger(2));
+    PULSAR_TEST_CHECK(module.FindGlobalByName("c") == 2);
+
+    // Replaces "c" with a definition of the same count.
+    module.Globals.PopBack();
+    module.Globals.EmplaceBack("d", Pulsar::Value().SetInteger(3));
+    PULSAR_TEST_CHECK(module.FindGlobalByName("c") == Pulsar::Module::INVALID_INDEX);
+    PULSAR_TEST_CHECK(module.FindGlobalByName("d") == 2);
+
+    module.Globals[0].Name = "e";
+    PULSAR_TEST_CHECK(module.FindGlobalByName("a") == Pulsar::Module::INVALID_INDEX);
+    PULSAR_TEST_CHECK(module.FindGlobalByName("e") == 0);
+
+    std::swap(module.Globals.Edit()[0], module.Globals.Edit()[1]);
+    PULSAR_TEST_CHECK(module.FindGlobalByName("b") == 0);
+    PULSAR_TEST_CHECK(module.FindGlobalByName("e") == 1);
+}
+
+static const char* SCALL_RECEIVE_SOURCE = R"(
+*(*scall args fn) -> 2.
+*(*thread/run  args fn) -> 1.
+*(*thread/join thread) -> 2.
+*(*channel/new) -> 1.
+*(*channel/send! value channel).
+*(*channel/receive-timeout channel timeout) -> 2.
+
+*(receive channel) -> 2:
+  channel 2000 (*channel/receive-timeout)
+  .
+
+*(receive-in-scall channel) -> 1:
+  [ channel ] <& (receive) (*scall) (!pop)
+  .
+
+*(send channel):
+  42 channel (*channel/send!)
+  .
+
+*(main) -> 1:
+  (*channel/new) -> channel
+  [ channel ] <& (receive-in-scall) (*thread/run) -> receiver
+  [ channel ] <& (send) (*thread/run) (*thread/join) (!pop) (!pop)
+  receiver (*thread/join) (!pop)
+  .
+)";
+
+// A Thread blocked within a forked context can't be parked, so its worker must be replaced while it waits.
+// With a single worker, the sender would otherwise only run after the receiver timed out.
+static void TestSchedulerBlockedInFork()
+{
+    PulsarBindings::Std::Scheduler::SetDefaultWorkerCount(1);
+
+    Pulsar::Module module;
+    PulsarBindings::Std::Error error;
+    PulsarBindings::Std::Thread thread;
+    error.BindTypes(module);
+    thread.BindTypes(module);
+
+    Pulsar::Parser parser;
+    parser.AddSource("<scall-receive>", SCALL_RECEIVE_SOURCE);
+    PULSAR_TEST_CHECK(parser.ParseIntoModule(module) == Pulsar::ParseResult::OK);
+    error.BindFunctions(module);
+    thread.BindFunctions(module);
+
+    Pulsar::ExecutionContext context(module);
+    context.CallFunction("main");
+    PULSAR_TEST_CHECK(context.Run() == Pulsar::RuntimeState::OK);
+    PULSAR_TEST_CHECK(context.GetStack().Size() == 1);
+    if (context.GetStack().Size() == 1)
+        PULSAR_TEST_CHECK(context.GetStack()[0].ToRepr() == "[ [ 42, 1 ] ]");
+}
+
+int main()
+{
+    TestArenaRemoteFrees();
+    TestArenaOrphanedSlabs();
+    TestModuleNameIndex();
+    TestSchedulerBlockedInFork();
+
+    if (s_Failures > 0)
+        std::fprintf(stderr, "%zu check(s) failed.\n", s_Failures);
+    else std::printf("All tests passed.\n");
+    return (int)s_Failures;
+}
@@ -24,6 +24,8 @@
 #include "pulsar-bindings/extbinding.h"
 #include "pulsar-bindings/std.h"
 
+#include "pulsar-jit/compiler.h"
+
 #include "pulsar-tools/views.h"
 
 static PulsarTools::Logger g_Logger(stdout, stderr);
@@ -128,6 +130,7 @@ Pulsar::ParseSettings PulsarTools::CLI::ParserOptions::ToParseSettings() const
     settings.AppendNotesToErrorMessage = *this->ErrorNotes;
     settings.AllowIncludeDirective     = *this->AllowInclude;
     settings.AllowLabels               = *this->AllowLabels;
+    settings.EmitTailCalls             = *this->TailCalls;
 
     Pulsar::ParseSettings::IncludePaths includePaths;
     includePaths.Reserve((*this->IncludeFolders).size()+1);
@@ -468,6 +471,27 @@ int PulsarTools::CLI::Action::Optimize(Pulsar::Module& module, const OptimizerOp
         }
     }
 
+    if (*optimizerOptions.OptimizePeephole) {
+        size_t initInstructions = 0;
+        for (size_t i = 0; i < module.Functions.Size(); ++i)
+            initInstructions += module.Functions[i].Code.Size();
+
+        auto startTime = std::chrono::steady_clock::now();
+
+        Pulsar::PeepholeOptimizer optimizer;
+        size_t removedInstructions = optimizer.Optimize(module);
+
+        auto endTime = std::chrono::steady_clock::now();
+        auto optimizePeepholeTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime-startTime);
+
+        ++appliedOptimizations;
+        totalOptimizeTime += optimizePeepholeTime;
+
+        logger.Info("Optimize Peephole:");
+        logger.Info("- Removed {}/{} instructions.", removedInstructions, initInstructions);
+        logger.Info("- Time: {}us", optimizePeepholeTime.count());
+    }
+
     if (appliedOptimizations > 0)
         logger.Info("Optimizations took: {}us", totalOptimizeTime.count());
     return 0;
@@ -486,12 +510,33 @@ int PulsarTools::CLI::Action::Run(const Pulsar::Module& module, const RuntimeOpt
     auto startTime = std::chrono::steady_clock::now();
 
     Pulsar::ExecutionContext context(module);
+    if (*runtimeOptions.Jit) {
+        if (PulsarJit::Compiler::IsSupported()) {
+            context.SetCompiler(Pulsar::SharedRef<PulsarJit::Compiler>::New());
+        } else {
+            logger.Warn("JIT compilation is not supported on this platform.");
+        }
+    }
+
+    std::string_view engine = *runtimeOptions.Engine;
+    if (engine == "register") {
+        context.SetEngine(Pulsar::ExecutionEngine::Register);
+    } else if (engine == "stack") {
+        context.SetEngine(Pulsar::ExecutionEngine::Stack);
+    }
+
+    if (*runtimeOptions.Arena)
+        context.SetAllocator(Pulsar::SharedRef<Pulsar::ArenaAllocator>::New());
+
+    if (*runtimeOptions.Workers > 0)
+        PulsarBindings::Std::Scheduler::SetDefaultWorkerCount(static_cast<size_t>(*runtimeOptions.Workers));
+
     Pulsar::Stack& stack = context.GetStack();
     { // Push argv into the Stack.
         Pulsar::Value::List argList;
-        argList.Append()->Value().SetString((*input.FilePath).c_str());
+        argList.Append().SetString((*input.FilePath).c_str());
         for (const std::string& arg : *input.Args)
-            argList.Append()->Value().SetString(arg.c_str());
+            argList.Append().SetString(arg.c_str());
         stack.EmplaceList(std::move(argList));
     }
 
@@ -502,6 +547,12 @@ int PulsarTools::CLI::Action::Run(const Pulsar::Module& module, const RuntimeOpt
     auto execTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime-startTime);
     logger.PutNewLine();
     logger.Info("Execution took: {}us", execTime.count());
+    if (context.GetAllocator()) {
+        Pulsar::AllocatorStats allocatorStats = context.GetAllocatorStats();
+        logger.Info("Arena: {} allocations, {} bytes in use, {} bytes peak, {} bytes reserved, {} fallback allocations.",
+            allocatorStats.Allocations, allocatorStats.BytesInUse, allocatorStats.PeakBytesInUse,
+            allocatorStats.BytesReserved, allocatorStats.FallbackAllocations);
+    }
 
     if (functionCallState == Pulsar::RuntimeState::FunctionNotFound) {
         logger.Error("Runtime Error: {}", Pulsar::RuntimeStateToString(functionCallState));
@@ -4,6 +4,7 @@
 #include "pulsar/binary/bytewriter.h"
 
 #include "pulsar/utf8.h"
+#include "pulsar/verifier.h"
 
 #define RETURN_IF_NOT_OK(expr)     \
     do {                           \
@@ -18,14 +19,14 @@ Pulsar::Binary::ReadResult Pulsar::Binary::ReadByteCode(IReader& reader, Module&
     return ByteCode::ReadModule(reader, out, settings);
 }
 
-Pulsar::Binary::ReadResult Pulsar::Binary::ByteCode::ReadLinkedList(IReader& reader, LinkedList<Value>& out, const ReadSettings& settings)
+Pulsar::Binary::ReadResult Pulsar::Binary::ByteCode::ReadList(IReader& reader, Value::List& out, const ReadSettings& settings)
 {
-    LinkedList<Value> list;
+    Value::List list;
     uint64_t size = 0;
     if (!reader.ReadU64(size))
         return ReadResult::UnexpectedEOF;
     for (uint64_t i = 0; i < size; i++)
-        RETURN_IF_NOT_OK(ReadValue(reader, list.Append()->Value(), settings));
+        RETURN_IF_NOT_OK(ReadValue(reader, list.Append(), settings));
     out = std::move(list);
     return ReadResult::OK;
 }
@@ -275,20 +276,21 @@ Pulsar::Binary::ReadResult Pulsar::Binary::ByteCode::ReadModule(IReader& reader,
     if (!reader.ReadU64(moduleSize))
         return ReadResult::UnexpectedEOF;
     Module module;
+    List<uint64_t> maxStackSizes;
     while (true) {
         uint8_t chunkType = 0;
         if (!reader.ReadU8(chunkType))
             return ReadResult::UnexpectedEOF;
-        RETURN_IF_NOT_OK(ReadSized(reader, [&module, chunkType](ByteReader& reader, const ReadSettings& settings) mutable {
+        RETURN_IF_NOT_OK(ReadSized(reader, [&module, &maxStackSizes, chunkType](ByteReader& reader, const ReadSettings& settings) mutable {
             switch (chunkType) {
             case CHUNK_END_OF_MODULE:
                 return ReadResult::OK;
             case CHUNK_FUNCTIONS:
-                return ReadList(reader, module.Functions, settings);
+                return ReadList(reader, module.Functions.Edit(), settings);
             case CHUNK_NATIVE_BINDINGS:
-                return ReadList(reader, module.NativeBindings, settings);
+                return ReadList(reader, module.NativeBindings.Edit(), settings);
             case CHUNK_GLOBALS:
-                return ReadList(reader, module.Globals, settings);
+                return ReadList(reader, module.Globals.Edit(), settings);
             case CHUNK_CONSTANTS:
                 return ReadList(reader, module.Constants, settings);
             case CHUNK_SOURCE_DEBUG_SYMBOLS:
@@ -296,6 +298,15 @@ Pulsar::Binary::ReadResult Pulsar::Binary::ByteCode::ReadModule(IReader& reader,
                     return ReadList(reader, module.SourceDebugSymbols, settings);
                 reader.DiscardBytes();
                 return ReadResult::OK;
+            case CHUNK_MAX_STACK_SIZES: {
+                uint64_t size = 0;
+                if (!reader.ReadU64(size))
+                    return ReadResult::UnexpectedEOF;
+                for (uint64_t i = 0; i < size; i++) {
+                    if (!reader.ReadU64(maxStackSizes.EmplaceBack()))
+                        return ReadResult::UnexpectedEOF;
+                }
+            } return ReadResult::OK;
             default:
                 if (IsOptionalChunk(chunkType)) {
                     reader.DiscardBytes();
@@ -308,6 +319,18 @@ Pulsar::Binary::ReadResult Pulsar::Binary::ByteCode::ReadModule(IReader& reader,
             break;
     }
     module.NativeFunctions.Resize(module.NativeBindings.Size());
+    module.FastNativeFunctions.Resize(module.NativeBindings.Size());
+
+    // Sizes which were not stored (or can't be trusted) are computed by the Verifier.
+    for (size_t i = 0; i < maxStackSizes.Size() && i < module.Functions.Size(); i++) {
+        if (maxStackSizes[i] <= Verifier::MAX_COMPUTED_STACK_SIZE)
+            module.Functions[i].MaxStackSize = (size_t)maxStackSizes[i];
+    }
+
+    Verifier verifier;
+    verifier.Verify(module);
+    module.PromoteValuesToAtomic();
+
     out = std::move(module);
     return ReadResult::OK;
 }
@@ -346,8 +369,8 @@ Pulsar::Binary::ReadResult Pulsar::Binary::ByteCode::ReadValue(IReader& reader,
             out.SetNativeFunctionReference(idx);
         } break;
         case ValueType::List: {
-            LinkedList<Value> list;
-            RETURN_IF_NOT_OK(ReadLinkedList(reader, list, settings));
+            Value::List list;
+            RETURN_IF_NOT_OK(ReadList(reader, list, settings));
             out.SetList(std::move(list));
         } break;
         case ValueType::String: {
@@ -370,7 +393,7 @@ bool Pulsar::Binary::WriteByteCode(IWriter& writer, const Module& module, const
         && ByteCode::WriteModule(writer, module, settings);
 }
 
-bool Pulsar::Binary::ByteCode::WriteLinkedList(IWriter& writer, const LinkedList<Value>& list, const WriteSettings& settings)
+bool Pulsar::Binary::ByteCode::WriteList(IWriter& writer, const Value::List& list, const WriteSettings& settings)
 {
     if (!writer.WriteU64((uint64_t)list.Length()))
         return false;
@@ -561,6 +584,21 @@ bool Pulsar::Binary::ByteCode::WriteModule(IWriter& writer, const Module& module
                 return WriteList(writer, module.Constants, settings);
             }, settings)) return false;
         }
+        // Chunk/MaxStackSizes
+        if (module.Functions.Size() > 0) {
+            if (!writer.WriteU8(CHUNK_MAX_STACK_SIZES))
+                return false;
+            if (!WriteSized(writer, [&module](IWriter& writer, const WriteSettings& settings) {
+                PULSAR_UNUSED(settings);
+                if (!writer.WriteU64((uint64_t)module.Functions.Size()))
+                    return false;
+                for (size_t i = 0; i < module.Functions.Size(); i++) {
+                    if (!writer.WriteU64((uint64_t)module.Functions[i].MaxStackSize))
+                        return false;
+                }
+                return true;
+            }, settings)) return false;
+        }
         if (settings.StoreDebugSymbols) {
             // Chunk/SourceDebugSymbols
             if (module.SourceDebugSymbols.Size() > 0) {
@@ -592,7 +630,7 @@ bool Pulsar::Binary::ByteCode::WriteValue(IWriter& writer, const Value& value, c
         case ValueType::Double:
             return writer.WriteF64(value.AsDouble());
         case ValueType::List:
-            return WriteLinkedList(writer, value.AsList(), settings);
+            return WriteList(writer, value.AsList(), settings);
         case ValueType::String:
             return WriteString(writer, value.AsString(), settings);
         case ValueType::Custom:
@@ -1,18 +1,190 @@
 #include "pulsar/core.h"
 
+namespace
+{
+    // Registered regions are tracked by a two-level bitmap indexed by the address they start at.
+    constexpr size_t REGION_BITS  = 16;
+    constexpr size_t LEAF_BITS    = 16;
+    constexpr size_t ADDRESS_BITS = 48;
+    constexpr size_t ROOT_SIZE    = size_t(1) << (ADDRESS_BITS-LEAF_BITS-REGION_BITS);
+    constexpr size_t LEAF_WORDS   = (size_t(1) << LEAF_BITS) / 64;
+
+    static_assert(Pulsar::Core::MemoryRegion::REGION_SIZE == size_t(1) << REGION_BITS);
+
+#ifdef PULSAR_NO_ATOMIC
+    using RegionMapWord = uint64_t;
+    using RegionMapLeaf = RegionMapWord*;
+    using RegionMapRoot = RegionMapLeaf*;
+#else // PULSAR_NO_ATOMIC
+    using RegionMapWord = std::atomic_uint64_t;
+    using RegionMapLeaf = std::atomic<RegionMapWord*>;
+    using RegionMapRoot = std::atomic<RegionMapLeaf*>;
+#endif // PULSAR_NO_ATOMIC
+
+    // Both the root and the leaves are only allocated once the first region is registered.
+    RegionMapRoot g_RegionMap = nullptr;
+    PULSAR_ATOMIC_SIZE_T g_RegionCount = 0;
+
+    thread_local Pulsar::Core::Allocator* t_Allocator = nullptr;
+
+    size_t RegionIndex(uintptr_t address) { return (address >> REGION_BITS) & ((size_t(1) << LEAF_BITS)-1); }
+
+    // The map is never freed, it's allocated with std::calloc to not go through Pulsar::Core::Malloc.
+#ifdef PULSAR_NO_ATOMIC
+    RegionMapWord* GetRegionMapLeaf(uintptr_t address, bool create)
+    {
+        if (!g_RegionMap) {
+            if (!create)
+                return nullptr;
+            g_RegionMap = (RegionMapRoot)std::calloc(ROOT_SIZE, sizeof(RegionMapLeaf));
+            PULSAR_ASSERT(g_RegionMap, "Could not allocate MemoryRegion map.");
+        }
+
+        RegionMapLeaf& leaf = g_RegionMap[address >> (REGION_BITS+LEAF_BITS)];
+        if (!leaf && create) {
+            leaf = (RegionMapLeaf)std::calloc(LEAF_WORDS, sizeof(RegionMapWord));
+            PULSAR_ASSERT(leaf, "Could not allocate MemoryRegion map.");
+        }
+        return leaf;
+    }
+
+    bool IsRegionMarked(const RegionMapWord* leaf, size_t regionIdx) { return (leaf[regionIdx/64] >> (regionIdx%64)) & 1; }
+    void MarkRegion(RegionMapWord* leaf, size_t regionIdx)           { leaf[regionIdx/64] |= uint64_t(1) << (regionIdx%64); g_RegionCount++; }
+    void UnmarkRegion(RegionMapWord* leaf, size_t regionIdx)         { leaf[regionIdx/64] &= ~(uint64_t(1) << (regionIdx%64)); g_RegionCount--; }
+    bool HasRegions()                                                { return g_RegionCount != 0; }
+#else // PULSAR_NO_ATOMIC
+    // Allocates `count` zeroed objects of type T, if another thread published them first those are returned.
+    template<typename T>
+    T* PublishZeroed(std::atomic<T*>& slot, size_t count)
+    {
+        T* current = slot.load(std::memory_order_acquire);
+        if (current)
+            return current;
+
+        T* newBlock = (T*)std::calloc(count, sizeof(T));
+        PULSAR_ASSERT(newBlock, "Could not allocate MemoryRegion map.");
+        for (size_t i = 0; i < count; i++)
+            new(&newBlock[i]) T(0);
+        if (slot.compare_exchange_strong(current, newBlock, std::memory_order_acq_rel))
+            return newBlock;
+        std::free((void*)newBlock);
+        return current;
+    }
+
+    RegionMapWord* GetRegionMapLeaf(uintptr_t address, bool create)
+    {
+        RegionMapLeaf* root = create
+            ? PublishZeroed(g_RegionMap, ROOT_SIZE)
+            : g_RegionMap.load(std::memory_order_acquire);
+        if (!root)
+            return nullptr;
+
+        RegionMapLeaf& leaf = root[address >> (REGION_BITS+LEAF_BITS)];
+        return create
+            ? PublishZeroed(leaf, LEAF_WORDS)
+            : leaf.load(std::memory_order_acquire);
+    }
+
+    bool IsRegionMarked(const RegionMapWord* leaf, size_t regionIdx)
+    {
+        return (leaf[regionIdx/64].load(std::memory_order_relaxed) >> (regionIdx%64)) & 1;
+    }
+
+    void MarkRegion(RegionMapWord* leaf, size_t regionIdx)
+    {
+        leaf[regionIdx/64].fetch_or(uint64_t(1) << (regionIdx%64), std::memory_order_relaxed);
+        g_RegionCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void UnmarkRegion(RegionMapWord* leaf, size_t regionIdx)
+    {
+        leaf[regionIdx/64].fetch_and(~(uint64_t(1) << (regionIdx%64)), std::memory_order_relaxed);
+        g_RegionCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    bool HasRegions() { return g_RegionCount.load(std::memory_order_relaxed) != 0; }
+#endif // PULSAR_NO_ATOMIC
+}
+
 void* Pulsar::Core::Malloc(size_t size)
 {
+    Allocator* allocator = t_Allocator;
+    if (allocator) {
+        void* block = allocator->Malloc(size);
+        if (block) return block;
+    }
     return std::malloc(size);
 }
 
 void* Pulsar::Core::Realloc(void* block, size_t newSize)
 {
-    return std::realloc(block, newSize);
+    if (!block)
+        return Malloc(newSize);
+    MemoryRegion* region = MemoryRegion::Of(block);
+    if (!region)
+        return std::realloc(block, newSize);
+
+    size_t size = region->SizeOf(block);
+    if (newSize <= size)
+        return block;
+    void* newBlock = Malloc(newSize);
+    if (!newBlock)
+        return nullptr;
+    std::memcpy(newBlock, block, size);
+    region->Free(block, t_Allocator);
+    return newBlock;
 }
 
 
 void Pulsar::Core::Free(void* block)
 {
-    std::free(block);
+    if (!block)
+        return;
+    MemoryRegion* region = MemoryRegion::Of(block);
+    if (region) region->Free(block, t_Allocator);
+    else std::free(block);
+}
+
+Pulsar::Core::Allocator* Pulsar::Core::GetThreadAllocator()
+{
+    return t_Allocator;
+}
+
+Pulsar::Core::Allocator* Pulsar::Core::SetThreadAllocator(Allocator* allocator)
+{
+    Allocator* oldAllocator = t_Allocator;
+    t_Allocator = allocator;
+    return oldAllocator;
 }
 
+Pulsar::Core::MemoryRegion* Pulsar::Core::MemoryRegion::Of(const void* block)
+{
+    // Keeps Free and Realloc as cheap as before while no region is registered.
+    if (!HasRegions())
+        return nullptr;
+    uintptr_t address = (uintptr_t)block;
+    if ((address >> ADDRESS_BITS) != 0)
+        return nullptr;
+    RegionMapWord* leaf = GetRegionMapLeaf(address, false);
+    if (!leaf || !IsRegionMarked(leaf, RegionIndex(address)))
+        return nullptr;
+    return (MemoryRegion*)(address & ~(uintptr_t)(REGION_SIZE-1));
+}
+
+bool Pulsar::Core::MemoryRegion::Register(MemoryRegion* region)
+{
+    uintptr_t address = (uintptr_t)region;
+    PULSAR_ASSERT((address & (REGION_SIZE-1)) == 0, "MemoryRegion is not aligned to REGION_SIZE.");
+    if ((address >> ADDRESS_BITS) != 0)
+        return false;
+    MarkRegion(GetRegionMapLeaf(address, true), RegionIndex(address));
+    return true;
+}
+
+void Pulsar::Core::MemoryRegion::Unregister(MemoryRegion* region)
+{
+    uintptr_t address = (uintptr_t)region;
+    RegionMapWord* leaf = GetRegionMapLeaf(address, false);
+    PULSAR_ASSERT(leaf, "Unregistering a MemoryRegion which was never registered.");
+    UnmarkRegion(leaf, RegionIndex(address));
+}
@@ -1,11 +1,13 @@
 #include "pulsar/optimizer.h"
 
-Pulsar::BaseOptimizerSettings::IsExportedFunctionFn Pulsar::BaseOptimizerSettings::CreateReachableFunctionsFilter(const Module& module, const List<StringView>& exportedNames) { return CreateReachableDefinitionFilterFor(module.Functions, exportedNames); }
-Pulsar::BaseOptimizerSettings::IsExportedFunctionFn Pulsar::BaseOptimizerSettings::CreateReachableFunctionsFilter(const Module& module, const List<String>& exportedNames)     { return CreateReachableDefinitionFilterFor(module.Functions, exportedNames); }
-Pulsar::BaseOptimizerSettings::IsExportedNativeFn   Pulsar::BaseOptimizerSettings::CreateReachableNativesFilter(const Module& module, const List<StringView>& exportedNames)   { return CreateReachableDefinitionFilterFor(module.NativeBindings, exportedNames); }
-Pulsar::BaseOptimizerSettings::IsExportedNativeFn   Pulsar::BaseOptimizerSettings::CreateReachableNativesFilter(const Module& module, const List<String>& exportedNames)       { return CreateReachableDefinitionFilterFor(module.NativeBindings, exportedNames); }
-Pulsar::BaseOptimizerSettings::IsExportedGlobalFn   Pulsar::BaseOptimizerSettings::CreateReachableGlobalsFilter(const Module& module, const List<StringView>& exportedNames)   { return CreateReachableDefinitionFilterFor(module.Globals, exportedNames); }
-Pulsar::BaseOptimizerSettings::IsExportedGlobalFn   Pulsar::BaseOptimizerSettings::CreateReachableGlobalsFilter(const Module& module, const List<String>& exportedNames)       { return CreateReachableDefinitionFilterFor(module.Globals, exportedNames); }
+#include "pulsar/verifier.h"
+
+Pulsar::BaseOptimizerSettings::IsExportedFunctionFn Pulsar::BaseOptimizerSettings::CreateReachableFunctionsFilter(const Module& module, const List<StringView>& exportedNames) { return CreateReachableDefinitionFilterFor(module.Functions.Get(), exportedNames); }
+Pulsar::BaseOptimizerSettings::IsExportedFunctionFn Pulsar::BaseOptimizerSettings::CreateReachableFunctionsFilter(const Module& module, const List<String>& exportedNames)     { return CreateReachableDefinitionFilterFor(module.Functions.Get(), exportedNames); }
+Pulsar::BaseOptimizerSettings::IsExportedNativeFn   Pulsar::BaseOptimizerSettings::CreateReachableNativesFilter(const Module& module, const List<StringView>& exportedNames)   { return CreateReachableDefinitionFilterFor(module.NativeBindings.Get(), exportedNames); }
+Pulsar::BaseOptimizerSettings::IsExportedNativeFn   Pulsar::BaseOptimizerSettings::CreateReachableNativesFilter(const Module& module, const List<String>& exportedNames)       { return CreateReachableDefinitionFilterFor(module.NativeBindings.Get(), exportedNames); }
+Pulsar::BaseOptimizerSettings::IsExportedGlobalFn   Pulsar::BaseOptimizerSettings::CreateReachableGlobalsFilter(const Module& module, const List<StringView>& exportedNames)   { return CreateReachableDefinitionFilterFor(module.Globals.Get(), exportedNames); }
+Pulsar::BaseOptimizerSettings::IsExportedGlobalFn   Pulsar::BaseOptimizerSettings::CreateReachableGlobalsFilter(const Module& module, const List<String>& exportedNames)       { return CreateReachableDefinitionFilterFor(module.Globals.Get(), exportedNames); }
 
 bool Pulsar::UnusedOptimizer::Optimize(Module& module, const Settings& settings)
 {
@@ -107,9 +109,10 @@ void Pulsar::UnusedOptimizer::RemoveUnreachable(Module& module)
     m_RemappedConstants.Clear();
     m_RemappedConstants.Resize(module.Constants.Size(), INVALID_INDEX);
 
-    RemoveUnreachableFor(m_ReachableFunctions, m_RemappedFunctions, module.Functions);
-    RemoveUnreachableFor(m_ReachableNatives,   m_RemappedNatives,   module.NativeBindings, module.NativeFunctions);
-    RemoveUnreachableFor(m_ReachableGlobals,   m_RemappedGlobals,   module.Globals);
+    RemoveUnreachableFor(m_ReachableFunctions, m_RemappedFunctions, module.Functions.Edit());
+    module.FastNativeFunctions.Resize(module.NativeBindings.Size());
+    RemoveUnreachableFor(m_ReachableNatives,   m_RemappedNatives,   module.NativeBindings.Edit(), module.NativeFunctions, module.FastNativeFunctions);
+    RemoveUnreachableFor(m_ReachableGlobals,   m_RemappedGlobals,   module.Globals.Edit());
     RemoveUnreachableFor(m_ReachableConstants, m_RemappedConstants, module.Constants);
 }
 
@@ -141,3 +144,198 @@ void Pulsar::UnusedOptimizer::RemapIndices(Module& module)
 
 #undef REMAP_INDEX
 }
+
+size_t Pulsar::PeepholeOptimizer::Optimize(Module& module)
+{
+    size_t removedCount = 0;
+    for (size_t fnIdx = 0; fnIdx < module.Functions.Size(); ++fnIdx) {
+        auto& function = module.Functions[fnIdx];
+        size_t functionRemovedCount = OptimizeFunction(function);
+        if (functionRemovedCount > 0) {
+            function.Verified = false;
+            function.MaxStackSize = 0;
+            removedCount += functionRemovedCount;
+        }
+    }
+
+    if (removedCount > 0) {
+        Verifier verifier;
+        verifier.Verify(module);
+    }
+
+    return removedCount;
+}
+
+size_t Pulsar::PeepholeOptimizer::OptimizeFunction(FunctionDefinition& function)
+{
+    const List<Instruction>& code = function.Code;
+
+    m_IsJumpTarget.Clear();
+    m_IsJumpTarget.Resize(code.Size()+1, false);
+    for (size_t i = 0; i < code.Size(); ++i) {
+        if (!HasJumpOffset(code[i].Code))
+            continue;
+        int64_t jumpIdx = static_cast<int64_t>(i) + code[i].Arg0;
+        if (jumpIdx < 0 || static_cast<size_t>(jumpIdx) > code.Size())
+            return 0;
+        m_IsJumpTarget[static_cast<size_t>(jumpIdx)] = true;
+    }
+
+    m_RemappedIndex.Clear();
+    m_RemappedIndex.Resize(code.Size()+1, INVALID_INDEX);
+    m_SymbolIndex.Clear();
+    m_SymbolIndex.Reserve(code.Size());
+    m_Code.Clear();
+    m_Code.Reserve(code.Size());
+
+    for (size_t i = 0; i < code.Size();) {
+        Instruction instruction = code[i];
+        size_t fusedCount = FuseInstructions(code, i, instruction);
+        if (fusedCount == 0)
+            fusedCount = 1;
+
+        // The jump is always the last fused instruction.
+        // Its Arg0 is set to the absolute index of the target until all indices are remapped.
+        size_t lastIdx = i + fusedCount - 1;
+        if (HasJumpOffset(instruction.Code))
+            instruction.Arg0 = static_cast<int64_t>(lastIdx) + code[lastIdx].Arg0;
+
+        for (size_t j = i; j <= lastIdx; ++j)
+            m_RemappedIndex[j] = m_Code.Size();
+        m_SymbolIndex.PushBack(fusedCount > 1 ? i + FailingInstructionOffset(instruction.Code) : i);
+        m_Code.PushBack(instruction);
+        i += fusedCount;
+    }
+    m_RemappedIndex[code.Size()] = m_Code.Size();
+
+    size_t removedCount = code.Size() - m_Code.Size();
+    if (removedCount == 0)
+        return 0;
+
+    for (size_t i = 0; i < m_Code.Size(); ++i) {
+        auto& instruction = m_Code[i];
+        if (HasJumpOffset(instruction.Code)) {
+            size_t targetIdx = m_RemappedIndex[static_cast<size_t>(instruction.Arg0)];
+            instruction.Arg0 = static_cast<int64_t>(targetIdx) - static_cast<int64_t>(i);
+        }
+    }
+
+    // Each instruction takes the symbol of the original instruction at m_SymbolIndex.
+    // Symbols are sorted by StartIdx, and so is m_SymbolIndex, the last one which starts at or before it applies.
+    auto& debugSymbols = function.CodeDebugSymbols;
+    m_CodeDebugSymbols.Clear();
+    size_t nextSymbol = 0;
+    size_t currentSymbol = INVALID_INDEX;
+    for (size_t i = 0; i < m_Code.Size(); ++i) {
+        while (nextSymbol < debugSymbols.Size() && debugSymbols[nextSymbol].StartIdx <= m_SymbolIndex[i])
+            ++nextSymbol;
+        if (nextSymbol == 0 || nextSymbol-1 == currentSymbol)
+            continue;
+        currentSymbol = nextSymbol-1;
+        m_CodeDebugSymbols.PushBack({ debugSymbols[currentSymbol].Token, i });
+    }
+    // Symbols past the end of the code are kept at its end.
+    for (; nextSymbol < debugSymbols.Size(); ++nextSymbol) {
+        if (debugSymbols[nextSymbol].StartIdx >= code.Size())
+            m_CodeDebugSymbols.PushBack({ debugSymbols[nextSymbol].Token, m_Code.Size() });
+    }
+    debugSymbols = std::move(m_CodeDebugSymbols);
+
+    function.Code = std::move(m_Code);
+    return removedCount;
+}
+
+size_t Pulsar::PeepholeOptimizer::FailingInstructionOffset(InstructionCode fused)
+{
+    switch (fused) {
+    case InstructionCode::IncLocal:
+    case InstructionCode::DecLocal:
+        // PushLocal x; PushInt 1; DynSum/DynSub; PopIntoLocal x
+        return 2;
+    case InstructionCode::PushConstAppend:
+    case InstructionCode::DupJZ:
+        return 1;
+    default:
+        // Compare and Equals come before their jump.
+        return 0;
+    }
+}
+
+size_t Pulsar::PeepholeOptimizer::FuseInstructions(const List<Instruction>& code, size_t instrIdx, Instruction& out) const
+{
+    // Instructions can be fused only if no jump lands in the middle of them.
+    auto canFuse = [this, &code, instrIdx](size_t count) {
+        if (instrIdx + count > code.Size())
+            return false;
+        for (size_t i = instrIdx+1; i < instrIdx+count; ++i) {
+            if (m_IsJumpTarget[i])
+                return false;
+        }
+        return true;
+    };
+
+    auto isPackable = [](int64_t arg0) {
+        return arg0 >= 0 && arg0 <= static_cast<int64_t>(UINT32_MAX);
+    };
+
+    const Instruction& instruction = code[instrIdx];
+    switch (instruction.Code) {
+    case InstructionCode::PushLocal:
+        if (canFuse(4)
+            && code[instrIdx+1].Code == InstructionCode::PushInt
+            && code[instrIdx+1].Arg0 == 1
+            && (code[instrIdx+2].Code == InstructionCode::DynSum || code[instrIdx+2].Code == InstructionCode::DynSub)
+            && code[instrIdx+3].Code == InstructionCode::PopIntoLocal
+            && code[instrIdx+3].Arg0 == instruction.Arg0
+        ) {
+            out = { code[instrIdx+2].Code == InstructionCode::DynSum
+                ? InstructionCode::IncLocal
+                : InstructionCode::DecLocal, instruction.Arg0 };
+            return 4;
+        }
+        if (canFuse(2)
+            && code[instrIdx+1].Code == InstructionCode::PushLocal
+            && isPackable(instruction.Arg0)
+            && isPackable(code[instrIdx+1].Arg0)
+        ) {
+            out = { InstructionCode::PushLocal2, PackArgs(
+                static_cast<uint32_t>(instruction.Arg0),
+                static_cast<uint32_t>(code[instrIdx+1].Arg0)) };
+            return 2;
+        }
+        return 0;
+    case InstructionCode::PushConst:
+        if (canFuse(2) && code[instrIdx+1].Code == InstructionCode::Append) {
+            out = { InstructionCode::PushConstAppend, instruction.Arg0 };
+            return 2;
+        }
+        return 0;
+    case InstructionCode::Dup:
+        // Only a single value must be duplicated.
+        if (instruction.Arg0 <= 1 && canFuse(2) && code[instrIdx+1].Code == InstructionCode::JZ) {
+            out = { InstructionCode::DupJZ, code[instrIdx+1].Arg0 };
+            return 2;
+        }
+        return 0;
+    case InstructionCode::Compare:
+        if (!canFuse(2))
+            return 0;
+        switch (code[instrIdx+1].Code) {
+        case InstructionCode::JGZ:  out = { InstructionCode::CompareJGZ,  code[instrIdx+1].Arg0 }; return 2;
+        case InstructionCode::JGEZ: out = { InstructionCode::CompareJGEZ, code[instrIdx+1].Arg0 }; return 2;
+        case InstructionCode::JLZ:  out = { InstructionCode::CompareJLZ,  code[instrIdx+1].Arg0 }; return 2;
+        case InstructionCode::JLEZ: out = { InstructionCode::CompareJLEZ, code[instrIdx+1].Arg0 }; return 2;
+        default: return 0;
+        }
+    case InstructionCode::Equals:
+        if (!canFuse(2))
+            return 0;
+        switch (code[instrIdx+1].Code) {
+        case InstructionCode::JZ:  out = { InstructionCode::EqualsJZ,  code[instrIdx+1].Arg0 }; return 2;
+        case InstructionCode::JNZ: out = { InstructionCode::EqualsJNZ, code[instrIdx+1].Arg0 }; return 2;
+        default: return 0;
+        }
+    default:
+        return 0;
+    }
+}
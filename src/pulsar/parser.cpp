@@ -1,5 +1,7 @@
 #include "pulsar/parser.h"
 
+#include "pulsar/verifier.h"
+
 #ifndef PULSAR_NO_FILESYSTEM
 #include <filesystem>
 #include <fstream>
@@ -144,12 +146,12 @@ Pulsar::ParseResult Pulsar::Parser::ParseIntoModule(Module& module, const ParseS
         }
     }
     for (size_t i = 0; i < module.Functions.Size(); i++)
-        globalScope.Functions.Insert(module.Functions[i].Name, i);
+        globalScope.Functions.Insert(module.Functions.Get()[i].Name, i);
     // This was commented out so that the file MUST declare used natives itself
     // for (size_t i = 0; i < module.NativeBindings.Size(); i++)
     //     globalScope.NativeFunctions.Insert(module.NativeBindings[i].Name, i);
     for (size_t i = 0; i < module.Globals.Size(); i++)
-        globalScope.Globals.Insert(module.Globals[i].Name, i);
+        globalScope.Globals.Insert(module.Globals.Get()[i].Name, i);
 
     while (m_Lexers.Size() > 0) {
         auto res = ParseModuleStatement(module, globalScope, settings);
@@ -159,6 +161,7 @@ Pulsar::ParseResult Pulsar::Parser::ParseIntoModule(Module& module, const ParseS
     }
 
     module.NativeFunctions.Resize(module.NativeBindings.Size(), nullptr);
+    module.FastNativeFunctions.Resize(module.NativeBindings.Size());
 
     if (settings.StoreDebugSymbols) {
         if (HasMessages()) {
@@ -170,6 +173,10 @@ Pulsar::ParseResult Pulsar::Parser::ParseIntoModule(Module& module, const ParseS
 
     StripUnusedSources();
 
+    Verifier verifier;
+    verifier.Verify(module);
+    module.PromoteValuesToAtomic();
+
     return ParseResult::OK;
 }
 
@@ -273,7 +280,7 @@ Pulsar::ParseResult Pulsar::Parser::ParseGlobalDefinition(Module& module, Global
 
     auto globalNameIdxPair = globalScope.Globals.Find(identToken.StringVal);
     if (globalNameIdxPair) {
-        if (module.Globals[globalNameIdxPair->Value()].IsConstant)
+        if (module.Globals.Get()[globalNameIdxPair->Value()].IsConstant)
             return SetError(ParseResult::WritingToConstantGlobal, identToken, "Trying to reassign constant global.");
         else if (isConstant)
             return SetError(ParseResult::UnexpectedToken, constToken, "Redeclaring global as const.");
@@ -441,7 +448,7 @@ Pulsar::ParseResult Pulsar::Parser::ParseFunctionDefinition(Module& module, Glob
         }
 
         // If the native already exists push symbols (the function may have been defined outside the Parser)
-        const FunctionDefinition& binding = module.NativeBindings[nativeIdx];
+        const FunctionDefinition& binding = module.NativeBindings.Get()[nativeIdx];
         if (!binding.DeclarationMatches(def)) {
             // TODO: EmitError() would be cool so a message could point to the previous declaration
             if (isRedeclaration) {
@@ -523,6 +530,14 @@ Pulsar::ParseResult Pulsar::Parser::ParseFunctionBody(
     while (true) {
         switch (curToken.Type) {
         case TokenType::FullStop:
+            // A call which is directly followed by a return can replace the current frame.
+            if (settings.EmitTailCalls && !func.Code.IsEmpty()) {
+                Instruction& lastInstr = func.Code.Back();
+                if (lastInstr.Code == InstructionCode::Call)
+                    lastInstr.Code = InstructionCode::TailCall;
+                else if (lastInstr.Code == InstructionCode::ICall)
+                    lastInstr.Code = InstructionCode::ITailCall;
+            }
             PUSH_CODE_SYMBOL(settings.StoreDebugSymbols, func, curToken);
             func.Code.EmplaceBack(InstructionCode::Return);
             NOTIFY_SEND_BLOCK_NOTIFICATION(ParserNotifications::BlockNotificationType::BlockEnd, func, scope, settings);
@@ -672,7 +687,7 @@ Pulsar::ParseResult Pulsar::Parser::ParseFunctionBody(
                 if (auto globalNameIdxPair = scope.Global.Globals.Find(curToken.StringVal); globalNameIdxPair) {
                     // Accessing global
                     int64_t globalIdx = (int64_t)globalNameIdxPair->Value();
-                    if (module.Globals[(size_t)globalIdx].IsConstant)
+                    if (module.Globals.Get()[(size_t)globalIdx].IsConstant)
                         return SetError(ParseResult::UnexpectedToken, curToken, "Trying to assign to constant global.");
                     NOTIFY_IDENTIFIER_USAGE(ParserNotifications::IdentifierUsageType::Global, globalIdx, func, curToken, scope, settings);
                     func.Code.EmplaceBack(
@@ -1346,7 +1361,7 @@ Pulsar::ParseResult Pulsar::Parser::ParseLValue(Module& module, FunctionDefiniti
             auto globalNameIdxPair = localScope.Global.Globals.Find(lvalue.StringVal);
             if (!globalNameIdxPair)
                 return SetError(ParseResult::UsageOfUndeclaredLocal, lvalue, "Local not declared.");
-            if (module.Globals[globalNameIdxPair->Value()].IsConstant)
+            if (module.Globals.Get()[globalNameIdxPair->Value()].IsConstant)
                 return SetError(ParseResult::WritingToConstantGlobal, lvalue, "Cannot move constant global.");
             int64_t globalIdx = (int64_t)globalNameIdxPair->Value();
             NOTIFY_IDENTIFIER_USAGE(ParserNotifications::IdentifierUsageType::Global, globalIdx, func, lvalue, localScope, settings);
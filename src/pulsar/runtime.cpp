@@ -1,11 +1,15 @@
 #include "pulsar/runtime.h"
 
 Pulsar::ExecutionContext::ExecutionContext(const Module& module, bool init)
-    : m_Module(module)
+    : m_Module(module), m_Globals(SharedGlobals::New()), m_FunctionStates(SharedRef<FunctionStateTable>::New())
 {
     if (init) Init();
 }
 
+Pulsar::ExecutionContext::ExecutionContext(const Module& module, SharedGlobals globals, SharedRef<FunctionStateTable> functionStates)
+    : m_Module(module), m_Globals(std::move(globals)), m_FunctionStates(std::move(functionStates))
+{}
+
 void Pulsar::ExecutionContext::Init()
 {
     InitGlobals();
@@ -14,8 +18,9 @@ void Pulsar::ExecutionContext::Init()
 
 void Pulsar::ExecutionContext::InitGlobals()
 {
+    List<GlobalInstance>& globals = OwnGlobals();
     for (size_t i = 0; i < m_Module.Globals.Size(); i++)
-        m_Globals.EmplaceBack(m_Module.Globals[i].CreateInstance());
+        globals.EmplaceBack(m_Module.Globals[i].CreateInstance());
 }
 
 void Pulsar::ExecutionContext::InitCustomTypeGlobalData()
@@ -27,11 +32,18 @@ void Pulsar::ExecutionContext::InitCustomTypeGlobalData()
     });
 }
 
-Pulsar::ExecutionContext Pulsar::ExecutionContext::Fork() const
+Pulsar::ExecutionContext Pulsar::ExecutionContext::ForkBase() const
 {
-    ExecutionContext fork(this->GetModule(), false);
+    ExecutionContext fork(this->GetModule(), m_Globals, m_FunctionStates);
+    fork.SetCompiler(m_Compiler, m_CompileThreshold);
+    fork.SetEngine(m_Engine);
+    fork.SetAllocator(m_Allocator ? m_Allocator->Fork() : nullptr);
+    return fork;
+}
 
-    fork.GetGlobals() = this->GetGlobals();
+Pulsar::ExecutionContext Pulsar::ExecutionContext::Fork() const
+{
+    ExecutionContext fork = ForkBase();
     this->GetAllCustomTypeGlobalData().ForEach([&fork](const auto& b) {
         PULSAR_ASSERT(b.Value(), "Reference to CustomTypeGlobalData is nullptr.");
         uint64_t typeId = b.Key();
@@ -42,6 +54,19 @@ Pulsar::ExecutionContext Pulsar::ExecutionContext::Fork() const
     return fork;
 }
 
+Pulsar::ExecutionContext Pulsar::ExecutionContext::ForkShared() const
+{
+    ExecutionContext fork = ForkBase();
+    fork.m_CustomTypeGlobalData = m_CustomTypeGlobalData;
+    return fork;
+}
+
+void Pulsar::ExecutionContext::PromoteGlobalsToAtomic() const
+{
+    for (const GlobalInstance& global : *m_Globals)
+        global.Value.PromoteToAtomic();
+}
+
 Pulsar::String Pulsar::ExecutionContext::GetCallTrace(size_t callIdx, const PositionConverterFn& positionConverter) const
 {
     const Frame& frame = m_CallStack[callIdx];
@@ -132,13 +157,45 @@ Pulsar::String Pulsar::ExecutionContext::GetStackTrace(size_t maxDepth, const Po
 
 Pulsar::Frame Pulsar::CallStack::CreateFrame(const FunctionDefinition* def, bool native)
 {
-    return {
-        .Function = def,
-        .IsNative = native,
-        .Locals   = List<Value>(def->Arity),
-        .Stack    = Stack(),
-        .InstructionIndex = 0,
-    };
+    // Natives only hold their stack arguments and return values.
+    size_t stackSize = native
+        ? def->StackArity + def->Returns
+        : (def->MaxStackSize > def->StackArity ? def->MaxStackSize : def->StackArity);
+
+    if (m_FreeFrames.IsEmpty()) {
+        return {
+            .Function = def,
+            .IsNative = native,
+            .Locals   = List<Value>(def->LocalsCount),
+            .Stack    = Stack(stackSize),
+            .InstructionIndex = 0,
+        };
+    }
+
+    // Reuse the storage of a popped frame, Locals and Stack were already cleared.
+    Frame frame(std::move(m_FreeFrames.Back()));
+    m_FreeFrames.PopBack();
+    frame.Function = def;
+    frame.IsNative = native;
+    frame.Locals.Reserve(def->LocalsCount);
+    frame.Stack.Reserve(stackSize);
+    frame.InstructionIndex = 0;
+    return frame;
+}
+
+void Pulsar::CallStack::PopFrame()
+{
+    Frame& frame = m_Frames.Back();
+    if (m_FreeFrames.Size() < MAX_FREE_FRAMES) {
+        if (frame.Locals.Capacity() > MAX_FREE_FRAME_CAPACITY)
+            frame.Locals = List<Value>();
+        else frame.Locals.Clear();
+        if (frame.Stack.Capacity() > MAX_FREE_FRAME_CAPACITY)
+            frame.Stack = Pulsar::Stack();
+        else frame.Stack.Clear();
+        m_FreeFrames.EmplaceBack(std::move(frame));
+    }
+    m_Frames.PopBack();
 }
 
 Pulsar::Frame& Pulsar::CallStack::CreateAndPushFrame(const FunctionDefinition* def, bool native)
@@ -157,20 +214,107 @@ Pulsar::RuntimeState Pulsar::CallStack::PrepareFrame(Frame& frame, Stack& caller
     if (callerStack.Size() < (frame.Function->StackArity + frame.Function->Arity))
         return RuntimeState::StackUnderflow;
 
+    // Arguments are on top of the values taken by the stack of the callee.
+    size_t stackArgsIdx = callerStack.Size() - frame.Function->StackArity - frame.Function->Arity;
+    size_t argsIdx      = stackArgsIdx + frame.Function->StackArity;
+
     frame.Locals.Resize(frame.Function->LocalsCount);
     for (size_t i = 0; i < frame.Function->Arity; i++) {
-        frame.Locals[frame.Function->Arity-i-1] = callerStack.Pop();
+        frame.Locals[i] = std::move(callerStack[argsIdx+i]);
     }
 
-    // TODO: Figure out if this tanks performance when StackArity is 0
     frame.Stack.Resize(frame.Function->StackArity);
     for (size_t i = 0; i < frame.Function->StackArity; i++) {
-        frame.Stack[frame.Function->StackArity-i-1] = callerStack.Pop();
+        frame.Stack[i] = std::move(callerStack[stackArgsIdx+i]);
     }
 
+    callerStack.Resize(stackArgsIdx);
+    return RuntimeState::OK;
+}
+
+Pulsar::NativeCall::NativeCall(ExecutionContext& context, const FunctionDefinition& native, Stack& callerStack)
+    : m_Context(context), m_Native(native), m_CallerStack(&callerStack)
+{
+    PULSAR_ASSERT(callerStack.Size() >= native.StackArity + native.Arity, "Native called with missing arguments.");
+    m_StackArgsIdx = callerStack.Size() - native.StackArity - native.Arity;
+    m_ArgsIdx      = m_StackArgsIdx + native.StackArity;
+    // Only saves reallocations while pushing results, references to the arguments may still be invalidated by them.
+    callerStack.Reserve(callerStack.Size() + native.Returns);
+}
+
+Pulsar::NativeCall::NativeCall(ExecutionContext& context, size_t frameIdx)
+    : m_Context(context), m_Native(*context.GetCallStack()[frameIdx].Function), m_FrameIdx(frameIdx)
+{
+}
+
+std::span<Pulsar::Value> Pulsar::NativeCall::Arguments()
+{
+    if (HasFrame())
+        return { m_Context.GetCallStack()[m_FrameIdx].Locals.Data(), m_Native.Arity };
+    return { m_CallerStack->Data() + m_ArgsIdx, m_Native.Arity };
+}
+
+std::span<Pulsar::Value> Pulsar::NativeCall::StackArguments()
+{
+    if (HasFrame())
+        return { m_Context.GetCallStack()[m_FrameIdx].Stack.Data(), m_Native.StackArity };
+    return { m_CallerStack->Data() + m_StackArgsIdx, m_Native.StackArity };
+}
+
+Pulsar::Value& Pulsar::NativeCall::PushResult()
+{
+    if (HasFrame())
+        return m_Context.GetCallStack()[m_FrameIdx].Stack.Emplace();
+    return m_CallerStack->Emplace();
+}
+
+Pulsar::Frame& Pulsar::NativeCall::MaterializeFrame()
+{
+    CallStack& callStack = m_Context.GetCallStack();
+    if (HasFrame())
+        return callStack[m_FrameIdx];
+
+    Frame frame = callStack.CreateFrame(&m_Native, true);
+    frame.Locals.Resize(m_Native.LocalsCount);
+    for (size_t i = 0; i < m_Native.Arity; i++)
+        frame.Locals[i] = std::move((*m_CallerStack)[m_ArgsIdx+i]);
+
+    size_t stackSize = m_Native.StackArity + PushedResults();
+    frame.Stack.Resize(stackSize);
+    for (size_t i = 0; i < stackSize; i++)
+        frame.Stack[i] = std::move((*m_CallerStack)[StackIndex(i)]);
+
+    m_CallerStack->Resize(m_StackArgsIdx);
+    m_CallerStack = nullptr;
+    m_FrameIdx = callStack.Size();
+    return callStack.PushFrame(std::move(frame));
+}
+
+Pulsar::RuntimeState Pulsar::NativeCall::Return()
+{
+    PULSAR_ASSERT(!HasFrame(), "Returning from a NativeCall with a Frame.");
+    size_t stackSize = m_Native.StackArity + PushedResults();
+    if (stackSize < m_Native.Returns)
+        return RuntimeState::StackUnderflow;
+
+    // Destinations always come before their sources, so no value is overwritten before being moved.
+    size_t firstReturnIdx = stackSize - m_Native.Returns;
+    for (size_t i = 0; i < m_Native.Returns; i++) {
+        size_t srcIdx = StackIndex(firstReturnIdx+i);
+        if (srcIdx != m_StackArgsIdx+i)
+            (*m_CallerStack)[m_StackArgsIdx+i] = std::move((*m_CallerStack)[srcIdx]);
+    }
+    m_CallerStack->Resize(m_StackArgsIdx + m_Native.Returns);
     return RuntimeState::OK;
 }
 
+size_t Pulsar::NativeCall::StackIndex(size_t i) const
+{
+    return i < m_Native.StackArity
+        ? m_StackArgsIdx + i
+        : m_ArgsIdx + m_Native.Arity + (i - m_Native.StackArity);
+}
+
 Pulsar::RuntimeState Pulsar::ExecutionContext::CallFunction(const String& funcName)
 {
     size_t fnIdx = m_Module.FindFunctionByName(funcName);
@@ -215,33 +359,215 @@ Pulsar::RuntimeState Pulsar::ExecutionContext::CallFunction(const FunctionDefini
     return RuntimeState::OK;
 }
 
-void Pulsar::ExecutionContext::InternalStep()
+bool Pulsar::ExecutionContext::CallFastNative(size_t nativeIdx, Stack& callerStack)
 {
-    Frame& frame = m_CallStack.CurrentFrame();
-    if (frame.InstructionIndex < frame.Function->Code.Size()) {
-        m_State = ExecuteInstruction(frame);
-        return;
+    const Module::FastNativeBinding& binding = m_Module.FastNativeFunctions[nativeIdx];
+    NativeCall call(*this, m_Module.NativeBindings[nativeIdx], callerStack);
+    m_State = binding.Function(call, binding.UserData);
+    if (call.HasFrame())
+        return true;
+    if (m_State == RuntimeState::OK)
+        m_State = call.Return();
+    if (m_State == RuntimeState::OK)
+        return false;
+    // Errors are reported as if the native was called with its own Frame.
+    call.MaterializeFrame();
+    return true;
+}
+
+#ifdef PULSAR_NO_ATOMIC
+template<typename T>
+static T LoadShared(const T& field) { return field; }
+template<typename T>
+static void StoreShared(T& field, T value) { field = value; }
+template<typename T>
+static T ExchangeShared(T& field, T value) { T old = field; field = value; return old; }
+#else // PULSAR_NO_ATOMIC
+template<typename T>
+static T LoadShared(const std::atomic<T>& field) { return field.load(std::memory_order_acquire); }
+template<typename T>
+static void StoreShared(std::atomic<T>& field, T value) { field.store(value, std::memory_order_release); }
+template<typename T>
+static T ExchangeShared(std::atomic<T>& field, T value) { return field.exchange(value, std::memory_order_acq_rel); }
+#endif // PULSAR_NO_ATOMIC
+
+// Constructs `count` items at `items` from `args`, which may be empty.
+template<typename T, typename ...Args>
+static void PlacementNewAll(T* items, size_t count, Args ...args)
+{
+    for (size_t i = 0; i < count; i++)
+        PULSAR_PLACEMENT_NEW(T, &items[i], args...);
+}
+
+void Pulsar::ExecutionContext::FunctionStateTable::Reset(size_t count, uint64_t version)
+{
+    for (size_t i = 0; i < Count; i++)
+        States[i].~FunctionState();
+    PULSAR_FREE((void*)States);
+    States = nullptr;
+    Count  = 0;
+
+    if (count > 0) {
+        States = (FunctionState*)PULSAR_MALLOC(sizeof(FunctionState) * count);
+        PlacementNewAll(States, count);
+        Count = count;
     }
+    StoreShared(FunctionsVersion, version);
+}
 
-    Stack& callerStack = m_CallStack.HasCaller()
-        ? m_CallStack.CallingFrame().Stack : m_Stack;
+Pulsar::ExecutionContext::FunctionState* Pulsar::ExecutionContext::GetFunctionState(const FunctionDefinition& function)
+{
+    // Only functions within the Module are tracked, others may be temporaries.
+    const List<FunctionDefinition>& functions = m_Module.Functions;
+    uintptr_t functionsBegin = (uintptr_t)functions.Data();
+    uintptr_t functionsEnd   = (uintptr_t)(functions.Data() + functions.Size());
+    if ((uintptr_t)&function < functionsBegin || (uintptr_t)&function >= functionsEnd)
+        return nullptr;
 
-    Frame& returningFrame = m_CallStack.CurrentFrame();
-    if (returningFrame.Stack.Size() < returningFrame.Function->Returns) {
-        m_State = RuntimeState::StackUnderflow;
+    size_t funcIdx = (size_t)(&function - functions.Data());
+    FunctionStateTable& table = *m_FunctionStates;
+    if (LoadShared(table.FunctionsVersion) == m_Module.Functions.Version()) {
+        FunctionState& state = table.States[funcIdx];
+        if (LoadShared(state.Code))
+            return &state;
+    }
+    return InitFunctionState(funcIdx);
+}
+
+Pulsar::ExecutionContext::FunctionState* Pulsar::ExecutionContext::InitFunctionState(size_t funcIdx)
+{
+    FunctionStateTable& table = *m_FunctionStates;
+#ifndef PULSAR_NO_ATOMIC
+    std::lock_guard lock(table.Mutex);
+#endif // PULSAR_NO_ATOMIC
+    // The Module must not be modified while its contexts are running, so no other context is using the old states.
+    if (LoadShared(table.FunctionsVersion) != m_Module.Functions.Version())
+        table.Reset(m_Module.Functions.Size(), m_Module.Functions.Version());
+
+    // Another context may have copied the code while this one was waiting.
+    FunctionState& state = table.States[funcIdx];
+    if (!LoadShared(state.Code)) {
+        state.QuickenedCode = m_Module.Functions.Get()[funcIdx].Code;
+        StoreShared(state.Code, state.QuickenedCode.Data());
+    }
+    return &state;
+}
+
+Pulsar::CompiledFunction::EntryPoint Pulsar::ExecutionContext::GetCompiledEntryPoint(FunctionState& state, const FunctionDefinition& function)
+{
+    CompiledFunction::EntryPoint entryPoint = LoadShared(state.CompiledEntryPoint);
+    if (entryPoint || !m_Compiler || LoadShared(state.CompileAttempted))
+        return entryPoint;
+    if (++state.Hotness < m_CompileThreshold)
+        return nullptr;
+
+    // Compilation is only attempted once, by the first context which finds the function hot.
+    if (ExchangeShared(state.CompileAttempted, true))
+        return nullptr;
+    if (!function.Verified || function.MaxStackSize == 0)
+        return nullptr;
+    state.Compiled = m_Compiler->Compile(m_Module, function);
+    if (!state.Compiled)
+        return nullptr;
+    entryPoint = state.Compiled->GetEntryPoint();
+    StoreShared(state.CompiledEntryPoint, entryPoint);
+    return entryPoint;
+}
+
+void Pulsar::ExecutionContext::RunCompiledCode(CompiledFunction::EntryPoint entryPoint, Frame& frame)
+{
+    size_t maxStackSize = frame.Function->MaxStackSize;
+    if (frame.Stack.Size() > maxStackSize)
         return;
+
+    // Compiled code expects all the values it may push to be already constructed.
+    CompiledFrameState state;
+    state.StackSize = frame.Stack.Size();
+    state.InstructionIndex = frame.InstructionIndex;
+    frame.Stack.Resize(maxStackSize);
+    state.Locals = frame.Locals.Data();
+    state.Stack  = frame.Stack.Data();
+    state.StopRequested = m_StopRequested.Data();
+    state.Fuel = m_Fuel;
+
+    entryPoint(&state);
+
+    m_Fuel = state.Fuel;
+
+    frame.Stack.Resize(state.StackSize);
+    frame.InstructionIndex = state.InstructionIndex;
+}
+
+const Pulsar::RegisterFunction* Pulsar::ExecutionContext::GetRegisterFunction(FunctionState& state, const FunctionDefinition& function)
+{
+    if (!LoadShared(state.RegistersTranslated)) {
+#ifndef PULSAR_NO_ATOMIC
+        std::lock_guard lock(m_FunctionStates->Mutex);
+#endif // PULSAR_NO_ATOMIC
+        // Translation is only attempted once.
+        if (!LoadShared(state.RegistersTranslated)) {
+            RegisterTranslator translator;
+            translator.Translate(m_Module, function, state.Registers);
+            StoreShared(state.RegistersTranslated, true);
+        }
     }
+    return state.Registers.IsEmpty() ? nullptr : &state.Registers;
+}
 
-    for (size_t i = 0; i < returningFrame.Function->Returns; i++) {
-        size_t popIdx = returningFrame.Stack.Size()-returningFrame.Function->Returns+i;
-        callerStack.Push(std::move(returningFrame.Stack[popIdx]));
+void Pulsar::ExecutionContext::InternalStep()
+{
+    if (m_CallStack.CurrentFrame().Function->Verified) {
+        InternalExecute<true, true>();
+    } else {
+        InternalExecute<true, false>();
     }
+}
 
-    m_CallStack.PopFrame();
-    return;
+Pulsar::RuntimeState Pulsar::ExecutionContext::RunWithBudget(int64_t fuel, std::chrono::steady_clock::time_point deadline)
+{
+    if (m_Running || IsDone() || m_State != RuntimeState::OK)
+        return m_State;
+
+    m_Running = true;
+    m_Fuel = fuel;
+    m_Deadline = deadline;
+    Core::Allocator* oldAllocator = Core::SetThreadAllocator(m_Allocator.Get());
+    InternalRun();
+    Core::SetThreadAllocator(oldAllocator);
+    bool yielded = m_Fuel <= 0 && !IsDone() && m_State == RuntimeState::OK;
+    m_Fuel = FUEL_UNLIMITED;
+    m_Deadline = NO_DEADLINE;
+    m_Running = false;
+
+    if (m_StopRequested)
+        m_StopRequested = false;
+
+    return yielded ? RuntimeState::Yielded : m_State;
+}
+
+bool Pulsar::ExecutionContext::Refuel()
+{
+    if (m_Deadline == NO_DEADLINE || std::chrono::steady_clock::now() >= m_Deadline)
+        return false;
+    m_Fuel = DEADLINE_CHECK_INTERVAL;
+    return true;
+}
+
+void Pulsar::ExecutionContext::InternalRun()
+{
+    // InternalExecute returns when it enters a function which requires the other variant.
+    while (!IsDone() && m_State == RuntimeState::OK && !m_StopRequested) {
+        if (m_Fuel <= 0 && !Refuel())
+            break;
+        if (m_CallStack.CurrentFrame().Function->Verified) {
+            InternalExecute<false, true>();
+        } else {
+            InternalExecute<false, false>();
+        }
+    }
 }
 
-// Used within Pulsar::Module::ExecuteInstruction to implement type-checking instructions
+// Used within Pulsar::ExecutionContext::InternalExecute to implement type-checking instructions
 inline bool _InstrTypeCheck(Pulsar::InstructionCode instrCode, Pulsar::ValueType type)
 {
     switch (instrCode) {
@@ -270,608 +596,1339 @@ inline bool _InstrTypeCheck(Pulsar::InstructionCode instrCode, Pulsar::ValueType
     }
 }
 
-Pulsar::RuntimeState Pulsar::ExecutionContext::ExecuteInstruction(Frame& frame)
+// Used to implement bit shifts, negative shifts are shifts in the opposite direction.
+// See "Built-in bitwise shift operators" for the undefined behaviour that's being handled:
+//   https://en.cppreference.com/w/cpp/language/operator_arithmetic
+inline int64_t _InstrShiftLeft(int64_t a, int64_t b)
+{
+    constexpr int64_t BITS_OF_INT = 8*sizeof(a);
+    if (b <= -BITS_OF_INT || b >= BITS_OF_INT)
+        return 0;
+    else if (b < 0)
+        return (int64_t)((uint64_t)a >> -b);
+    return (int64_t)((uint64_t)a << b);
+}
+
+inline int64_t _InstrShiftRight(int64_t a, int64_t b)
+{
+    constexpr int64_t BITS_OF_INT = 8*sizeof(a);
+    if (b <= -BITS_OF_INT || b >= BITS_OF_INT)
+        return 0;
+    else if (b < 0)
+        return (int64_t)((uint64_t)a << -b);
+    return (int64_t)((uint64_t)a >> b);
+}
+
+// Used within Pulsar::ExecutionContext::RunRegisterCode to implement arithmetic instructions
+template<typename T>
+inline T _RegisterArithmetic(Pulsar::RegisterOpCode code, T a, T b)
+{
+    switch (code) {
+    case Pulsar::RegisterOpCode::Sum:
+        return a + b;
+    case Pulsar::RegisterOpCode::Sub:
+        return a - b;
+    case Pulsar::RegisterOpCode::Mul:
+        return a * b;
+    case Pulsar::RegisterOpCode::Div:
+        return a / b;
+    default:
+        return T(0);
+    }
+}
+
+/*
+Registers are the Locals of the frame followed by the slots of its Stack,
+ which is resized to the max size of the function so that all of them are constructed.
+Instructions are dispatched with a switch since most of the common ones are fused together
+ and the amount of instructions executed per loop iteration is lower than the stack interpreter's.
+
+RegisterOpCode::Step runs a single instruction with the stack interpreter.
+The Stack is resized to its expected depth before the instruction and is expected to have
+ the depth of the instruction the execution continues at, otherwise the stack interpreter takes over.
+*/
+
+#define PULSAR_VM_REGISTER(reg) \
+    (registers[RegisterFunction::IsStackRegister(reg) ? 1 : 0][RegisterFunction::RegisterIndex(reg)])
+// Returns to the stack interpreter, which continues from the instruction at index `instrIdx`.
+#define PULSAR_VM_REGISTER_EXIT(instrIdx)                          \
+    do {                                                           \
+        frame.Stack.Resize(function.StackDepths[(instrIdx)]);      \
+        frame.InstructionIndex = (instrIdx);                       \
+        return;                                                    \
+    } while (0)
+// Stops execution with the specified error, the error is reported like the stack interpreter does.
+#define PULSAR_VM_REGISTER_ERROR(state)                            \
+    do {                                                           \
+        m_State = (state);                                         \
+        frame.Stack.Resize(function.StackDepths[instr->Source]);   \
+        frame.InstructionIndex = instr->Source+1;                  \
+        return;                                                    \
+    } while (0)
+// Jumps to the target of the current instruction.
+#define PULSAR_VM_REGISTER_JUMP() goto _VMRegisterJump
+
+void Pulsar::ExecutionContext::RunRegisterCode(const RegisterFunction& function, Frame& frame)
+{
+    size_t instrIdx = frame.InstructionIndex;
+    if (instrIdx >= function.EntryPoints.Size() || function.EntryPoints[instrIdx] == RegisterFunction::NO_ENTRY)
+        return;
+    if (frame.Stack.Size() != function.StackDepths[instrIdx])
+        return;
+
+    const RegisterInstruction* code  = function.Code.Data();
+    const RegisterInstruction* instr = code + function.EntryPoints[instrIdx];
+    frame.Stack.Resize(function.MaxStackSize);
+    Value* registers[2] = { frame.Locals.Data(), frame.Stack.Data() };
+
+    while (true) {
+        switch (instr->Code) {
+        case RegisterOpCode::Step: {
+            frame.Stack.Resize(function.StackDepths[instr->Source]);
+            frame.InstructionIndex = instr->Source;
+            size_t callDepth = m_CallStack.Size();
+            InternalExecute<true, true>();
+            // A fast native pushed its Frame, `frame` may have been moved, or it stopped the context.
+            if (m_CallStack.Size() != callDepth || m_State != RuntimeState::OK || m_StopRequested)
+                return;
+
+            size_t nextIdx = frame.InstructionIndex;
+            if (function.EntryPoints[nextIdx] == RegisterFunction::NO_ENTRY
+                || frame.Stack.Size() != function.StackDepths[nextIdx])
+                return;
+            frame.Stack.Resize(function.MaxStackSize);
+            registers[1] = frame.Stack.Data();
+            instr = code + function.EntryPoints[nextIdx];
+        } continue;
+        case RegisterOpCode::Exit:
+            PULSAR_VM_REGISTER_EXIT(instr->Source);
+        case RegisterOpCode::LoadInt:
+            PULSAR_VM_REGISTER(instr->Dst).SetInteger(instr->Imm);
+            break;
+        case RegisterOpCode::LoadDbl: {
+            const void* immAsVoid     = reinterpret_cast<const void*>(&instr->Imm);
+            const double* immAsDouble = reinterpret_cast<const double*>(immAsVoid);
+            PULSAR_VM_REGISTER(instr->Dst).SetDouble(*immAsDouble);
+        } break;
+        case RegisterOpCode::LoadFunctionReference:
+            PULSAR_VM_REGISTER(instr->Dst).SetFunctionReference(instr->Imm);
+            break;
+        case RegisterOpCode::LoadNativeFunctionReference:
+            PULSAR_VM_REGISTER(instr->Dst).SetNativeFunctionReference(instr->Imm);
+            break;
+        case RegisterOpCode::LoadConst:
+            PULSAR_VM_REGISTER(instr->Dst) = m_Module.Constants[(size_t)instr->Imm];
+            break;
+        case RegisterOpCode::Copy:
+            if (instr->Dst != instr->A)
+                PULSAR_VM_REGISTER(instr->Dst) = PULSAR_VM_REGISTER(instr->A);
+            break;
+        case RegisterOpCode::Move:
+            if (instr->Dst != instr->A)
+                PULSAR_VM_REGISTER(instr->Dst) = std::move(PULSAR_VM_REGISTER(instr->A));
+            break;
+        case RegisterOpCode::Swap: {
+            Value tmp(std::move(PULSAR_VM_REGISTER(instr->Dst)));
+            PULSAR_VM_REGISTER(instr->Dst) = std::move(PULSAR_VM_REGISTER(instr->A));
+            PULSAR_VM_REGISTER(instr->A) = std::move(tmp);
+        } break;
+        case RegisterOpCode::Reset:
+            PULSAR_VM_REGISTER(instr->Dst).SetVoid();
+            break;
+        case RegisterOpCode::Sum:
+        case RegisterOpCode::Sub:
+        case RegisterOpCode::Mul:
+        case RegisterOpCode::Div: {
+            const Value& a = PULSAR_VM_REGISTER(instr->A);
+            const Value& b = PULSAR_VM_REGISTER(instr->B);
+            if (a.Type() == ValueType::Integer && b.Type() == ValueType::Integer) {
+                int64_t res = _RegisterArithmetic(instr->Code, a.AsInteger(), b.AsInteger());
+                PULSAR_VM_REGISTER(instr->Dst).SetInteger(res);
+            } else if (IsNumericValueType(a.Type()) && IsNumericValueType(b.Type())) {
+                double aVal = a.Type() == ValueType::Double ? a.AsDouble() : (double)a.AsInteger();
+                double bVal = b.Type() == ValueType::Double ? b.AsDouble() : (double)b.AsInteger();
+                PULSAR_VM_REGISTER(instr->Dst).SetDouble(_RegisterArithmetic(instr->Code, aVal, bVal));
+            } else PULSAR_VM_REGISTER_ERROR(RuntimeState::TypeError);
+        } break;
+        case RegisterOpCode::Mod:
+        case RegisterOpCode::BitAnd:
+        case RegisterOpCode::BitOr:
+        case RegisterOpCode::BitXor:
+        case RegisterOpCode::BitShiftLeft:
+        case RegisterOpCode::BitShiftRight: {
+            const Value& a = PULSAR_VM_REGISTER(instr->A);
+            const Value& b = PULSAR_VM_REGISTER(instr->B);
+            if (a.Type() != ValueType::Integer || b.Type() != ValueType::Integer)
+                PULSAR_VM_REGISTER_ERROR(RuntimeState::TypeError);
+            int64_t aVal = a.AsInteger();
+            int64_t bVal = b.AsInteger();
+            int64_t res = 0;
+            switch (instr->Code) {
+            case RegisterOpCode::Mod:    res = aVal % bVal; break;
+            case RegisterOpCode::BitAnd: res = aVal & bVal; break;
+            case RegisterOpCode::BitOr:  res = aVal | bVal; break;
+            case RegisterOpCode::BitXor: res = aVal ^ bVal; break;
+            case RegisterOpCode::BitShiftLeft: res = _InstrShiftLeft(aVal, bVal); break;
+            default: res = _InstrShiftRight(aVal, bVal); break;
+            }
+            PULSAR_VM_REGISTER(instr->Dst).SetInteger(res);
+        } break;
+        case RegisterOpCode::Compare: {
+            const Value& a = PULSAR_VM_REGISTER(instr->A);
+            const Value& b = PULSAR_VM_REGISTER(instr->B);
+            if (a.Type() == ValueType::Integer && b.Type() == ValueType::Integer) {
+                PULSAR_VM_REGISTER(instr->Dst).SetInteger(a.AsInteger() - b.AsInteger());
+            } else if (IsNumericValueType(a.Type()) && IsNumericValueType(b.Type())) {
+                double aVal = a.Type() == ValueType::Double ? a.AsDouble() : (double)a.AsInteger();
+                double bVal = b.Type() == ValueType::Double ? b.AsDouble() : (double)b.AsInteger();
+                PULSAR_VM_REGISTER(instr->Dst).SetDouble(aVal - bVal);
+            } else if (a.Type() == ValueType::String && b.Type() == ValueType::String) {
+                int64_t res = a.AsString().Compare(b.AsString());
+                PULSAR_VM_REGISTER(instr->Dst).SetInteger(res);
+            } else PULSAR_VM_REGISTER_ERROR(RuntimeState::TypeError);
+        } break;
+        case RegisterOpCode::Equals: {
+            int64_t areEqual = PULSAR_VM_REGISTER(instr->A) == PULSAR_VM_REGISTER(instr->B) ? 1 : 0;
+            PULSAR_VM_REGISTER(instr->Dst).SetInteger(areEqual);
+        } break;
+        case RegisterOpCode::BitNot: {
+            const Value& a = PULSAR_VM_REGISTER(instr->A);
+            if (a.Type() != ValueType::Integer)
+                PULSAR_VM_REGISTER_ERROR(RuntimeState::TypeError);
+            PULSAR_VM_REGISTER(instr->Dst).SetInteger(~a.AsInteger());
+        } break;
+        case RegisterOpCode::Floor:
+        case RegisterOpCode::Ceil: {
+            const Value& a = PULSAR_VM_REGISTER(instr->A);
+            if (a.Type() == ValueType::Integer) {
+                PULSAR_VM_REGISTER(instr->Dst).SetInteger(a.AsInteger());
+            } else if (a.Type() == ValueType::Double) {
+                double res = instr->Code == RegisterOpCode::Floor ? std::floor(a.AsDouble()) : std::ceil(a.AsDouble());
+                PULSAR_VM_REGISTER(instr->Dst).SetInteger((int64_t)res);
+            } else PULSAR_VM_REGISTER_ERROR(RuntimeState::TypeError);
+        } break;
+        case RegisterOpCode::Length:
+        case RegisterOpCode::IsEmpty: {
+            const Value& a = PULSAR_VM_REGISTER(instr->A);
+            int64_t length;
+            if (a.Type() == ValueType::List) {
+                length = (int64_t)a.AsList().Length();
+            } else if (a.Type() == ValueType::String) {
+                length = (int64_t)a.AsString().Length();
+            } else PULSAR_VM_REGISTER_ERROR(RuntimeState::TypeError);
+            if (instr->Code == RegisterOpCode::IsEmpty)
+                PULSAR_VM_REGISTER(instr->Dst).SetInteger(length == 0 ? 1 : 0);
+            else PULSAR_VM_REGISTER(instr->Dst).SetInteger(length);
+        } break;
+        case RegisterOpCode::TypeCheck: {
+            bool matches = _InstrTypeCheck(instr->Condition, PULSAR_VM_REGISTER(instr->A).Type());
+            PULSAR_VM_REGISTER(instr->Dst).SetInteger(matches ? 1 : 0);
+        } break;
+        case RegisterOpCode::Increment:
+        case RegisterOpCode::Decrement: {
+            Value& local = PULSAR_VM_REGISTER(instr->Dst);
+            int64_t delta = instr->Code == RegisterOpCode::Increment ? 1 : -1;
+            if (local.Type() == ValueType::Integer) {
+                local.SetInteger(local.AsInteger() + delta);
+            } else if (local.Type() == ValueType::Double) {
+                local.SetDouble(local.AsDouble() + (double)delta);
+            } else PULSAR_VM_REGISTER_ERROR(RuntimeState::TypeError);
+        } break;
+        case RegisterOpCode::Jump:
+            PULSAR_VM_REGISTER_JUMP();
+        case RegisterOpCode::JumpIf: {
+            const Value& truthValue = PULSAR_VM_REGISTER(instr->A);
+            if (truthValue.Type() == ValueType::Integer) {
+                if (ShouldJump(instr->Condition, truthValue.AsInteger()))
+                    PULSAR_VM_REGISTER_JUMP();
+            } else if (truthValue.Type() == ValueType::Double) {
+                if (ShouldJump(instr->Condition, truthValue.AsDouble()))
+                    PULSAR_VM_REGISTER_JUMP();
+            } else PULSAR_VM_REGISTER_ERROR(RuntimeState::TypeError);
+        } break;
+        case RegisterOpCode::CompareJump: {
+            const Value& a = PULSAR_VM_REGISTER(instr->A);
+            const Value& b = PULSAR_VM_REGISTER(instr->B);
+            bool shouldJump;
+            if (a.Type() == ValueType::Integer && b.Type() == ValueType::Integer) {
+                shouldJump = ShouldJump(instr->Condition, a.AsInteger() - b.AsInteger());
+            } else if (IsNumericValueType(a.Type()) && IsNumericValueType(b.Type())) {
+                double aVal = a.Type() == ValueType::Double ? a.AsDouble() : (double)a.AsInteger();
+                double bVal = b.Type() == ValueType::Double ? b.AsDouble() : (double)b.AsInteger();
+                shouldJump = ShouldJump(instr->Condition, aVal - bVal);
+            } else if (a.Type() == ValueType::String && b.Type() == ValueType::String) {
+                shouldJump = ShouldJump(instr->Condition, a.AsString().Compare(b.AsString()));
+            } else PULSAR_VM_REGISTER_ERROR(RuntimeState::TypeError);
+            if (shouldJump)
+                PULSAR_VM_REGISTER_JUMP();
+        } break;
+        case RegisterOpCode::EqualsJump: {
+            int64_t areEqual = PULSAR_VM_REGISTER(instr->A) == PULSAR_VM_REGISTER(instr->B) ? 1 : 0;
+            if (ShouldJump(instr->Condition, areEqual))
+                PULSAR_VM_REGISTER_JUMP();
+        } break;
+        }
+        ++instr;
+        continue;
+
+    _VMRegisterJump: {
+        // Stop requests are checked on backward jumps, like the stack interpreter does.
+        const RegisterInstruction* target = code + instr->Imm;
+        if (target <= instr && ((m_Fuel -= (instr-target)+1) <= 0 || m_StopRequested))
+            PULSAR_VM_REGISTER_EXIT(instr->Dst);
+        instr = target;
+    }
+    }
+}
+
+#undef PULSAR_VM_REGISTER_JUMP
+#undef PULSAR_VM_REGISTER_ERROR
+#undef PULSAR_VM_REGISTER_EXIT
+#undef PULSAR_VM_REGISTER
+
+/*
+The interpreter loop is written once and instantiated for each combination of:
+- SingleStep: if true, a single instruction is executed (or a finished frame is returned from).
+              Otherwise, it runs until the CallStack is empty, an error occurs, a stop is requested
+              or a function with a different Verified flag is entered.
+- Verified: if true, checks proven by the Verifier are compiled out.
+
+The current frame, its code and the instruction index are kept in locals and are only
+ written back to the CallStack when a function is called, an error occurs or execution stops.
+The Frame pointer MUST be reloaded whenever the CallStack may have changed (i.e. after a call).
+
+Generic arithmetic and comparison instructions rewrite themselves into type-specialized ones
+ within the copy of the code shared by this context and its forks (see GetFunctionState).
+Specialized instructions rewrite themselves back to the generic ones on a type miss
+ and set Arg0 to 1, which prevents them from being quickened again.
+
+If a FunctionCompiler is set or the register engine is selected, the non-stepping verified variant
+ also runs compiled code or register code (see RunRegisterCode), in this order of preference.
+They're entered whenever a frame is (re-)entered or a backward jump is performed, the interpreter
+ then continues from the instruction where they stopped.
+
+On GCC and Clang instructions are dispatched through a table of label addresses (direct threading),
+ which allows the compiler to give each instruction its own indirect jump.
+Define PULSAR_NO_COMPUTED_GOTO to always use the switch-based dispatch.
+*/
+
+#if !defined(PULSAR_NO_COMPUTED_GOTO) && (defined(__GNUC__) || defined(__clang__))
+  #define PULSAR_VM_COMPUTED_GOTO
+#endif // PULSAR_NO_COMPUTED_GOTO
+
+#ifdef PULSAR_VM_COMPUTED_GOTO
+  #define PULSAR_VM_CASE(instrCode) \
+      case InstructionCode::instrCode: _VMInstr_##instrCode
+
+  // Instruction codes are 8-bit wide, the i-th entry is the instruction whose code is i.
+  // I(instrCode) is a known instruction, U is an unknown code (a no-op).
+  #define PULSAR_VM_DISPATCH_TABLE(I, U) \
+    /* 0x00 */ U I(PushInt) I(PushDbl) I(PushFunctionReference) I(PushNativeFunctionReference) I(PushEmptyList) I(Pack) U U U U U U I(Pop) I(Swap) I(Dup) \
+    /* 0x10 */ I(PushConst) I(PushLocal) I(MoveLocal) I(PopIntoLocal) I(CopyIntoLocal) I(PushGlobal) I(MoveGlobal) I(PopIntoGlobal) I(CopyIntoGlobal) U U U U U U U \
+    /* 0x20 */ I(Return) I(Call) I(CallNative) I(TailCall) U U U U U U U U U U I(ITailCall) I(ICall) \
+    /* 0x30 */ I(DynSum) I(DynSub) I(DynMul) I(DynDiv) I(Mod) U U U I(BitAnd) I(BitOr) I(BitNot) I(BitXor) I(BitShiftLeft) I(BitShiftRight) U U \
+    /* 0x40 */ I(Floor) I(Ceil) U U U U U U U U U U U U U U \
+    /* 0x50 */ I(Compare) I(Equals) U U U U U U U U U U U U U U \
+    /* 0x60 */ I(J) I(JZ) I(JNZ) I(JGZ) I(JGEZ) I(JLZ) I(JLEZ) U U U U U U U U U \
+    /* 0x70 */ I(IsEmpty) I(Length) I(Prepend) I(Append) I(Index) U U U I(Concat) I(Head) I(Tail) I(Unpack) I(Prefix) I(Suffix) I(Substr) U \
+    /* 0x80 */ I(IsVoid) I(IsInteger) I(IsDouble) I(IsFunctionReference) I(IsNativeFunctionReference) I(IsList) I(IsString) U U U U U U U U I(IsCustom) \
+    /* 0x90 */ I(IsNumber) I(IsAnyFunctionReference) U U U U U U U U U U U U U U \
+    /* 0xA0 */ I(IncLocal) I(DecLocal) I(PushLocal2) I(PushConstAppend) I(DupJZ) U U U I(CompareJGZ) I(CompareJGEZ) I(CompareJLZ) I(CompareJLEZ) I(EqualsJZ) I(EqualsJNZ) U U \
+    /* 0xB0 */ I(SumII) I(SumDD) I(SubII) I(SubDD) I(MulII) I(MulDD) I(DivII) I(DivDD) I(CompareII) I(CompareDD) U U U U U U \
+    /* 0xC0 */ U U U U U U U U U U U U U U U U \
+    /* 0xD0 */ U U U U U U U U U U U U U U U U \
+    /* 0xE0 */ U U U U U U U U U U U U U U U U \
+    /* 0xF0 */ U U U U U U U U U U U U U U U U
+
+  #define PULSAR_VM_DISPATCH_LABEL(instrCode) &&_VMInstr_##instrCode,
+  #define PULSAR_VM_DISPATCH_UNKNOWN &&_VMInstrUnknown,
+  #define PULSAR_VM_DISPATCH_CODE(instrCode) (int)Pulsar::InstructionCode::instrCode,
+  #define PULSAR_VM_DISPATCH_NO_CODE -1,
+
+// Checks that every entry of PULSAR_VM_DISPATCH_TABLE is at the index of its code.
+static constexpr bool IsDispatchTableOrdered()
+{
+    constexpr int codes[] = { PULSAR_VM_DISPATCH_TABLE(PULSAR_VM_DISPATCH_CODE, PULSAR_VM_DISPATCH_NO_CODE) };
+    if (sizeof(codes)/sizeof(codes[0]) != 256)
+        return false;
+    for (int i = 0; i < 256; i++) {
+        if (codes[i] != -1 && codes[i] != i)
+            return false;
+    }
+    return true;
+}
+
+static_assert(IsDispatchTableOrdered(), "PULSAR_VM_DISPATCH_TABLE does not match Pulsar::InstructionCode.");
+#else // PULSAR_VM_COMPUTED_GOTO
+  #define PULSAR_VM_CASE(instrCode) \
+      case InstructionCode::instrCode: _VMInstr_##instrCode
+#endif // PULSAR_VM_COMPUTED_GOTO
+
+#ifdef PULSAR_NO_ATOMIC
+static Pulsar::InstructionCode LoadInstructionCode(const Pulsar::Instruction& instr) { return instr.Code; }
+static int64_t LoadInstructionArg0(const Pulsar::Instruction& instr)               { return instr.Arg0; }
+static void StoreInstructionCode(Pulsar::Instruction& instr, Pulsar::InstructionCode code) { instr.Code = code; }
+static void StoreInstructionArg0(Pulsar::Instruction& instr, int64_t arg0)                 { instr.Arg0 = arg0; }
+#else // PULSAR_NO_ATOMIC
+// Quickened code is shared with forks, which may rewrite the same instructions on other threads.
+// Rewritten fields are accessed atomically, relaxed accesses are plain loads and stores on most targets.
+// A context may see an instruction which another one has just rewritten, which is fine since all of them are correct.
+static Pulsar::InstructionCode LoadInstructionCode(const Pulsar::Instruction& instr)
+{
+    return std::atomic_ref(const_cast<Pulsar::InstructionCode&>(instr.Code)).load(std::memory_order_relaxed);
+}
+
+static int64_t LoadInstructionArg0(const Pulsar::Instruction& instr)
+{
+    return std::atomic_ref(const_cast<int64_t&>(instr.Arg0)).load(std::memory_order_relaxed);
+}
+
+static void StoreInstructionCode(Pulsar::Instruction& instr, Pulsar::InstructionCode code)
 {
-    const Instruction& instr = frame.Function->Code[frame.InstructionIndex++];
-    switch (instr.Code) {
-    case InstructionCode::PushInt:
-        frame.Stack.EmplaceInteger(instr.Arg0);
-        break;
-    case InstructionCode::PushDbl: {
+    std::atomic_ref(instr.Code).store(code, std::memory_order_relaxed);
+}
+
+static void StoreInstructionArg0(Pulsar::Instruction& instr, int64_t arg0)
+{
+    std::atomic_ref(instr.Arg0).store(arg0, std::memory_order_relaxed);
+}
+#endif // PULSAR_NO_ATOMIC
+
+#define PULSAR_VM_LOAD_FRAME()                                                 \
+    do {                                                                       \
+        frame         = &m_CallStack.CurrentFrame();                           \
+        functionState = GetFunctionState(*frame->Function);                    \
+        quickenedCode = functionState ? functionState->QuickenedCode.Data() : nullptr; \
+        code          = quickenedCode ? quickenedCode : frame->Function->Code.Data(); \
+        codeSize      = frame->Function->Code.Size();                          \
+        ip            = frame->InstructionIndex;                               \
+    } while (0)
+
+#define PULSAR_VM_SAVE_IP() (frame->InstructionIndex = ip)
+
+// Executes the next instruction.
+#define PULSAR_VM_NEXT() goto _VMNext
+// Stops execution with the specified error.
+#define PULSAR_VM_ERROR(state) \
+    do { m_State = (state); goto _VMExit; } while (0)
+// Checks proven by the Verifier, they're compiled out when running verified functions.
+#define PULSAR_VM_VERIFIED_CHECK(failCond, state)    \
+    do {                                             \
+        if constexpr (!Verified) {                   \
+            if (failCond) PULSAR_VM_ERROR(state);    \
+        }                                            \
+    } while (0)
+// Must be used after a new frame was pushed onto the CallStack.
+#define PULSAR_VM_CALLED() goto _VMCalled
+// Must be used after a native function was called, its return value must be stored into m_State.
+#define PULSAR_VM_NATIVE_CALLED() goto _VMNativeCalled
+// Calls a fast native without pushing its Frame, unless it asks for one or fails.
+#define PULSAR_VM_CALL_FAST_NATIVE(nativeIdx)                                           \
+    do {                                                                                \
+        const FunctionDefinition& native = m_Module.NativeBindings[nativeIdx];          \
+        if (frame->Stack.Size() < native.StackArity + native.Arity)                     \
+            PULSAR_VM_ERROR(RuntimeState::StackUnderflow);                              \
+        PULSAR_VM_SAVE_IP();                                                            \
+        if (CallFastNative((nativeIdx), frame->Stack))                                  \
+            PULSAR_VM_NATIVE_CALLED();                                                  \
+        if (m_StopRequested) goto _VMExit;                                              \
+        PULSAR_VM_NEXT();                                                               \
+    } while (0)
+// Rewrites the current instruction into a specialized one, if it can be quickened.
+#define PULSAR_VM_QUICKEN(instrCode)                               \
+    do {                                                           \
+        if (quickenedCode && LoadInstructionArg0(*instr) == 0)     \
+            StoreInstructionCode(quickenedCode[ip-1], InstructionCode::instrCode); \
+    } while (0)
+// Rewrites the current instruction back into the generic one and executes it.
+#define PULSAR_VM_DEQUICKEN(instrCode)                                 \
+    do {                                                               \
+        if (quickenedCode) {                                           \
+            StoreInstructionArg0(quickenedCode[ip-1], 1);              \
+            StoreInstructionCode(quickenedCode[ip-1], InstructionCode::instrCode); \
+        }                                                              \
+        goto _VMInstr_##instrCode;                                     \
+    } while (0)
+// Implements a quickened binary operation on two values of the same type.
+#define PULSAR_VM_QUICKENED_BINARY_OP(genericCode, valueType, getter, setter, op) \
+    do {                                                                          \
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow); \
+        Value& a = frame->Stack[-2];                                              \
+        const Value& b = frame->Stack[-1];                                        \
+        if (a.Type() != ValueType::valueType || b.Type() != ValueType::valueType) \
+            PULSAR_VM_DEQUICKEN(genericCode);                                     \
+        a.setter(a.getter() op b.getter());                                       \
+        frame->Stack.Resize(frame->Stack.Size()-1);                               \
+    } while (0)
+// Jumps relative to the current instruction.
+// Backward jumps are the only way to loop without calling a function,
+//  so they're also the place where stop requests and the budget are checked.
+#define PULSAR_VM_JUMP(offset)                                            \
+    do {                                                                  \
+        ip = (size_t)((ip-1) + (offset));                                 \
+        if ((offset) <= 0) {                                              \
+            m_Fuel -= 1-(int64_t)(offset);                                \
+            if (m_Fuel <= 0 || m_StopRequested) goto _VMExit;             \
+            if constexpr (!SingleStep && Verified) {                      \
+                if (m_Compiler || m_Engine == ExecutionEngine::Register)  \
+                    goto _VMRunTiers;                                     \
+            }                                                             \
+        }                                                                 \
+        goto _VMNext;                                                     \
+    } while (0)
+
+#pragma GCC diagnostic push
+// Not all labels are used by both instantiations.
+#pragma GCC diagnostic ignored "-Wunused-label"
+#ifdef PULSAR_VM_COMPUTED_GOTO
+  #pragma GCC diagnostic ignored "-Wpedantic"
+  #ifdef __clang__
+    #pragma GCC diagnostic ignored "-Wgnu-label-as-value"
+  #endif // __clang__
+#endif // PULSAR_VM_COMPUTED_GOTO
+
+template<bool SingleStep, bool Verified>
+void Pulsar::ExecutionContext::InternalExecute()
+{
+#ifdef PULSAR_VM_COMPUTED_GOTO
+    // Built once by the compiler, entering the interpreter doesn't touch it.
+    static void* const dispatchTable[256] = {
+        PULSAR_VM_DISPATCH_TABLE(PULSAR_VM_DISPATCH_LABEL, PULSAR_VM_DISPATCH_UNKNOWN)
+    };
+#endif // PULSAR_VM_COMPUTED_GOTO
+
+    Frame* frame;
+    FunctionState* functionState;
+    // The copy of the code shared with forks, nullptr if it can't be quickened.
+    Instruction* quickenedCode;
+    const Instruction* code;
+    size_t codeSize;
+    size_t ip;
+    const Instruction* instr;
+
+_VMEnterFrame:
+    PULSAR_VM_LOAD_FRAME();
+    // Let the caller select the right variant. Finished frames can be returned from by both.
+    if (frame->Function->Verified != Verified && ip < codeSize)
+        return;
+    if constexpr (SingleStep) {
+        if (ip < codeSize) goto _VMFetch;
+        goto _VMFrameEnd;
+    } else if (Verified && (m_Compiler || m_Engine == ExecutionEngine::Register)) {
+        goto _VMRunTiers;
+    }
+
+_VMNext:
+    if constexpr (SingleStep) {
+        goto _VMExit;
+    } else if (ip >= codeSize) {
+        goto _VMFrameEnd;
+    }
+
+_VMFetch:
+    instr = &code[ip++];
+#ifdef PULSAR_VM_COMPUTED_GOTO
+    if constexpr (!SingleStep)
+        goto *dispatchTable[(size_t)LoadInstructionCode(*instr)];
+#endif // PULSAR_VM_COMPUTED_GOTO
+
+    switch (LoadInstructionCode(*instr)) {
+    PULSAR_VM_CASE(PushInt):
+        frame->Stack.EmplaceInteger(instr->Arg0);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(PushDbl): {
         static_assert(sizeof(double) == sizeof(int64_t));
-        const void* arg0AsVoid     = reinterpret_cast<const void*>(&instr.Arg0);
+        const void* arg0AsVoid     = reinterpret_cast<const void*>(&instr->Arg0);
         const double* arg0AsDouble = reinterpret_cast<const double*>(arg0AsVoid);
-        frame.Stack.EmplaceDouble(*arg0AsDouble);
+        frame->Stack.EmplaceDouble(*arg0AsDouble);
         // Don't want to rely on std::bit_cast since my g++ does not have it.
-    } break;
-    case InstructionCode::PushFunctionReference:
-        frame.Stack.EmplaceFunctionReference(instr.Arg0);
-        break;
-    case InstructionCode::PushNativeFunctionReference:
-        frame.Stack.EmplaceNativeFunctionReference(instr.Arg0);
-        break;
-    case InstructionCode::PushConst:
-        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= m_Module.Constants.Size())
-            return RuntimeState::OutOfBoundsConstantIndex;
-        frame.Stack.Push(m_Module.Constants[(size_t)instr.Arg0]);
-        break;
-    case InstructionCode::PushLocal:
-        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= frame.Locals.Size())
-            return RuntimeState::OutOfBoundsLocalIndex;
-        frame.Stack.Push(frame.Locals[(size_t)instr.Arg0]);
-        break;
-    case InstructionCode::MoveLocal:
-        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= frame.Locals.Size())
-            return RuntimeState::OutOfBoundsLocalIndex;
-        frame.Stack.Push(std::move(frame.Locals[(size_t)instr.Arg0]));
-        break;
-    case InstructionCode::PopIntoLocal:
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= frame.Locals.Size())
-            return RuntimeState::OutOfBoundsLocalIndex;
-        frame.Locals[(size_t)instr.Arg0] = frame.Stack.Pop();
-        break;
-    case InstructionCode::CopyIntoLocal:
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= frame.Locals.Size())
-            return RuntimeState::OutOfBoundsLocalIndex;
-        frame.Locals[(size_t)instr.Arg0] = frame.Stack.Top();
-        break;
-    case InstructionCode::PushGlobal:
-        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= m_Globals.Size())
-            return RuntimeState::OutOfBoundsGlobalIndex;
-        frame.Stack.Push(m_Globals[(size_t)instr.Arg0].Value);
-        break;
-    case InstructionCode::MoveGlobal: {
-        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= m_Globals.Size())
-            return RuntimeState::OutOfBoundsGlobalIndex;
-        GlobalInstance& global = m_Globals[(size_t)instr.Arg0];
-        if (global.IsConstant)
-            return RuntimeState::WritingOnConstantGlobal;
-        frame.Stack.Push(std::move(global.Value));
-    } break;
-    case InstructionCode::PopIntoGlobal: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= m_Globals.Size())
-            return RuntimeState::OutOfBoundsGlobalIndex;
-        GlobalInstance& global = m_Globals[(size_t)instr.Arg0];
-        if (global.IsConstant)
-            return RuntimeState::WritingOnConstantGlobal;
-        global.Value = frame.Stack.Pop();
-    } break;
-    case InstructionCode::CopyIntoGlobal: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= m_Globals.Size())
-            return RuntimeState::OutOfBoundsGlobalIndex;
-        GlobalInstance& global = m_Globals[(size_t)instr.Arg0];
-        if (global.IsConstant)
-            return RuntimeState::WritingOnConstantGlobal;
-        global.Value = frame.Stack.Top();
-    } break;
-    case InstructionCode::Pack: {
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(PushFunctionReference):
+        frame->Stack.EmplaceFunctionReference(instr->Arg0);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(PushNativeFunctionReference):
+        frame->Stack.EmplaceNativeFunctionReference(instr->Arg0);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(PushConst):
+        PULSAR_VM_VERIFIED_CHECK(instr->Arg0 < 0 || (size_t)instr->Arg0 >= m_Module.Constants.Size(), RuntimeState::OutOfBoundsConstantIndex);
+        frame->Stack.Push(m_Module.Constants[(size_t)instr->Arg0]);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(PushLocal):
+        PULSAR_VM_VERIFIED_CHECK(instr->Arg0 < 0 || (size_t)instr->Arg0 >= frame->Locals.Size(), RuntimeState::OutOfBoundsLocalIndex);
+        frame->Stack.Push(frame->Locals[(size_t)instr->Arg0]);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(MoveLocal):
+        PULSAR_VM_VERIFIED_CHECK(instr->Arg0 < 0 || (size_t)instr->Arg0 >= frame->Locals.Size(), RuntimeState::OutOfBoundsLocalIndex);
+        frame->Stack.Push(std::move(frame->Locals[(size_t)instr->Arg0]));
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(PopIntoLocal):
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        PULSAR_VM_VERIFIED_CHECK(instr->Arg0 < 0 || (size_t)instr->Arg0 >= frame->Locals.Size(), RuntimeState::OutOfBoundsLocalIndex);
+        frame->Locals[(size_t)instr->Arg0] = frame->Stack.Pop();
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(CopyIntoLocal):
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        PULSAR_VM_VERIFIED_CHECK(instr->Arg0 < 0 || (size_t)instr->Arg0 >= frame->Locals.Size(), RuntimeState::OutOfBoundsLocalIndex);
+        frame->Locals[(size_t)instr->Arg0] = frame->Stack.Top();
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(PushGlobal):
+        // The Verifier only checks the Globals of the Module, which may not have been initialized by this context.
+        if (instr->Arg0 < 0 || (size_t)instr->Arg0 >= m_Globals->Size())
+            PULSAR_VM_ERROR(RuntimeState::OutOfBoundsGlobalIndex);
+        frame->Stack.Push((*m_Globals)[(size_t)instr->Arg0].Value);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(MoveGlobal): {
+        if (instr->Arg0 < 0 || (size_t)instr->Arg0 >= m_Globals->Size())
+            PULSAR_VM_ERROR(RuntimeState::OutOfBoundsGlobalIndex);
+        PULSAR_VM_VERIFIED_CHECK((*m_Globals)[(size_t)instr->Arg0].IsConstant, RuntimeState::WritingOnConstantGlobal);
+        GlobalInstance& global = OwnGlobals()[(size_t)instr->Arg0];
+        frame->Stack.Push(std::move(global.Value));
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(PopIntoGlobal): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        if (instr->Arg0 < 0 || (size_t)instr->Arg0 >= m_Globals->Size())
+            PULSAR_VM_ERROR(RuntimeState::OutOfBoundsGlobalIndex);
+        PULSAR_VM_VERIFIED_CHECK((*m_Globals)[(size_t)instr->Arg0].IsConstant, RuntimeState::WritingOnConstantGlobal);
+        GlobalInstance& global = OwnGlobals()[(size_t)instr->Arg0];
+        global.Value = frame->Stack.Pop();
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(CopyIntoGlobal): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        if (instr->Arg0 < 0 || (size_t)instr->Arg0 >= m_Globals->Size())
+            PULSAR_VM_ERROR(RuntimeState::OutOfBoundsGlobalIndex);
+        PULSAR_VM_VERIFIED_CHECK((*m_Globals)[(size_t)instr->Arg0].IsConstant, RuntimeState::WritingOnConstantGlobal);
+        GlobalInstance& global = OwnGlobals()[(size_t)instr->Arg0];
+        global.Value = frame->Stack.Top();
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Pack): {
         Value::List list;
         // If Arg0 <= 0, push an empty list
-        if (instr.Arg0 > 0) {
-            size_t packing = (size_t)instr.Arg0;
-            if (frame.Stack.Size() < packing)
-                return RuntimeState::StackUnderflow;
+        if (instr->Arg0 > 0) {
+            size_t packing = (size_t)instr->Arg0;
+            PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < packing, RuntimeState::StackUnderflow);
             for (size_t i = 0; i < packing; i++) {
-                list.Prepend(frame.Stack.Pop());
+                list.Prepend(frame->Stack.Pop());
             }
         }
-        frame.Stack.EmplaceList(std::move(list));
-    } break;
-    case InstructionCode::Pop: {
-        size_t popCount = (size_t)(instr.Arg0 > 0 ? instr.Arg0 : 1);
-        if (frame.Stack.Size() < popCount)
-            return RuntimeState::StackUnderflow;
+        frame->Stack.EmplaceList(std::move(list));
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Pop): {
+        size_t popCount = (size_t)(instr->Arg0 > 0 ? instr->Arg0 : 1);
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < popCount, RuntimeState::StackUnderflow);
         for (size_t i = 0; i < popCount; i++)
-            frame.Stack.Pop();
-    } break;
-    case InstructionCode::Swap: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value tmp(frame.Stack[-1]);
-        frame.Stack[-1] = std::move(frame.Stack[-2]);
-        frame.Stack[-2] = std::move(tmp);
-    } break;
-    case InstructionCode::Dup: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        size_t dupCount = (size_t)(instr.Arg0 > 0 ? instr.Arg0 : 1);
-        Value val(frame.Stack.Top());
+            frame->Stack.Pop();
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Swap): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value tmp(frame->Stack[-1]);
+        frame->Stack[-1] = std::move(frame->Stack[-2]);
+        frame->Stack[-2] = std::move(tmp);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Dup): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        size_t dupCount = (size_t)(instr->Arg0 > 0 ? instr->Arg0 : 1);
+        Value val(frame->Stack.Top());
         for (size_t i = 0; i < dupCount-1; i++)
-            frame.Stack.Push(val);
-        frame.Stack.Push(std::move(val));
-    } break;
-    case InstructionCode::Call: {
-        int64_t funcIdx = instr.Arg0;
-        if (funcIdx < 0 || (size_t)funcIdx >= m_Module.Functions.Size())
-            return RuntimeState::OutOfBoundsFunctionIndex;
+            frame->Stack.Push(val);
+        frame->Stack.Push(std::move(val));
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Call): {
+        int64_t funcIdx = instr->Arg0;
+        PULSAR_VM_VERIFIED_CHECK(funcIdx < 0 || (size_t)funcIdx >= m_Module.Functions.Size(), RuntimeState::OutOfBoundsFunctionIndex);
 
         Frame callFrame = m_CallStack.CreateFrame(&m_Module.Functions[(size_t)funcIdx], false);
-        auto res = m_CallStack.PrepareFrame(callFrame, frame.Stack);
+        auto res = m_CallStack.PrepareFrame(callFrame, frame->Stack);
         if (res != RuntimeState::OK)
-            return res;
+            PULSAR_VM_ERROR(res);
+        PULSAR_VM_SAVE_IP();
         m_CallStack.PushFrame(std::move(callFrame));
-    } break;
-    case InstructionCode::CallNative: {
-        if (m_Module.NativeBindings.Size() != m_Module.NativeFunctions.Size())
-            return RuntimeState::NativeFunctionBindingsMismatch;
-        int64_t funcIdx = instr.Arg0;
-        if (funcIdx < 0 || (size_t)funcIdx >= m_Module.NativeBindings.Size())
-            return RuntimeState::OutOfBoundsFunctionIndex;
+    } PULSAR_VM_CALLED();
+    PULSAR_VM_CASE(CallNative): {
+        PULSAR_VM_VERIFIED_CHECK(m_Module.NativeBindings.Size() != m_Module.NativeFunctions.Size(), RuntimeState::NativeFunctionBindingsMismatch);
+        int64_t funcIdx = instr->Arg0;
+        PULSAR_VM_VERIFIED_CHECK(funcIdx < 0 || (size_t)funcIdx >= m_Module.NativeBindings.Size(), RuntimeState::OutOfBoundsFunctionIndex);
         if (!m_Module.NativeFunctions[(size_t)funcIdx])
-            return RuntimeState::UnboundNativeFunction;
+            PULSAR_VM_ERROR(RuntimeState::UnboundNativeFunction);
+
+        if (m_Module.GetFastNative((size_t)funcIdx))
+            PULSAR_VM_CALL_FAST_NATIVE((size_t)funcIdx);
 
         Frame callFrame = m_CallStack.CreateFrame(&m_Module.NativeBindings[(size_t)funcIdx], true);
-        auto res = m_CallStack.PrepareFrame(callFrame, frame.Stack);
+        auto res = m_CallStack.PrepareFrame(callFrame, frame->Stack);
         if (res != RuntimeState::OK)
-            return res;
+            PULSAR_VM_ERROR(res);
+        PULSAR_VM_SAVE_IP();
         m_CallStack.PushFrame(std::move(callFrame));
-        return m_Module.NativeFunctions[(size_t)funcIdx](*this);
-    }
-    case InstructionCode::Return:
-        // Because we use frame.InstructionIndex to find where an error occurred,
+        m_State = m_Module.NativeFunctions[(size_t)funcIdx](*this);
+    } PULSAR_VM_NATIVE_CALLED();
+    PULSAR_VM_CASE(Return):
+        // Because we use Frame::InstructionIndex to find where an error occurred,
         //  WE MUST check if we can actually return here, otherwise the error will
         //  appear at the end of the function.
-        if (frame.Stack.Size() < frame.Function->Returns)
-            return RuntimeState::StackUnderflow;
-        frame.InstructionIndex = frame.Function->Code.Size();
-        break;
-    case InstructionCode::ICall: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        Value funcIdxValue = frame.Stack.Pop();
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < frame->Function->Returns, RuntimeState::StackUnderflow);
+        ip = codeSize;
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(ITailCall):
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        // Natives are called like ICall does, they must run on top of the caller's frame.
+        if (frame->Stack.Top().Type() == ValueType::FunctionReference) {
+            int64_t funcIdx = frame->Stack.Pop().AsInteger();
+            if (funcIdx < 0 || (size_t)funcIdx >= m_Module.Functions.Size())
+                PULSAR_VM_ERROR(RuntimeState::OutOfBoundsFunctionIndex);
+
+            const FunctionDefinition& callee = m_Module.Functions[(size_t)funcIdx];
+            Frame callFrame = m_CallStack.CreateFrame(&callee, false);
+            auto res = m_CallStack.PrepareFrame(callFrame, frame->Stack);
+            if (res != RuntimeState::OK)
+                PULSAR_VM_ERROR(res);
+            PULSAR_VM_SAVE_IP();
+            if (callee.Returns == frame->Function->Returns)
+                m_CallStack.PopFrame();
+            m_CallStack.PushFrame(std::move(callFrame));
+            PULSAR_VM_CALLED();
+        }
+        [[fallthrough]];
+    PULSAR_VM_CASE(ICall): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        Value funcIdxValue = frame->Stack.Pop();
         if (funcIdxValue.Type() == ValueType::FunctionReference) {
             int64_t funcIdx = funcIdxValue.AsInteger();
             if (funcIdx < 0 || (size_t)funcIdx >= m_Module.Functions.Size())
-                return RuntimeState::OutOfBoundsFunctionIndex;
+                PULSAR_VM_ERROR(RuntimeState::OutOfBoundsFunctionIndex);
             Frame callFrame = m_CallStack.CreateFrame(&m_Module.Functions[(size_t)funcIdx], false);
-            auto res = m_CallStack.PrepareFrame(callFrame, frame.Stack);
+            auto res = m_CallStack.PrepareFrame(callFrame, frame->Stack);
             if (res != RuntimeState::OK)
-                return res;
+                PULSAR_VM_ERROR(res);
+            PULSAR_VM_SAVE_IP();
             m_CallStack.PushFrame(std::move(callFrame));
-            break;
+            PULSAR_VM_CALLED();
         } else if (funcIdxValue.Type() == ValueType::NativeFunctionReference) {
             if (m_Module.NativeBindings.Size() != m_Module.NativeFunctions.Size())
-                return RuntimeState::NativeFunctionBindingsMismatch;
+                PULSAR_VM_ERROR(RuntimeState::NativeFunctionBindingsMismatch);
             int64_t funcIdx = funcIdxValue.AsInteger();
             if (funcIdx < 0 || (size_t)funcIdx >= m_Module.NativeBindings.Size())
-                return RuntimeState::OutOfBoundsFunctionIndex;
+                PULSAR_VM_ERROR(RuntimeState::OutOfBoundsFunctionIndex);
             if (!m_Module.NativeFunctions[(size_t)funcIdx])
-                return RuntimeState::UnboundNativeFunction;
+                PULSAR_VM_ERROR(RuntimeState::UnboundNativeFunction);
+
+            if (m_Module.GetFastNative((size_t)funcIdx))
+                PULSAR_VM_CALL_FAST_NATIVE((size_t)funcIdx);
 
             Frame callFrame = m_CallStack.CreateFrame(&m_Module.NativeBindings[(size_t)funcIdx], true);
-            auto res = m_CallStack.PrepareFrame(callFrame, frame.Stack);
+            auto res = m_CallStack.PrepareFrame(callFrame, frame->Stack);
             if (res != RuntimeState::OK)
-                return res;
+                PULSAR_VM_ERROR(res);
+            PULSAR_VM_SAVE_IP();
             m_CallStack.PushFrame(std::move(callFrame));
-            return m_Module.NativeFunctions[(size_t)funcIdx](*this);
+            m_State = m_Module.NativeFunctions[(size_t)funcIdx](*this);
+            PULSAR_VM_NATIVE_CALLED();
         }
-        return RuntimeState::TypeError;
+        PULSAR_VM_ERROR(RuntimeState::TypeError);
     }
-    case InstructionCode::DynSum: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value  b = frame.Stack.Pop();
-        Value& a = frame.Stack.Top();
+    PULSAR_VM_CASE(TailCall): {
+        int64_t funcIdx = instr->Arg0;
+        PULSAR_VM_VERIFIED_CHECK(funcIdx < 0 || (size_t)funcIdx >= m_Module.Functions.Size(), RuntimeState::OutOfBoundsFunctionIndex);
+
+        const FunctionDefinition& callee = m_Module.Functions[(size_t)funcIdx];
+        Frame callFrame = m_CallStack.CreateFrame(&callee, false);
+        auto res = m_CallStack.PrepareFrame(callFrame, frame->Stack);
+        if (res != RuntimeState::OK)
+            PULSAR_VM_ERROR(res);
+        PULSAR_VM_SAVE_IP();
+        // The values returned by the callee are the ones returned by this frame.
+        // Otherwise, this is a normal call and the next instruction must return.
+        if (callee.Returns == frame->Function->Returns)
+            m_CallStack.PopFrame();
+        m_CallStack.PushFrame(std::move(callFrame));
+    } PULSAR_VM_CALLED();
+    PULSAR_VM_CASE(DynSum): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value  b = frame->Stack.Pop();
+        Value& a = frame->Stack.Top();
         if (!IsNumericValueType(a.Type()) || !IsNumericValueType(b.Type()))
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
         if (a.Type() == ValueType::Double || b.Type() == ValueType::Double) {
+            if (a.Type() == b.Type())
+                PULSAR_VM_QUICKEN(SumDD);
             double aVal = a.Type() == ValueType::Double ? a.AsDouble() : (double)a.AsInteger();
             double bVal = b.Type() == ValueType::Double ? b.AsDouble() : (double)b.AsInteger();
             a.SetDouble(aVal + bVal);
-        } else a.SetInteger(a.AsInteger() + b.AsInteger());
-    } break;
-    case InstructionCode::DynSub: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value  b = frame.Stack.Pop();
-        Value& a = frame.Stack.Top();
+        } else {
+            PULSAR_VM_QUICKEN(SumII);
+            a.SetInteger(a.AsInteger() + b.AsInteger());
+        }
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(SumII):
+        PULSAR_VM_QUICKENED_BINARY_OP(DynSum, Integer, AsInteger, SetInteger, +);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(SumDD):
+        PULSAR_VM_QUICKENED_BINARY_OP(DynSum, Double, AsDouble, SetDouble, +);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(DynSub): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value  b = frame->Stack.Pop();
+        Value& a = frame->Stack.Top();
         if (!IsNumericValueType(a.Type()) || !IsNumericValueType(b.Type()))
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
         if (a.Type() == ValueType::Double || b.Type() == ValueType::Double) {
+            if (a.Type() == b.Type())
+                PULSAR_VM_QUICKEN(SubDD);
             double aVal = a.Type() == ValueType::Double ? a.AsDouble() : (double)a.AsInteger();
             double bVal = b.Type() == ValueType::Double ? b.AsDouble() : (double)b.AsInteger();
             a.SetDouble(aVal - bVal);
-        } else a.SetInteger(a.AsInteger() - b.AsInteger());
-    } break;
-    case InstructionCode::DynMul: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value  b = frame.Stack.Pop();
-        Value& a = frame.Stack.Top();
+        } else {
+            PULSAR_VM_QUICKEN(SubII);
+            a.SetInteger(a.AsInteger() - b.AsInteger());
+        }
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(SubII):
+        PULSAR_VM_QUICKENED_BINARY_OP(DynSub, Integer, AsInteger, SetInteger, -);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(SubDD):
+        PULSAR_VM_QUICKENED_BINARY_OP(DynSub, Double, AsDouble, SetDouble, -);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(DynMul): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value  b = frame->Stack.Pop();
+        Value& a = frame->Stack.Top();
         if (!IsNumericValueType(a.Type()) || !IsNumericValueType(b.Type()))
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
         if (a.Type() == ValueType::Double || b.Type() == ValueType::Double) {
+            if (a.Type() == b.Type())
+                PULSAR_VM_QUICKEN(MulDD);
             double aVal = a.Type() == ValueType::Double ? a.AsDouble() : (double)a.AsInteger();
             double bVal = b.Type() == ValueType::Double ? b.AsDouble() : (double)b.AsInteger();
             a.SetDouble(aVal * bVal);
-        } else a.SetInteger(a.AsInteger() * b.AsInteger());
-    } break;
-    case InstructionCode::DynDiv: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value  b = frame.Stack.Pop();
-        Value& a = frame.Stack.Top();
+        } else {
+            PULSAR_VM_QUICKEN(MulII);
+            a.SetInteger(a.AsInteger() * b.AsInteger());
+        }
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(MulII):
+        PULSAR_VM_QUICKENED_BINARY_OP(DynMul, Integer, AsInteger, SetInteger, *);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(MulDD):
+        PULSAR_VM_QUICKENED_BINARY_OP(DynMul, Double, AsDouble, SetDouble, *);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(DynDiv): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value  b = frame->Stack.Pop();
+        Value& a = frame->Stack.Top();
         if (!IsNumericValueType(a.Type()) || !IsNumericValueType(b.Type()))
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
         if (a.Type() == ValueType::Double || b.Type() == ValueType::Double) {
+            if (a.Type() == b.Type())
+                PULSAR_VM_QUICKEN(DivDD);
             double aVal = a.Type() == ValueType::Double ? a.AsDouble() : (double)a.AsInteger();
             double bVal = b.Type() == ValueType::Double ? b.AsDouble() : (double)b.AsInteger();
             a.SetDouble(aVal / bVal);
-        } else a.SetInteger(a.AsInteger() / b.AsInteger());
-    } break;
-    case InstructionCode::Mod: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value  b = frame.Stack.Pop();
-        Value& a = frame.Stack.Top();
+        } else {
+            PULSAR_VM_QUICKEN(DivII);
+            a.SetInteger(a.AsInteger() / b.AsInteger());
+        }
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(DivII):
+        PULSAR_VM_QUICKENED_BINARY_OP(DynDiv, Integer, AsInteger, SetInteger, /);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(DivDD):
+        PULSAR_VM_QUICKENED_BINARY_OP(DynDiv, Double, AsDouble, SetDouble, /);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Mod): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value  b = frame->Stack.Pop();
+        Value& a = frame->Stack.Top();
         if (a.Type() != ValueType::Integer || b.Type() != ValueType::Integer)
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
         a.SetInteger(a.AsInteger() % b.AsInteger());
-    } break;
-    case InstructionCode::BitAnd: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value  b = frame.Stack.Pop();
-        Value& a = frame.Stack.Top();
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(BitAnd): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value  b = frame->Stack.Pop();
+        Value& a = frame->Stack.Top();
         if (a.Type() != ValueType::Integer || b.Type() != ValueType::Integer)
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
         a.SetInteger(a.AsInteger() & b.AsInteger());
-    } break;
-    case InstructionCode::BitOr: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value  b = frame.Stack.Pop();
-        Value& a = frame.Stack.Top();
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(BitOr): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value  b = frame->Stack.Pop();
+        Value& a = frame->Stack.Top();
         if (a.Type() != ValueType::Integer || b.Type() != ValueType::Integer)
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
         a.SetInteger(a.AsInteger() | b.AsInteger());
-    } break;
-    case InstructionCode::BitNot: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        Value& a = frame.Stack.Top();
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(BitNot): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        Value& a = frame->Stack.Top();
         if (a.Type() != ValueType::Integer)
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
         a.SetInteger(~a.AsInteger());
-    } break;
-    case InstructionCode::BitXor: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value  b = frame.Stack.Pop();
-        Value& a = frame.Stack.Top();
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(BitXor): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value  b = frame->Stack.Pop();
+        Value& a = frame->Stack.Top();
         if (a.Type() != ValueType::Integer || b.Type() != ValueType::Integer)
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
         a.SetInteger(a.AsInteger() ^ b.AsInteger());
-    } break;
-    case InstructionCode::BitShiftLeft: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value  b = frame.Stack.Pop();
-        Value& a = frame.Stack.Top();
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(BitShiftLeft): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value  b = frame->Stack.Pop();
+        Value& a = frame->Stack.Top();
         if (a.Type() != ValueType::Integer || b.Type() != ValueType::Integer)
-            return RuntimeState::TypeError;
-        constexpr int64_t BITS_OF_INT = 8*sizeof(b.AsInteger());
-        if (b.AsInteger() <= -BITS_OF_INT || b.AsInteger() >= BITS_OF_INT) {
-            // Handle C++ undefined behaviour.
-            // See "Built-in bitwise shift operators":
-            //   https://en.cppreference.com/w/cpp/language/operator_arithmetic
-            a.SetInteger(0);
-        } else if (b.AsInteger() < 0) {
-            a.SetInteger((int64_t)((uint64_t)a.AsInteger() >> -b.AsInteger()));
-        } else {
-            a.SetInteger((int64_t)((uint64_t)a.AsInteger() << b.AsInteger()));
-        }
-    } break;
-    case InstructionCode::BitShiftRight: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value  b = frame.Stack.Pop();
-        Value& a = frame.Stack.Top();
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
+        a.SetInteger(_InstrShiftLeft(a.AsInteger(), b.AsInteger()));
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(BitShiftRight): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value  b = frame->Stack.Pop();
+        Value& a = frame->Stack.Top();
         if (a.Type() != ValueType::Integer || b.Type() != ValueType::Integer)
-            return RuntimeState::TypeError;
-        constexpr int64_t BITS_OF_INT = 8*sizeof(b.AsInteger());
-        if (b.AsInteger() <= -BITS_OF_INT || b.AsInteger() >= BITS_OF_INT) {
-            // Handle C++ undefined behaviour.
-            // See "Built-in bitwise shift operators":
-            //   https://en.cppreference.com/w/cpp/language/operator_arithmetic
-            a.SetInteger(0);
-        } else if (b.AsInteger() < 0) {
-            a.SetInteger((int64_t)((uint64_t)a.AsInteger() << -b.AsInteger()));
-        } else {
-            a.SetInteger((int64_t)((uint64_t)a.AsInteger() >> b.AsInteger()));
-        }
-    } break;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
+        a.SetInteger(_InstrShiftRight(a.AsInteger(), b.AsInteger()));
+    } PULSAR_VM_NEXT();
     // TODO: Add floor/double, ceil/double and truncate instructions.
-    case InstructionCode::Floor: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        Value& val = frame.Stack.Top();
+    PULSAR_VM_CASE(Floor): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        Value& val = frame->Stack.Top();
         if (!IsNumericValueType(val.Type()))
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
         if (val.Type() == ValueType::Double)
             val.SetInteger((int64_t)std::floor(val.AsDouble()));
-    } break;
-    case InstructionCode::Ceil: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        Value& val = frame.Stack.Top();
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Ceil): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        Value& val = frame->Stack.Top();
         if (!IsNumericValueType(val.Type()))
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
         if (val.Type() == ValueType::Double)
             val.SetInteger((int64_t)std::ceil(val.AsDouble()));
-    } break;
-    case InstructionCode::Compare: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value  b = frame.Stack.Pop();
-        Value& a = frame.Stack.Top();
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Compare): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value  b = frame->Stack.Pop();
+        Value& a = frame->Stack.Top();
 
         if (IsNumericValueType(a.Type()) && IsNumericValueType(b.Type())) {
             if (a.Type() == ValueType::Double || b.Type() == ValueType::Double) {
+                if (a.Type() == b.Type())
+                    PULSAR_VM_QUICKEN(CompareDD);
                 double aVal = a.Type() == ValueType::Double ? a.AsDouble() : (double)a.AsInteger();
                 double bVal = b.Type() == ValueType::Double ? b.AsDouble() : (double)b.AsInteger();
                 a.SetDouble(aVal - bVal);
-            } else a.SetInteger(a.AsInteger() - b.AsInteger());
-            break;
+            } else {
+                PULSAR_VM_QUICKEN(CompareII);
+                a.SetInteger(a.AsInteger() - b.AsInteger());
+            }
+            PULSAR_VM_NEXT();
         }
 
         if (a.Type() != b.Type() || a.Type() != ValueType::String)
-            return RuntimeState::TypeError;
-        a.SetInteger(a.AsString().Compare(b.AsString()));
-    } break;
-    case InstructionCode::Equals: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value  b = frame.Stack.Pop();
-        Value& a = frame.Stack.Top();
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
+        a.SetInteger(std::as_const(a).AsString().Compare(std::as_const(b).AsString()));
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(CompareII):
+        PULSAR_VM_QUICKENED_BINARY_OP(Compare, Integer, AsInteger, SetInteger, -);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(CompareDD):
+        PULSAR_VM_QUICKENED_BINARY_OP(Compare, Double, AsDouble, SetDouble, -);
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Equals): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value  b = frame->Stack.Pop();
+        Value& a = frame->Stack.Top();
         a.SetInteger(a == b ? 1 : 0);
-    } break;
-    case InstructionCode::J:
-        frame.InstructionIndex = (size_t)((frame.InstructionIndex-1) + instr.Arg0);
-        break;
-    case InstructionCode::JZ:
-    case InstructionCode::JNZ:
-    case InstructionCode::JGZ:
-    case InstructionCode::JGEZ:
-    case InstructionCode::JLZ:
-    case InstructionCode::JLEZ: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        Value truthValue = frame.Stack.Pop();
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(J):
+        PULSAR_VM_JUMP(instr->Arg0);
+    PULSAR_VM_CASE(JZ):
+    PULSAR_VM_CASE(JNZ):
+    PULSAR_VM_CASE(JGZ):
+    PULSAR_VM_CASE(JGEZ):
+    PULSAR_VM_CASE(JLZ):
+    PULSAR_VM_CASE(JLEZ): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        Value truthValue = frame->Stack.Pop();
         if (!IsNumericValueType(truthValue.Type()))
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
         // TODO: Check for bounds (maybe not)
         if (truthValue.Type() == ValueType::Double) {
-            if (ShouldJump(instr.Code, truthValue.AsDouble()))
-                frame.InstructionIndex = (size_t)((frame.InstructionIndex-1) + instr.Arg0);
-        } else if (ShouldJump(instr.Code, truthValue.AsInteger()))
-            frame.InstructionIndex = (size_t)((frame.InstructionIndex-1) + instr.Arg0);
-    } break;
-    case InstructionCode::Length: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        const Value& list = frame.Stack.Top();
+            if (ShouldJump(instr->Code, truthValue.AsDouble()))
+                PULSAR_VM_JUMP(instr->Arg0);
+        } else if (ShouldJump(instr->Code, truthValue.AsInteger()))
+            PULSAR_VM_JUMP(instr->Arg0);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Length): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        const Value& list = frame->Stack.Top();
         if (list.Type() == ValueType::List) {
             Value len;
             len.SetInteger((int64_t)list.AsList().Length());
-            frame.Stack.Push(std::move(len));
+            frame->Stack.Push(std::move(len));
         } else if (list.Type() == ValueType::String) {
             Value len;
             len.SetInteger((int64_t)list.AsString().Length());
-            frame.Stack.Push(std::move(len));
-        } else return RuntimeState::TypeError;
-    } break;
-    case InstructionCode::IsEmpty: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        const Value& list = frame.Stack.Top();
+            frame->Stack.Push(std::move(len));
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(IsEmpty): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        const Value& list = frame->Stack.Top();
         Value isEmpty;
         if (list.Type() == ValueType::List) {
-            isEmpty.SetInteger(list.AsList().Front() ? 0 : 1);
+            isEmpty.SetInteger(list.AsList().IsEmpty() ? 1 : 0);
         } else if (list.Type() == ValueType::String) {
             isEmpty.SetInteger(list.AsString().Length() == 0 ? 1 : 0);
-        } else return RuntimeState::TypeError;
-        frame.Stack.Push(std::move(isEmpty));
-    } break;
-    case InstructionCode::PushEmptyList:
-        frame.Stack.EmplaceList();
-        break;
-    case InstructionCode::Prepend: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value toPrepend = frame.Stack.Pop();
-        Value& list = frame.Stack.Top();
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+        frame->Stack.Push(std::move(isEmpty));
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(PushEmptyList):
+        frame->Stack.EmplaceList();
+        PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Prepend): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value toPrepend = frame->Stack.Pop();
+        Value& list = frame->Stack.Top();
         if (list.Type() == ValueType::List) {
             list.AsList().Prepend(std::move(toPrepend));
         } else if (list.Type() == ValueType::String) {
             if (toPrepend.Type() == ValueType::String) {
-                toPrepend.AsString() += list.AsString();
-                list.AsString() = std::move(toPrepend.AsString());
+                toPrepend.AsString() += std::as_const(list).AsString();
+                list = std::move(toPrepend);
             } else if (toPrepend.Type() == ValueType::Integer) {
+                const String& str = std::as_const(list).AsString();
                 Pulsar::String prepended;
-                prepended.Reserve(list.AsString().Capacity()+1);
+                prepended.Reserve(str.Length()+1);
                 prepended += (char)toPrepend.AsInteger();
-                prepended += list.AsString();
-                list.AsString() = std::move(prepended);
-            } else return RuntimeState::TypeError;
-        } else return RuntimeState::TypeError;
-    } break;
-    case InstructionCode::Append: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value toAppend = frame.Stack.Pop();
-        Value& list = frame.Stack.Top();
+                prepended += str;
+                list.SetString(std::move(prepended));
+            } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Append): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value toAppend = frame->Stack.Pop();
+        Value& list = frame->Stack.Top();
         if (list.Type() == ValueType::List) {
             list.AsList().Append(std::move(toAppend));
         } else if (list.Type() == ValueType::String) {
             if (toAppend.Type() == ValueType::String)
-                list.AsString() += toAppend.AsString();
+                list.AsString() += std::as_const(toAppend).AsString();
             else if (toAppend.Type() == ValueType::Integer)
                 list.AsString() += (char)toAppend.AsInteger();
-            else return RuntimeState::TypeError;
-        } else return RuntimeState::TypeError;
-    } break;
-    case InstructionCode::Concat: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value toConcat = frame.Stack.Pop();
-        Value& list = frame.Stack.Top();
+            else PULSAR_VM_ERROR(RuntimeState::TypeError);
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Concat): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value toConcat = frame->Stack.Pop();
+        Value& list = frame->Stack.Top();
         if (toConcat.Type() == ValueType::List && list.Type() == ValueType::List) {
             list.AsList().Concat(std::move(toConcat.AsList()));
-        } else return RuntimeState::TypeError;
-    } break;
-    case InstructionCode::Head: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        Value& list = frame.Stack.Top();
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Head): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        Value& list = frame->Stack.Top();
         if (list.Type() == ValueType::List) {
-            Value::List::Node* node = list.AsList().Front();
-            if (!node) return RuntimeState::ListIndexOutOfBounds;
-            Value val(std::move(node->Value()));
-            list.AsList().RemoveFront(1);
-            frame.Stack.Push(std::move(val));
-        } else return RuntimeState::TypeError;
-    } break;
-    case InstructionCode::Tail: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        Value& list = frame.Stack.Top();
+            Value::List& values = list.AsList();
+            if (values.IsEmpty()) PULSAR_VM_ERROR(RuntimeState::ListIndexOutOfBounds);
+            // The front is copied since its chunk may be shared with other lists.
+            Value val(std::as_const(values).Front());
+            values.RemoveFront(1);
+            frame->Stack.Push(std::move(val));
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Tail): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        Value& list = frame->Stack.Top();
         if (list.Type() == ValueType::List) {
             list.AsList().RemoveFront(1);
-        } else return RuntimeState::TypeError;
-    } break;
-    case InstructionCode::Unpack: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        Value listToUnpack = frame.Stack.Pop();
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Unpack): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        Value listToUnpack = frame->Stack.Pop();
         if (listToUnpack.Type() != ValueType::List)
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
 
         // If Arg0 <= 0, pop list
-        if (instr.Arg0 > 0) {
-            size_t unpackCount = (size_t)instr.Arg0;
+        if (instr->Arg0 > 0) {
+            size_t unpackCount = (size_t)instr->Arg0;
 
-            Value::List::Node* node = listToUnpack.AsList().Back();
-            for (size_t i = 1; i < unpackCount && node; i++) {
-                node = node->Prev();
-            }
+            const Value::List& values = std::as_const(listToUnpack).AsList();
+            if (values.Length() < unpackCount)
+                PULSAR_VM_ERROR(RuntimeState::ListIndexOutOfBounds);
 
-            for (size_t i = 0; i < unpackCount; i++) {
-                if (!node) return RuntimeState::ListIndexOutOfBounds;
-                frame.Stack.Push(std::move(node->Value()));
-                node = node->Next();
-            }
+            for (auto next = values.IteratorAt(values.Length()-unpackCount); next != values.End(); ++next)
+                frame->Stack.Push(*next);
         }
-    } break;
-    case InstructionCode::Index: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value& list = frame.Stack[-2];
-        Value& index = frame.Stack[-1];
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Index): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        const Value& list = frame->Stack[-2];
+        Value& index = frame->Stack[-1];
         if (index.Type() != ValueType::Integer)
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
 
         if (list.Type() == ValueType::List) {
             if (index.AsInteger() < 0)
-                return RuntimeState::ListIndexOutOfBounds;
-            Value::List::Node* node = list.AsList().Front();
-            for (size_t i = 0; i < (size_t)index.AsInteger() && node; i++)
-                node = node->Next();
-            if (!node)
-                return RuntimeState::ListIndexOutOfBounds;
-            index = node->Value();
+                PULSAR_VM_ERROR(RuntimeState::ListIndexOutOfBounds);
+            const Value::List& values = list.AsList();
+            if ((size_t)index.AsInteger() >= values.Length())
+                PULSAR_VM_ERROR(RuntimeState::ListIndexOutOfBounds);
+            index = values[(size_t)index.AsInteger()];
         } else if (list.Type() == ValueType::String) {
             if (index.AsInteger() < 0 || (size_t)index.AsInteger() >= list.AsString().Length())
-                return RuntimeState::StringIndexOutOfBounds;
+                PULSAR_VM_ERROR(RuntimeState::StringIndexOutOfBounds);
             int64_t ch = (unsigned char)list.AsString()[(size_t)index.AsInteger()];
             index.SetInteger(ch);
-        } else return RuntimeState::TypeError;
-    } break;
-    case InstructionCode::Prefix: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value& str = frame.Stack[-2];
-        Value& length = frame.Stack[-1];
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Prefix): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value& str = frame->Stack[-2];
+        Value& length = frame->Stack[-1];
         if (length.Type() != ValueType::Integer)
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
 
         if (str.Type() == ValueType::String) {
             if (length.AsInteger() == 0) {
                 length.SetString("");
-                break;
+                PULSAR_VM_NEXT();
             } else if (length.AsInteger() < 0 || (size_t)length.AsInteger() > str.AsString().Length())
-                return RuntimeState::StringIndexOutOfBounds;
+                PULSAR_VM_ERROR(RuntimeState::StringIndexOutOfBounds);
             size_t prefLen = (size_t)length.AsInteger();
-            String prefix(str.AsString().CString(), prefLen);
-            String postPrefix(&str.AsString().CString()[prefLen], str.AsString().Length()-prefLen);
+            const String& source = std::as_const(str).AsString();
+            String prefix(source.CString(), prefLen);
+            String postPrefix(&source.CString()[prefLen], source.Length()-prefLen);
             str.SetString(std::move(postPrefix));
             length.SetString(std::move(prefix));
-        } else return RuntimeState::TypeError;
-    } break;
-    case InstructionCode::Suffix: {
-        if (frame.Stack.Size() < 2)
-            return RuntimeState::StackUnderflow;
-        Value& str = frame.Stack[-2];
-        Value& length = frame.Stack[-1];
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Suffix): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        Value& str = frame->Stack[-2];
+        Value& length = frame->Stack[-1];
         if (length.Type() != ValueType::Integer)
-            return RuntimeState::TypeError;
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
 
         if (str.Type() == ValueType::String) {
             if (length.AsInteger() == 0) {
                 length.SetString("");
-                break;
+                PULSAR_VM_NEXT();
             } else if (length.AsInteger() < 0 || (size_t)length.AsInteger() > str.AsString().Length())
-                return RuntimeState::StringIndexOutOfBounds;
+                PULSAR_VM_ERROR(RuntimeState::StringIndexOutOfBounds);
             size_t sufLen = (size_t)length.AsInteger();
-            String suffix(&str.AsString().CString()[str.AsString().Length()-sufLen], sufLen);
-            String preSuffix(str.AsString().CString(), str.AsString().Length()-sufLen);
+            const String& source = std::as_const(str).AsString();
+            String suffix(&source.CString()[source.Length()-sufLen], sufLen);
+            String preSuffix(source.CString(), source.Length()-sufLen);
             str.SetString(std::move(preSuffix));
             length.SetString(std::move(suffix));
-        } else return RuntimeState::TypeError;
-    } break;
-    case InstructionCode::Substr: {
-        if (frame.Stack.Size() < 3)
-            return RuntimeState::StackUnderflow;
-        Value endIdx = frame.Stack.Pop();
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(Substr): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 3, RuntimeState::StackUnderflow);
+        Value endIdx = frame->Stack.Pop();
         if (endIdx.Type() != ValueType::Integer)
-            return RuntimeState::TypeError;
-        Value& startIdx = frame.Stack[-1];
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
+        Value& startIdx = frame->Stack[-1];
         if (startIdx.Type() != ValueType::Integer)
-            return RuntimeState::TypeError;
-        Value& str = frame.Stack[-2];
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
+        const Value& str = frame->Stack[-2];
 
         if (str.Type() == ValueType::String) {
             if (startIdx.AsInteger() < 0 || endIdx.AsInteger() < 0)
-                return RuntimeState::StringIndexOutOfBounds;
+                PULSAR_VM_ERROR(RuntimeState::StringIndexOutOfBounds);
             startIdx.SetString(str.AsString().SubString(
                 (size_t)startIdx.AsInteger(), (size_t)endIdx.AsInteger()
             ));
-        } else return RuntimeState::TypeError;
-    } break;
-    case InstructionCode::IsVoid:
-    case InstructionCode::IsInteger:
-    case InstructionCode::IsDouble:
-    case InstructionCode::IsNumber:
-    case InstructionCode::IsFunctionReference:
-    case InstructionCode::IsNativeFunctionReference:
-    case InstructionCode::IsAnyFunctionReference:
-    case InstructionCode::IsList:
-    case InstructionCode::IsString:
-    case InstructionCode::IsCustom: {
-        if (frame.Stack.Size() < 1)
-            return RuntimeState::StackUnderflow;
-        ValueType valueType = frame.Stack.Top().Type();
-        frame.Stack.EmplaceInteger(_InstrTypeCheck(instr.Code, valueType) ? 1 : 0);
-    } break;
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(IsVoid):
+    PULSAR_VM_CASE(IsInteger):
+    PULSAR_VM_CASE(IsDouble):
+    PULSAR_VM_CASE(IsNumber):
+    PULSAR_VM_CASE(IsFunctionReference):
+    PULSAR_VM_CASE(IsNativeFunctionReference):
+    PULSAR_VM_CASE(IsAnyFunctionReference):
+    PULSAR_VM_CASE(IsList):
+    PULSAR_VM_CASE(IsString):
+    PULSAR_VM_CASE(IsCustom): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        ValueType valueType = frame->Stack.Top().Type();
+        frame->Stack.EmplaceInteger(_InstrTypeCheck(instr->Code, valueType) ? 1 : 0);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(IncLocal):
+    PULSAR_VM_CASE(DecLocal): {
+        PULSAR_VM_VERIFIED_CHECK(instr->Arg0 < 0 || (size_t)instr->Arg0 >= frame->Locals.Size(), RuntimeState::OutOfBoundsLocalIndex);
+        Value& local = frame->Locals[(size_t)instr->Arg0];
+        int64_t delta = instr->Code == InstructionCode::IncLocal ? 1 : -1;
+        if (local.Type() == ValueType::Integer) {
+            local.SetInteger(local.AsInteger() + delta);
+        } else if (local.Type() == ValueType::Double) {
+            local.SetDouble(local.AsDouble() + (double)delta);
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(PushLocal2): {
+        size_t firstIdx  = UnpackFirstArg(instr->Arg0);
+        size_t secondIdx = UnpackSecondArg(instr->Arg0);
+        PULSAR_VM_VERIFIED_CHECK(firstIdx >= frame->Locals.Size() || secondIdx >= frame->Locals.Size(), RuntimeState::OutOfBoundsLocalIndex);
+        frame->Stack.Push(frame->Locals[firstIdx]);
+        frame->Stack.Push(frame->Locals[secondIdx]);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(PushConstAppend): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        PULSAR_VM_VERIFIED_CHECK(instr->Arg0 < 0 || (size_t)instr->Arg0 >= m_Module.Constants.Size(), RuntimeState::OutOfBoundsConstantIndex);
+        const Value& toAppend = m_Module.Constants[(size_t)instr->Arg0];
+        Value& list = frame->Stack.Top();
+        if (list.Type() == ValueType::List) {
+            list.AsList().Append(toAppend);
+        } else if (list.Type() == ValueType::String) {
+            if (toAppend.Type() == ValueType::String)
+                list.AsString() += toAppend.AsString();
+            else if (toAppend.Type() == ValueType::Integer)
+                list.AsString() += (char)toAppend.AsInteger();
+            else PULSAR_VM_ERROR(RuntimeState::TypeError);
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(DupJZ): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 1, RuntimeState::StackUnderflow);
+        const Value& truthValue = frame->Stack.Top();
+        if (!IsNumericValueType(truthValue.Type()))
+            PULSAR_VM_ERROR(RuntimeState::TypeError);
+        if (truthValue.Type() == ValueType::Double) {
+            if (truthValue.AsDouble() == 0.0)
+                PULSAR_VM_JUMP(instr->Arg0);
+        } else if (truthValue.AsInteger() == 0)
+            PULSAR_VM_JUMP(instr->Arg0);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(CompareJGZ):
+    PULSAR_VM_CASE(CompareJGEZ):
+    PULSAR_VM_CASE(CompareJLZ):
+    PULSAR_VM_CASE(CompareJLEZ): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        const Value& a = frame->Stack[-2];
+        const Value& b = frame->Stack[-1];
+        InstructionCode jmpInstrCode = GetFusedJump(instr->Code);
+
+        bool shouldJump;
+        if (IsNumericValueType(a.Type()) && IsNumericValueType(b.Type())) {
+            if (a.Type() == ValueType::Double || b.Type() == ValueType::Double) {
+                double aVal = a.Type() == ValueType::Double ? a.AsDouble() : (double)a.AsInteger();
+                double bVal = b.Type() == ValueType::Double ? b.AsDouble() : (double)b.AsInteger();
+                shouldJump = ShouldJump(jmpInstrCode, aVal - bVal);
+            } else shouldJump = ShouldJump(jmpInstrCode, a.AsInteger() - b.AsInteger());
+        } else if (a.Type() == ValueType::String && b.Type() == ValueType::String) {
+            shouldJump = ShouldJump(jmpInstrCode, a.AsString().Compare(b.AsString()));
+        } else PULSAR_VM_ERROR(RuntimeState::TypeError);
+
+        frame->Stack.Resize(frame->Stack.Size()-2);
+        if (shouldJump)
+            PULSAR_VM_JUMP(instr->Arg0);
+    } PULSAR_VM_NEXT();
+    PULSAR_VM_CASE(EqualsJZ):
+    PULSAR_VM_CASE(EqualsJNZ): {
+        PULSAR_VM_VERIFIED_CHECK(frame->Stack.Size() < 2, RuntimeState::StackUnderflow);
+        int64_t areEqual = frame->Stack[-2] == frame->Stack[-1] ? 1 : 0;
+        frame->Stack.Resize(frame->Stack.Size()-2);
+        if (ShouldJump(GetFusedJump(instr->Code), areEqual))
+            PULSAR_VM_JUMP(instr->Arg0);
+    } PULSAR_VM_NEXT();
+    default:
+#ifdef PULSAR_VM_COMPUTED_GOTO
+    _VMInstrUnknown:
+#endif // PULSAR_VM_COMPUTED_GOTO
+        PULSAR_VM_NEXT();
     }
 
-    return RuntimeState::OK;
+_VMCalled:
+    // Recursion may loop without jumping backwards, so calls are charged too.
+    if (--m_Fuel <= 0 || SingleStep)
+        return;
+    goto _VMEnterFrame;
+
+_VMNativeCalled:
+    // The native function may have changed the CallStack (i.e. error! pops its own frame).
+    if (SingleStep || m_State != RuntimeState::OK || m_StopRequested)
+        return;
+    goto _VMEnterFrame;
+
+_VMFrameEnd: {
+    PULSAR_VM_SAVE_IP();
+    Stack& callerStack = m_CallStack.HasCaller()
+        ? m_CallStack.CallingFrame().Stack : m_Stack;
+
+    if (frame->Stack.Size() < frame->Function->Returns) {
+        m_State = RuntimeState::StackUnderflow;
+        return;
+    }
+
+    for (size_t i = 0; i < frame->Function->Returns; i++) {
+        size_t popIdx = frame->Stack.Size()-frame->Function->Returns+i;
+        callerStack.Push(std::move(frame->Stack[popIdx]));
+    }
+
+    m_CallStack.PopFrame();
+    if (SingleStep || m_CallStack.IsEmpty())
+        return;
+    goto _VMEnterFrame;
 }
+
+_VMRunTiers:
+    if constexpr (!SingleStep && Verified) {
+        if (functionState && ip < codeSize) {
+            CompiledFunction::EntryPoint entryPoint = GetCompiledEntryPoint(*functionState, *frame->Function);
+            if (entryPoint) {
+                PULSAR_VM_SAVE_IP();
+                RunCompiledCode(entryPoint, *frame);
+                ip = frame->InstructionIndex;
+                if (m_StopRequested || m_Fuel <= 0)
+                    goto _VMExit;
+            } else if (m_Engine == ExecutionEngine::Register) {
+                const RegisterFunction* registers = GetRegisterFunction(*functionState, *frame->Function);
+                if (registers) {
+                    PULSAR_VM_SAVE_IP();
+                    size_t callDepth = m_CallStack.Size();
+                    RunRegisterCode(*registers, *frame);
+                    if (m_CallStack.Size() != callDepth) {
+                        // The Frame of a fast native is returned from by the stack interpreter.
+                        if (m_State != RuntimeState::OK || m_StopRequested || m_Fuel <= 0)
+                            return;
+                        goto _VMEnterFrame;
+                    }
+                    ip = frame->InstructionIndex;
+                    if (m_State != RuntimeState::OK || m_StopRequested || m_Fuel <= 0)
+                        goto _VMExit;
+                }
+            }
+        }
+    }
+    PULSAR_VM_NEXT();
+
+_VMExit:
+    PULSAR_VM_SAVE_IP();
+}
+
+#pragma GCC diagnostic pop
+
+#undef PULSAR_VM_JUMP
+#undef PULSAR_VM_QUICKENED_BINARY_OP
+#undef PULSAR_VM_DEQUICKEN
+#undef PULSAR_VM_QUICKEN
+#undef PULSAR_VM_CALL_FAST_NATIVE
+#undef PULSAR_VM_NATIVE_CALLED
+#undef PULSAR_VM_CALLED
+#undef PULSAR_VM_VERIFIED_CHECK
+#undef PULSAR_VM_ERROR
+#undef PULSAR_VM_NEXT
+#undef PULSAR_VM_SAVE_IP
+#undef PULSAR_VM_LOAD_FRAME
+#undef PULSAR_VM_DISPATCH_NO_CODE
+#undef PULSAR_VM_DISPATCH_CODE
+#undef PULSAR_VM_DISPATCH_UNKNOWN
+#undef PULSAR_VM_DISPATCH_LABEL
+#undef PULSAR_VM_DISPATCH_TABLE
+#undef PULSAR_VM_CASE
+#undef PULSAR_VM_COMPUTED_GOTO
@@ -0,0 +1,320 @@
+#include "pulsar/runtime/allocator.h"
+
+#ifdef _WIN32
+#include <malloc.h> // _aligned_malloc, _aligned_free
+#endif // _WIN32
+
+namespace
+{
+    void* AllocateRegion()
+    {
+        constexpr size_t size = Pulsar::Core::MemoryRegion::REGION_SIZE;
+#ifdef _WIN32
+        return _aligned_malloc(size, size);
+#else // _WIN32
+        return std::aligned_alloc(size, size);
+#endif // _WIN32
+    }
+
+    void FreeRegion(void* region)
+    {
+#ifdef _WIN32
+        _aligned_free(region);
+#else // _WIN32
+        std::free(region);
+#endif // _WIN32
+    }
+}
+
+/**
+ * A MemoryRegion holding blocks of a single size class, which are allocated in order.
+ * Once its arena is destroyed, the slab is orphaned and destroys itself when its last block is freed.
+ */
+class Pulsar::ArenaAllocator::Slab : public Pulsar::Core::MemoryRegion
+{
+public:
+    Slab(ArenaAllocator& arena, size_t sizeClass)
+        : Arena(&arena), SizeClass(sizeClass), BlockSize(SIZE_CLASSES[sizeClass]),
+          Bump(Begin()) {}
+
+    // Returns nullptr if the slab could not be allocated.
+    static Slab* New(ArenaAllocator& arena, size_t sizeClass)
+    {
+        void* memory = AllocateRegion();
+        if (!memory)
+            return nullptr;
+        Slab* slab = PULSAR_PLACEMENT_NEW(Slab, (Slab*)memory, arena, sizeClass);
+        if (!Register(slab)) {
+            slab->~Slab();
+            FreeRegion(memory);
+            return nullptr;
+        }
+        return slab;
+    }
+
+    static Slab* Of(const void* block)
+    {
+        return reinterpret_cast<Slab*>((uintptr_t)block & ~(uintptr_t)(REGION_SIZE-1));
+    }
+
+    // Returns nullptr if all blocks were already allocated once.
+    FreeBlock* TakeBlock()
+    {
+        if (Bump+BlockSize > End())
+            return nullptr;
+        FreeBlock* block = (FreeBlock*)Bump;
+        Bump += BlockSize;
+        return block;
+    }
+
+    // Moves the blocks freed by other threads into `freeBlocks`, returns their count.
+    size_t ReclaimBlocks(FreeBlock*& freeBlocks)
+    {
+#ifdef PULSAR_NO_ATOMIC
+        FreeBlock* block = RemoteFreeBlocks;
+        RemoteFreeBlocks = nullptr;
+#else // PULSAR_NO_ATOMIC
+        if (!RemoteFreeBlocks.load(std::memory_order_relaxed))
+            return 0;
+        FreeBlock* block = RemoteFreeBlocks.exchange(nullptr, std::memory_order_acquire);
+#endif // PULSAR_NO_ATOMIC
+        size_t count = 0;
+        while (block) {
+            FreeBlock* next = block->Next;
+            block->Next = freeBlocks;
+            freeBlocks = block;
+            block = next;
+            count++;
+        }
+        return count;
+    }
+
+#ifdef PULSAR_NO_ATOMIC
+    // Called by the arena once it's destroyed, the slab may be destroyed by this call.
+    // FreedBlocks must be the number of blocks of this slab within the free list of the arena.
+    void Orphan()
+    {
+        size_t usedBlocks = (size_t)(Bump-Begin()) / BlockSize;
+        Arena = nullptr;
+        OrphanedBlocks = usedBlocks-FreedBlocks;
+        for (FreeBlock* block = RemoteFreeBlocks; block; block = block->Next)
+            OrphanedBlocks--;
+        RemoteFreeBlocks = &s_Orphaned;
+        if (OrphanedBlocks == 0)
+            Destroy(this);
+    }
+
+    void Free(void* block, Core::Allocator* threadAllocator) override
+    {
+        if (Arena && static_cast<Core::Allocator*>(Arena) == threadAllocator) {
+            Arena->FreeLocal(*this, block);
+            return;
+        }
+
+        if (RemoteFreeBlocks == &s_Orphaned) {
+            if (--OrphanedBlocks == 0)
+                Destroy(this);
+            return;
+        }
+
+        FreeBlock* freeBlock = (FreeBlock*)block;
+        freeBlock->Next = RemoteFreeBlocks;
+        RemoteFreeBlocks = freeBlock;
+    }
+#else // PULSAR_NO_ATOMIC
+    // Called by the arena once it's destroyed, the slab may be destroyed by this call.
+    // FreedBlocks must be the number of blocks of this slab within the free list of the arena.
+    void Orphan()
+    {
+        size_t usedBlocks = (size_t)(Bump-Begin()) / BlockSize;
+        Arena.store(nullptr, std::memory_order_relaxed);
+        // The additional block prevents other threads from destroying the slab until its blocks are counted.
+        OrphanedBlocks.store(usedBlocks-FreedBlocks+1, std::memory_order_relaxed);
+        FreeBlock* block = RemoteFreeBlocks.exchange(&s_Orphaned, std::memory_order_acq_rel);
+        size_t freedBlocks = 1;
+        for (; block; block = block->Next)
+            freedBlocks++;
+        if (OrphanedBlocks.fetch_sub(freedBlocks, std::memory_order_acq_rel) == freedBlocks)
+            Destroy(this);
+    }
+
+    void Free(void* block, Core::Allocator* threadAllocator) override
+    {
+        ArenaAllocator* arena = Arena.load(std::memory_order_relaxed);
+        if (arena && static_cast<Core::Allocator*>(arena) == threadAllocator) {
+            arena->FreeLocal(*this, block);
+            return;
+        }
+
+        FreeBlock* freeBlock = (FreeBlock*)block;
+        FreeBlock* head = RemoteFreeBlocks.load(std::memory_order_acquire);
+        do {
+            if (head == &s_Orphaned) {
+                if (OrphanedBlocks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    Destroy(this);
+                return;
+            }
+            freeBlock->Next = head;
+        } while (!RemoteFreeBlocks.compare_exchange_weak(head, freeBlock,
+            std::memory_order_release, std::memory_order_acquire));
+    }
+#endif // PULSAR_NO_ATOMIC
+
+    size_t SizeOf(const void* block) const override
+    {
+        PULSAR_UNUSED(block);
+        return BlockSize;
+    }
+
+public:
+    // The arena which owns this slab, nullptr once it's orphaned.
+#ifdef PULSAR_NO_ATOMIC
+    ArenaAllocator* Arena;
+#else // PULSAR_NO_ATOMIC
+    std::atomic<ArenaAllocator*> Arena;
+#endif // PULSAR_NO_ATOMIC
+    size_t SizeClass;
+    size_t BlockSize;
+    // Start of the blocks which were never allocated.
+    uint8_t* Bump;
+    // Only used by the arena while it's being destroyed.
+    size_t FreedBlocks = 0;
+    Slab* Next = nullptr;
+
+private:
+    uint8_t* Begin() { return reinterpret_cast<uint8_t*>(this) + (sizeof(Slab)+15)/16*16; }
+    uint8_t* End()   { return reinterpret_cast<uint8_t*>(this) + REGION_SIZE; }
+
+    static void Destroy(Slab* slab)
+    {
+        Unregister(slab);
+        slab->~Slab();
+        FreeRegion((void*)slab);
+    }
+
+private:
+    // Blocks freed by threads the arena is not bound to, or &s_Orphaned.
+#ifdef PULSAR_NO_ATOMIC
+    FreeBlock* RemoteFreeBlocks = nullptr;
+#else // PULSAR_NO_ATOMIC
+    std::atomic<FreeBlock*> RemoteFreeBlocks = nullptr;
+#endif // PULSAR_NO_ATOMIC
+    // Blocks which are still allocated after the slab was orphaned.
+    PULSAR_ATOMIC_SIZE_T OrphanedBlocks = 0;
+
+    static inline FreeBlock s_Orphaned{nullptr};
+};
+
+Pulsar::ArenaAllocator::~ArenaAllocator()
+{
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+        for (FreeBlock* block = m_FreeBlocks[i]; block; block = block->Next)
+            Slab::Of(block)->FreedBlocks++;
+    }
+
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+        Slab* slab = m_Slabs[i];
+        while (slab) {
+            Slab* next = slab->Next;
+            slab->Orphan();
+            slab = next;
+        }
+    }
+}
+
+void* Pulsar::ArenaAllocator::Malloc(size_t size)
+{
+    if (size > MAX_BLOCK_SIZE) {
+        m_FallbackAllocations++;
+        return nullptr;
+    }
+
+    size_t sizeClass = SizeClassOf(size);
+    FreeBlock* block = m_FreeBlocks[sizeClass];
+    if (block) {
+        m_FreeBlocks[sizeClass] = block->Next;
+    } else {
+        block = NewBlock(sizeClass);
+        if (!block) {
+            m_FallbackAllocations++;
+            return nullptr;
+        }
+    }
+
+    m_Allocations[sizeClass]++;
+    m_BytesInUse += SIZE_CLASSES[sizeClass];
+    if (m_BytesInUse > m_PeakBytesInUse)
+        m_PeakBytesInUse = m_BytesInUse;
+    return block;
+}
+
+Pulsar::RuntimeAllocator::Ref Pulsar::ArenaAllocator::Fork() const
+{
+    return SharedRef<ArenaAllocator>::New();
+}
+
+Pulsar::AllocatorStats Pulsar::ArenaAllocator::GetStats() const
+{
+    AllocatorStats stats;
+    stats.BytesInUse     = m_BytesInUse;
+    stats.PeakBytesInUse = m_PeakBytesInUse;
+    stats.BytesReserved  = m_BytesReserved;
+    stats.FallbackAllocations = m_FallbackAllocations;
+    stats.SizeClasses.Reserve(SIZE_CLASS_COUNT);
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+        stats.Allocations += m_Allocations[i];
+        stats.SizeClasses.PushBack({ .BlockSize=SIZE_CLASSES[i], .Allocations=m_Allocations[i] });
+    }
+    return stats;
+}
+
+size_t Pulsar::ArenaAllocator::SizeClassOf(size_t size)
+{
+    if (size <= 128)
+        return size > 0 ? (size-1)/16 : 0;
+    size_t sizeClass = 8;
+    while (SIZE_CLASSES[sizeClass] < size)
+        sizeClass++;
+    return sizeClass;
+}
+
+Pulsar::ArenaAllocator::FreeBlock* Pulsar::ArenaAllocator::NewBlock(size_t sizeClass)
+{
+    Slab* slab = m_Slabs[sizeClass];
+    if (slab) {
+        FreeBlock* block = slab->TakeBlock();
+        if (block)
+            return block;
+    }
+
+    if (ReclaimBlocks(sizeClass)) {
+        FreeBlock* block = m_FreeBlocks[sizeClass];
+        m_FreeBlocks[sizeClass] = block->Next;
+        return block;
+    }
+
+    slab = Slab::New(*this, sizeClass);
+    if (!slab)
+        return nullptr;
+    slab->Next = m_Slabs[sizeClass];
+    m_Slabs[sizeClass] = slab;
+    m_BytesReserved += Core::MemoryRegion::REGION_SIZE;
+    return slab->TakeBlock();
+}
+
+bool Pulsar::ArenaAllocator::ReclaimBlocks(size_t sizeClass)
+{
+    size_t reclaimed = 0;
+    for (Slab* slab = m_Slabs[sizeClass]; slab; slab = slab->Next)
+        reclaimed += slab->ReclaimBlocks(m_FreeBlocks[sizeClass]);
+    m_BytesInUse -= reclaimed * SIZE_CLASSES[sizeClass];
+    return reclaimed > 0;
+}
+
+void Pulsar::ArenaAllocator::FreeLocal(Slab& slab, void* block)
+{
+    FreeBlock* freeBlock = (FreeBlock*)block;
+    freeBlock->Next = m_FreeBlocks[slab.SizeClass];
+    m_FreeBlocks[slab.SizeClass] = freeBlock;
+    m_BytesInUse -= slab.BlockSize;
+}
@@ -1,5 +1,7 @@
 #include "pulsar/runtime/module.h"
 
+#include "pulsar/runtime.h"
+
 size_t Pulsar::Module::DeclareNativeFunction(FunctionSignature signature)
 {
     return DeclareNativeFunction(signature.ToNativeDefinition());
@@ -13,21 +15,20 @@ size_t Pulsar::Module::DeclareNativeFunction(const FunctionDefinition& definitio
 size_t Pulsar::Module::DeclareNativeFunction(FunctionDefinition&& definition)
 {
     NativeFunctions.Resize(NativeBindings.Size(), nullptr);
+    FastNativeFunctions.Resize(NativeBindings.Size());
 
-    size_t boundIndex = INVALID_INDEX;
-    for (size_t nativeIdx = 0; nativeIdx < NativeBindings.Size(); ++nativeIdx) {
-        FunctionDefinition& binding = NativeBindings[nativeIdx];
-        if (!definition.DeclarationMatches(binding))
-            continue;
-        if (definition.HasDebugSymbol())
-            binding.DebugSymbol = std::move(definition.DebugSymbol);
-        boundIndex = nativeIdx;
-    }
+    const auto& nativeBindings = NativeBindings.Get();
+    size_t boundIndex = m_NativeNames.FindLast(NativeBindings, definition.Name, [&nativeBindings, &definition](size_t nativeIdx) {
+        return definition.DeclarationMatches(nativeBindings[nativeIdx]);
+    });
 
     if (boundIndex == INVALID_INDEX) {
         NativeBindings.EmplaceBack(std::move(definition));
         NativeFunctions.Resize(NativeBindings.Size());
+        FastNativeFunctions.Resize(NativeBindings.Size());
         boundIndex = NativeBindings.Size()-1;
+    } else if (definition.HasDebugSymbol()) {
+        NativeBindings[boundIndex].DebugSymbol = std::move(definition.DebugSymbol);
     }
 
     return boundIndex;
@@ -45,17 +46,42 @@ size_t Pulsar::Module::BindNativeFunction(const FunctionDefinition& definition,
 
 size_t Pulsar::Module::BindNativeFunction(FunctionDefinition&& definition, NativeFunction function)
 {
-    NativeFunctions.Resize(NativeBindings.Size(), nullptr);
+    return BindNative(std::move(definition), std::move(function), FastNativeBinding{});
+}
+
+size_t Pulsar::Module::BindFastNativeFunction(FunctionSignature signature, FastNativeFunction function, void* userData)
+{
+    return BindFastNativeFunction(signature.ToNativeDefinition(), function, userData);
+}
+
+size_t Pulsar::Module::BindFastNativeFunction(const FunctionDefinition& definition, FastNativeFunction function, void* userData)
+{
+    return BindFastNativeFunction(std::forward<FunctionDefinition>(FunctionDefinition(definition)), function, userData);
+}
+
+size_t Pulsar::Module::BindFastNativeFunction(FunctionDefinition&& definition, FastNativeFunction function, void* userData)
+{
+    NativeFunction slowFunction = [function, userData](ExecutionContext& eContext) {
+        NativeCall call(eContext, eContext.GetCallStack().Size()-1);
+        return function(call, userData);
+    };
+    return BindNative(std::move(definition), std::move(slowFunction), FastNativeBinding{ function, userData });
+}
 
+size_t Pulsar::Module::BindNative(FunctionDefinition&& definition, NativeFunction function, FastNativeBinding fastFunction)
+{
     size_t lastNativeIdx = DeclareNativeFunction(std::forward<FunctionDefinition>(definition));
-    const FunctionDefinition& definitionToMatch = NativeBindings[lastNativeIdx];
+    const auto& nativeBindings = NativeBindings.Get();
+    const FunctionDefinition& definitionToMatch = nativeBindings[lastNativeIdx];
 
-    for (size_t nativeIdx = 0; nativeIdx <= lastNativeIdx; ++nativeIdx) {
-        const FunctionDefinition& binding = NativeBindings[nativeIdx];
-        if (!definitionToMatch.DeclarationMatches(binding))
-            continue;
-        NativeFunctions[nativeIdx] = function;
-    }
+    // Binds all declarations which match, the lookup never succeeds so that all of them are visited.
+    m_NativeNames.FindLast(NativeBindings, definitionToMatch.Name, [&](size_t nativeIdx) {
+        if (definitionToMatch.DeclarationMatches(nativeBindings[nativeIdx])) {
+            NativeFunctions[nativeIdx] = function;
+            FastNativeFunctions[nativeIdx] = fastFunction;
+        }
+        return false;
+    });
 
     return lastNativeIdx;
 }
@@ -64,16 +90,135 @@ uint64_t Pulsar::Module::BindCustomType(const String& name, CustomType::GlobalDa
 {
     while (CustomTypes.Find(++m_LastTypeId));
     CustomTypes.Emplace(m_LastTypeId, name, globalDataFactory);
+    if (!m_CustomTypeIds.Find(name))
+        m_CustomTypeIds.Emplace(name, m_LastTypeId);
     return m_LastTypeId;
 }
 
+uint64_t Pulsar::Module::FindCustomTypeByName(const String& name) const
+{
+    const auto* typeId = m_CustomTypeIds.Find(name);
+    return typeId ? typeId->Value() : 0;
+}
+
 size_t Pulsar::Module::FindFunctionDefinitionBySignature(const List<FunctionDefinition>& definitions, FunctionSignature signature) const
 {
     for (size_t i = definitions.Size(); i > 0; --i) {
         const auto& definition = definitions[i-1];
-        if (signature.Matches(definition))
+        if (!signature.Matches(definition))
             continue;
         return i-1;
     }
     return INVALID_INDEX;
 }
+
+size_t Pulsar::Module::FindFunctionByName(StringView name) const
+{
+    return m_FunctionNames.FindLast(Functions, name, [](size_t) { return true; });
+}
+
+size_t Pulsar::Module::FindNativeByName(StringView name) const
+{
+    return m_NativeNames.FindLast(NativeBindings, name, [](size_t) { return true; });
+}
+
+size_t Pulsar::Module::FindGlobalByName(StringView name) const
+{
+    return m_GlobalNames.FindLast(Globals, name, [](size_t) { return true; });
+}
+
+size_t Pulsar::Module::FindFunctionBySignature(FunctionSignature signature) const
+{
+    return m_FunctionNames.FindLast(Functions, signature.Name, [this, &signature](size_t fnIdx) {
+        return signature.Matches(Functions[fnIdx]);
+    });
+}
+
+size_t Pulsar::Module::FindNativeBySignature(FunctionSignature signature) const
+{
+    return m_NativeNames.FindLast(NativeBindings, signature.Name, [this, &signature](size_t nativeIdx) {
+        return signature.Matches(NativeBindings[nativeIdx]);
+    });
+}
+
+void Pulsar::Module::PromoteValuesToAtomic()
+{
+    for (const Value& constant : Constants)
+        constant.PromoteToAtomic();
+    for (const GlobalDefinition& global : Globals.Get())
+        global.InitialValue.PromoteToAtomic();
+}
+
+Pulsar::Module::NameIndex::NameIndex(NameIndex&& other)
+    : m_LastByHash(std::move(other.m_LastByHash)), m_Previous(std::move(other.m_Previous))
+{
+#ifdef PULSAR_NO_ATOMIC
+    m_IndexedVersion = other.m_IndexedVersion;
+#else // PULSAR_NO_ATOMIC
+    m_IndexedVersion.store(other.m_IndexedVersion.load(std::memory_order_relaxed), std::memory_order_relaxed);
+#endif // PULSAR_NO_ATOMIC
+    other.Invalidate();
+}
+
+Pulsar::Module::NameIndex& Pulsar::Module::NameIndex::operator=(NameIndex&& other)
+{
+    if (this == &other)
+        return *this;
+    m_LastByHash = std::move(other.m_LastByHash);
+    m_Previous   = std::move(other.m_Previous);
+#ifdef PULSAR_NO_ATOMIC
+    m_IndexedVersion = other.m_IndexedVersion;
+#else // PULSAR_NO_ATOMIC
+    m_IndexedVersion.store(other.m_IndexedVersion.load(std::memory_order_relaxed), std::memory_order_relaxed);
+#endif // PULSAR_NO_ATOMIC
+    other.Invalidate();
+    return *this;
+}
+
+void Pulsar::Module::NameIndex::Invalidate()
+{
+#ifdef PULSAR_NO_ATOMIC
+    m_IndexedVersion = INVALID_VERSION;
+#else // PULSAR_NO_ATOMIC
+    m_IndexedVersion.store(INVALID_VERSION, std::memory_order_relaxed);
+#endif // PULSAR_NO_ATOMIC
+}
+
+void Pulsar::Module::NameIndex::Update(uint64_t version, uint64_t editVersion, size_t count, std::function<StringView(size_t)> nameOf) const
+{
+#ifdef PULSAR_NO_ATOMIC
+    uint64_t indexedVersion = m_IndexedVersion;
+#else // PULSAR_NO_ATOMIC
+    std::lock_guard lock(m_UpdateMutex);
+    // Another thread may have updated the index while this one was waiting.
+    uint64_t indexedVersion = m_IndexedVersion.load(std::memory_order_relaxed);
+#endif // PULSAR_NO_ATOMIC
+    if (indexedVersion == version)
+        return;
+
+    // Only appends happened since the last update if the last edit is not newer than it.
+    if (indexedVersion == INVALID_VERSION || editVersion > indexedVersion || m_Previous.Size() > count) {
+        m_LastByHash.Clear();
+        m_Previous.Clear();
+        m_LastByHash.Reserve(count);
+        m_Previous.Reserve(count);
+    }
+
+    for (size_t idx = m_Previous.Size(); idx < count; ++idx) {
+        size_t hash = std::hash<StringView>{}(nameOf(idx));
+        auto* last = m_LastByHash.Find(hash);
+        if (last) {
+            m_Previous.PushBack(last->Value());
+            last->Value() = idx;
+        } else {
+            m_Previous.PushBack(INVALID_INDEX);
+            m_LastByHash.Emplace(hash, idx);
+        }
+    }
+
+#ifdef PULSAR_NO_ATOMIC
+    m_IndexedVersion = version;
+#else // PULSAR_NO_ATOMIC
+    m_IndexedVersion.store(version, std::memory_order_release);
+#endif // PULSAR_NO_ATOMIC
+}
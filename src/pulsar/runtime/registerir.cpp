@@ -0,0 +1,462 @@
+#include "pulsar/runtime/registerir.h"
+
+#include "pulsar/verifier.h"
+
+bool Pulsar::RegisterTranslator::Translate(const Module& module, const FunctionDefinition& function, RegisterFunction& out)
+{
+    out = RegisterFunction();
+    if (!function.Verified || function.MaxStackSize == 0 || function.Code.IsEmpty())
+        return false;
+    // Register indices and jump targets must fit in 31 bits.
+    if (function.LocalsCount >= RegisterFunction::STACK_REGISTER_BIT
+        || function.MaxStackSize >= RegisterFunction::STACK_REGISTER_BIT
+        || function.Code.Size() >= RegisterFunction::STACK_REGISTER_BIT)
+        return false;
+
+    Verifier verifier;
+    if (!verifier.ComputeStackDepths(module, function, out.StackDepths)) {
+        out = RegisterFunction();
+        return false;
+    }
+
+    const List<Instruction>& code = function.Code;
+    m_Module = &module;
+    m_Function = &function;
+    m_Out = &out;
+    out.MaxStackSize = function.MaxStackSize;
+    out.EntryPoints.Resize(code.Size()+1, RegisterFunction::NO_ENTRY);
+
+    m_IsJumpTarget.Clear();
+    m_IsJumpTarget.Resize(code.Size()+1, false);
+    for (size_t i = 0; i < code.Size(); i++) {
+        if (!HasJumpOffset(code[i].Code))
+            continue;
+        int64_t target = (int64_t)i + code[i].Arg0;
+        if (target >= 0 && (size_t)target <= code.Size())
+            m_IsJumpTarget[(size_t)target] = true;
+    }
+
+    m_Aliases.Clear();
+    m_Aliases.Resize(function.MaxStackSize, NO_ALIAS);
+    m_Retargetable = RegisterFunction::NO_ENTRY;
+
+    for (size_t i = 0; i <= code.Size(); i++) {
+        m_CurrentIdx = i;
+        size_t depth = out.StackDepths[i];
+        if (depth == Verifier::UNKNOWN_DEPTH) {
+            // Predecessors exit before reaching unknown depths.
+            Flush(0);
+            m_Retargetable = RegisterFunction::NO_ENTRY;
+            continue;
+        }
+
+        // All paths which reach a jump target hold their values on the Stack.
+        if (m_IsJumpTarget[i]) {
+            Flush(depth);
+            m_Retargetable = RegisterFunction::NO_ENTRY;
+        }
+
+        if (i == code.Size()) {
+            Flush(depth);
+            out.EntryPoints[i] = out.Code.Size();
+            Emit(RegisterOpCode::Exit);
+            break;
+        }
+
+        if (!HasAliases())
+            out.EntryPoints[i] = out.Code.Size();
+        TranslateInstruction(i);
+    }
+
+    // Jumps hold the index of their target within the original code.
+    for (size_t i = 0; i < out.Code.Size(); i++) {
+        RegisterInstruction& instr = out.Code[i];
+        switch (instr.Code) {
+        case RegisterOpCode::Jump:
+        case RegisterOpCode::JumpIf:
+        case RegisterOpCode::CompareJump:
+        case RegisterOpCode::EqualsJump: {
+            size_t target = out.EntryPoints[instr.Dst];
+            if (target == RegisterFunction::NO_ENTRY) {
+                out = RegisterFunction();
+                return false;
+            }
+            instr.Imm = (int64_t)target;
+        } break;
+        default:
+            break;
+        }
+    }
+
+    m_Function = nullptr;
+    m_Out = nullptr;
+    return true;
+}
+
+void Pulsar::RegisterTranslator::TranslateInstruction(size_t instrIdx)
+{
+    const Instruction& instr = m_Function->Code[instrIdx];
+    size_t depth = m_Out->StackDepths[instrIdx];
+    size_t next  = instrIdx+1;
+
+    switch (instr.Code) {
+    case InstructionCode::PushInt:
+    case InstructionCode::PushDbl:
+    case InstructionCode::PushFunctionReference:
+    case InstructionCode::PushNativeFunctionReference:
+    case InstructionCode::PushConst: {
+        if (!CanContinueAt(next, depth+1))
+            return EmitExit(instrIdx);
+        RegisterOpCode code = RegisterOpCode::LoadConst;
+        switch (instr.Code) {
+        case InstructionCode::PushInt: code = RegisterOpCode::LoadInt; break;
+        case InstructionCode::PushDbl: code = RegisterOpCode::LoadDbl; break;
+        case InstructionCode::PushFunctionReference: code = RegisterOpCode::LoadFunctionReference; break;
+        case InstructionCode::PushNativeFunctionReference: code = RegisterOpCode::LoadNativeFunctionReference; break;
+        default: break;
+        }
+        m_Retargetable = Emit(code, WriteSlot(depth), 0, 0, instr.Arg0);
+    } return;
+    case InstructionCode::PushLocal:
+        if (!CanContinueAt(next, depth+1))
+            return EmitExit(instrIdx);
+        m_Aliases[depth] = (size_t)instr.Arg0;
+        m_Retargetable = RegisterFunction::NO_ENTRY;
+        return;
+    case InstructionCode::PushLocal2:
+        if (!CanContinueAt(next, depth+2))
+            return EmitExit(instrIdx);
+        m_Aliases[depth]   = UnpackFirstArg(instr.Arg0);
+        m_Aliases[depth+1] = UnpackSecondArg(instr.Arg0);
+        m_Retargetable = RegisterFunction::NO_ENTRY;
+        return;
+    case InstructionCode::MoveLocal: {
+        if (!CanContinueAt(next, depth+1))
+            return EmitExit(instrIdx);
+        size_t localIdx = (size_t)instr.Arg0;
+        FlushLocal(localIdx);
+        Emit(RegisterOpCode::Move, WriteSlot(depth), RegisterFunction::LocalRegister(localIdx));
+    } return;
+    case InstructionCode::PopIntoLocal: {
+        if (!CanContinueAt(next, depth-1))
+            return EmitExit(instrIdx);
+        size_t localIdx = (size_t)instr.Arg0;
+        size_t slotIdx  = depth-1;
+        size_t alias    = m_Aliases[slotIdx];
+        m_Aliases[slotIdx] = NO_ALIAS;
+        if (alias != NO_ALIAS) {
+            if (alias != localIdx) {
+                FlushLocal(localIdx);
+                Emit(RegisterOpCode::Copy, RegisterFunction::LocalRegister(localIdx), RegisterFunction::LocalRegister(alias));
+            }
+        } else if (m_Retargetable != RegisterFunction::NO_ENTRY
+                && m_Out->Code[m_Retargetable].Dst == RegisterFunction::StackRegister(slotIdx)
+                && !IsAliased(localIdx)) {
+            // The result of the previous instruction is written directly into the local.
+            // This instruction can't be resumed since the value never reaches the Stack.
+            m_Out->Code[m_Retargetable].Dst = RegisterFunction::LocalRegister(localIdx);
+            m_Out->EntryPoints[instrIdx] = RegisterFunction::NO_ENTRY;
+        } else {
+            FlushLocal(localIdx);
+            Emit(RegisterOpCode::Move, RegisterFunction::LocalRegister(localIdx), RegisterFunction::StackRegister(slotIdx));
+        }
+        m_Retargetable = RegisterFunction::NO_ENTRY;
+    } return;
+    case InstructionCode::CopyIntoLocal: {
+        if (!CanContinueAt(next, depth))
+            return EmitExit(instrIdx);
+        size_t localIdx = (size_t)instr.Arg0;
+        uint32_t value  = ReadSlot(depth-1);
+        if (value != RegisterFunction::LocalRegister(localIdx)) {
+            FlushLocal(localIdx);
+            Emit(RegisterOpCode::Copy, RegisterFunction::LocalRegister(localIdx), value);
+        }
+    } return;
+    case InstructionCode::Pop: {
+        size_t popCount = (size_t)(instr.Arg0 > 0 ? instr.Arg0 : 1);
+        if (!CanContinueAt(next, depth-popCount))
+            return EmitExit(instrIdx);
+        // Popped values are destroyed like the stack interpreter does.
+        for (size_t i = depth-popCount; i < depth; i++) {
+            if (m_Aliases[i] != NO_ALIAS) {
+                m_Aliases[i] = NO_ALIAS;
+            } else Emit(RegisterOpCode::Reset, RegisterFunction::StackRegister(i));
+        }
+    } return;
+    case InstructionCode::Dup: {
+        size_t dupCount = (size_t)(instr.Arg0 > 0 ? instr.Arg0 : 1);
+        if (!CanContinueAt(next, depth+dupCount))
+            return EmitExit(instrIdx);
+        size_t alias = m_Aliases[depth-1];
+        for (size_t i = depth; i < depth+dupCount; i++) {
+            if (alias != NO_ALIAS) {
+                m_Aliases[i] = alias;
+            } else Emit(RegisterOpCode::Copy, WriteSlot(i), RegisterFunction::StackRegister(depth-1));
+        }
+        m_Retargetable = RegisterFunction::NO_ENTRY;
+    } return;
+    case InstructionCode::Swap: {
+        if (!CanContinueAt(next, depth))
+            return EmitExit(instrIdx);
+        size_t a = depth-2;
+        size_t b = depth-1;
+        size_t aliasA = m_Aliases[a];
+        size_t aliasB = m_Aliases[b];
+        if (aliasA == NO_ALIAS && aliasB == NO_ALIAS) {
+            Emit(RegisterOpCode::Swap, RegisterFunction::StackRegister(a), RegisterFunction::StackRegister(b));
+        } else if (aliasA == NO_ALIAS) {
+            Emit(RegisterOpCode::Move, RegisterFunction::StackRegister(b), RegisterFunction::StackRegister(a));
+        } else if (aliasB == NO_ALIAS) {
+            Emit(RegisterOpCode::Move, RegisterFunction::StackRegister(a), RegisterFunction::StackRegister(b));
+        }
+        m_Aliases[a] = aliasB;
+        m_Aliases[b] = aliasA;
+        m_Retargetable = RegisterFunction::NO_ENTRY;
+    } return;
+    case InstructionCode::DynSum:
+    case InstructionCode::DynSub:
+    case InstructionCode::DynMul:
+    case InstructionCode::DynDiv:
+    case InstructionCode::SumII:
+    case InstructionCode::SumDD:
+    case InstructionCode::SubII:
+    case InstructionCode::SubDD:
+    case InstructionCode::MulII:
+    case InstructionCode::MulDD:
+    case InstructionCode::DivII:
+    case InstructionCode::DivDD:
+    case InstructionCode::CompareII:
+    case InstructionCode::CompareDD:
+    case InstructionCode::Mod:
+    case InstructionCode::BitAnd:
+    case InstructionCode::BitOr:
+    case InstructionCode::BitXor:
+    case InstructionCode::BitShiftLeft:
+    case InstructionCode::BitShiftRight:
+    case InstructionCode::Compare:
+    case InstructionCode::Equals: {
+        if (!CanContinueAt(next, depth-1))
+            return EmitExit(instrIdx);
+        RegisterOpCode code = RegisterOpCode::Equals;
+        switch (instr.Code) {
+        case InstructionCode::DynSum:
+        case InstructionCode::SumII:
+        case InstructionCode::SumDD: code = RegisterOpCode::Sum; break;
+        case InstructionCode::DynSub:
+        case InstructionCode::SubII:
+        case InstructionCode::SubDD: code = RegisterOpCode::Sub; break;
+        case InstructionCode::DynMul:
+        case InstructionCode::MulII:
+        case InstructionCode::MulDD: code = RegisterOpCode::Mul; break;
+        case InstructionCode::DynDiv:
+        case InstructionCode::DivII:
+        case InstructionCode::DivDD: code = RegisterOpCode::Div; break;
+        case InstructionCode::Mod:    code = RegisterOpCode::Mod; break;
+        case InstructionCode::BitAnd: code = RegisterOpCode::BitAnd; break;
+        case InstructionCode::BitOr:  code = RegisterOpCode::BitOr; break;
+        case InstructionCode::BitXor: code = RegisterOpCode::BitXor; break;
+        case InstructionCode::BitShiftLeft:  code = RegisterOpCode::BitShiftLeft; break;
+        case InstructionCode::BitShiftRight: code = RegisterOpCode::BitShiftRight; break;
+        case InstructionCode::Compare:
+        case InstructionCode::CompareII:
+        case InstructionCode::CompareDD: code = RegisterOpCode::Compare; break;
+        default: break;
+        }
+        uint32_t a = ReadSlot(depth-2);
+        uint32_t b = ReadSlot(depth-1);
+        m_Aliases[depth-1] = NO_ALIAS;
+        m_Retargetable = Emit(code, WriteSlot(depth-2), a, b);
+    } return;
+    case InstructionCode::BitNot:
+    case InstructionCode::Floor:
+    case InstructionCode::Ceil: {
+        if (!CanContinueAt(next, depth))
+            return EmitExit(instrIdx);
+        RegisterOpCode code = instr.Code == InstructionCode::BitNot ? RegisterOpCode::BitNot
+            : instr.Code == InstructionCode::Floor ? RegisterOpCode::Floor : RegisterOpCode::Ceil;
+        uint32_t a = ReadSlot(depth-1);
+        m_Retargetable = Emit(code, WriteSlot(depth-1), a);
+    } return;
+    case InstructionCode::Length:
+    case InstructionCode::IsEmpty:
+    case InstructionCode::IsVoid:
+    case InstructionCode::IsInteger:
+    case InstructionCode::IsDouble:
+    case InstructionCode::IsNumber:
+    case InstructionCode::IsFunctionReference:
+    case InstructionCode::IsNativeFunctionReference:
+    case InstructionCode::IsAnyFunctionReference:
+    case InstructionCode::IsList:
+    case InstructionCode::IsString:
+    case InstructionCode::IsCustom: {
+        if (!CanContinueAt(next, depth+1))
+            return EmitExit(instrIdx);
+        RegisterOpCode code = instr.Code == InstructionCode::Length ? RegisterOpCode::Length
+            : instr.Code == InstructionCode::IsEmpty ? RegisterOpCode::IsEmpty : RegisterOpCode::TypeCheck;
+        size_t idx = Emit(code, WriteSlot(depth), ReadSlot(depth-1));
+        m_Out->Code[idx].Condition = instr.Code;
+        m_Retargetable = idx;
+    } return;
+    case InstructionCode::IncLocal:
+    case InstructionCode::DecLocal: {
+        if (!CanContinueAt(next, depth))
+            return EmitExit(instrIdx);
+        size_t localIdx = (size_t)instr.Arg0;
+        FlushLocal(localIdx);
+        RegisterOpCode code = instr.Code == InstructionCode::IncLocal ? RegisterOpCode::Increment : RegisterOpCode::Decrement;
+        Emit(code, RegisterFunction::LocalRegister(localIdx));
+    } return;
+    case InstructionCode::J: {
+        size_t target = (size_t)((int64_t)instrIdx + instr.Arg0);
+        if (!CanContinueAt(target, depth))
+            return EmitExit(instrIdx);
+        Flush(depth);
+        Emit(RegisterOpCode::Jump, (uint32_t)target);
+    } return;
+    case InstructionCode::JZ:
+    case InstructionCode::JNZ:
+    case InstructionCode::JGZ:
+    case InstructionCode::JGEZ:
+    case InstructionCode::JLZ:
+    case InstructionCode::JLEZ:
+    case InstructionCode::DupJZ:
+    case InstructionCode::CompareJGZ:
+    case InstructionCode::CompareJGEZ:
+    case InstructionCode::CompareJLZ:
+    case InstructionCode::CompareJLEZ:
+    case InstructionCode::EqualsJZ:
+    case InstructionCode::EqualsJNZ: {
+        size_t pops = 1;
+        RegisterOpCode code = RegisterOpCode::JumpIf;
+        if (instr.Code == InstructionCode::DupJZ) {
+            pops = 0;
+        } else if (instr.Code == InstructionCode::EqualsJZ || instr.Code == InstructionCode::EqualsJNZ) {
+            pops = 2;
+            code = RegisterOpCode::EqualsJump;
+        } else if (GetFusedJump(instr.Code) != instr.Code) {
+            pops = 2;
+            code = RegisterOpCode::CompareJump;
+        }
+
+        size_t target = (size_t)((int64_t)instrIdx + instr.Arg0);
+        if (!CanContinueAt(target, depth-pops) || !CanContinueAt(next, depth-pops))
+            return EmitExit(instrIdx);
+
+        uint32_t a = 0;
+        uint32_t b = 0;
+        if (pops == 0) {
+            // The value stays on the Stack.
+            Flush(depth);
+            a = RegisterFunction::StackRegister(depth-1);
+        } else if (pops == 1) {
+            a = ReadSlot(depth-1);
+            Flush(depth-1);
+        } else {
+            a = ReadSlot(depth-2);
+            b = ReadSlot(depth-1);
+            Flush(depth-2);
+        }
+        size_t idx = Emit(code, (uint32_t)target, a, b);
+        m_Out->Code[idx].Condition = GetFusedJump(instr.Code);
+    } return;
+    case InstructionCode::CallNative:
+        // Fast natives only push a Frame if they ask for one or fail, see ExecutionContext::RunRegisterCode().
+        if (m_Module->GetFastNative((size_t)instr.Arg0)) {
+            Flush(depth);
+            Emit(RegisterOpCode::Step);
+            return;
+        }
+        return EmitExit(instrIdx);
+    case InstructionCode::Return:
+    case InstructionCode::Call:
+    case InstructionCode::TailCall:
+    case InstructionCode::ITailCall:
+    case InstructionCode::ICall:
+        return EmitExit(instrIdx);
+    default:
+        // The Stack is synchronized before and after the instruction.
+        Flush(depth);
+        Emit(RegisterOpCode::Step);
+        return;
+    }
+}
+
+uint32_t Pulsar::RegisterTranslator::ReadSlot(size_t slotIdx) const
+{
+    size_t alias = m_Aliases[slotIdx];
+    return alias != NO_ALIAS
+        ? RegisterFunction::LocalRegister(alias)
+        : RegisterFunction::StackRegister(slotIdx);
+}
+
+uint32_t Pulsar::RegisterTranslator::WriteSlot(size_t slotIdx)
+{
+    m_Aliases[slotIdx] = NO_ALIAS;
+    return RegisterFunction::StackRegister(slotIdx);
+}
+
+void Pulsar::RegisterTranslator::Flush(size_t depth)
+{
+    for (size_t i = 0; i < m_Aliases.Size(); i++) {
+        size_t alias = m_Aliases[i];
+        if (alias == NO_ALIAS)
+            continue;
+        m_Aliases[i] = NO_ALIAS;
+        if (i < depth)
+            Emit(RegisterOpCode::Copy, RegisterFunction::StackRegister(i), RegisterFunction::LocalRegister(alias));
+    }
+}
+
+void Pulsar::RegisterTranslator::FlushLocal(size_t localIdx)
+{
+    for (size_t i = 0; i < m_Aliases.Size(); i++) {
+        if (m_Aliases[i] != localIdx)
+            continue;
+        m_Aliases[i] = NO_ALIAS;
+        Emit(RegisterOpCode::Copy, RegisterFunction::StackRegister(i), RegisterFunction::LocalRegister(localIdx));
+    }
+}
+
+bool Pulsar::RegisterTranslator::HasAliases() const
+{
+    for (size_t i = 0; i < m_Aliases.Size(); i++) {
+        if (m_Aliases[i] != NO_ALIAS)
+            return true;
+    }
+    return false;
+}
+
+bool Pulsar::RegisterTranslator::IsAliased(size_t localIdx) const
+{
+    for (size_t i = 0; i < m_Aliases.Size(); i++) {
+        if (m_Aliases[i] == localIdx)
+            return true;
+    }
+    return false;
+}
+
+bool Pulsar::RegisterTranslator::CanContinueAt(size_t targetIdx, size_t depth) const
+{
+    if (depth > m_Out->MaxStackSize)
+        return false;
+    return targetIdx < m_Out->StackDepths.Size() && m_Out->StackDepths[targetIdx] == depth;
+}
+
+size_t Pulsar::RegisterTranslator::Emit(RegisterOpCode code, uint32_t dst, uint32_t a, uint32_t b, int64_t imm)
+{
+    RegisterInstruction& instr = m_Out->Code.EmplaceBack();
+    instr.Code   = code;
+    instr.Dst    = dst;
+    instr.A      = a;
+    instr.B      = b;
+    instr.Imm    = imm;
+    instr.Source = m_CurrentIdx;
+    m_Retargetable = RegisterFunction::NO_ENTRY;
+    return m_Out->Code.Size()-1;
+}
+
+void Pulsar::RegisterTranslator::EmitExit(size_t instrIdx)
+{
+    Flush(m_Out->StackDepths[instrIdx]);
+    Emit(RegisterOpCode::Exit);
+}
@@ -22,6 +22,7 @@ const char* Pulsar::RuntimeStateToString(RuntimeState rstate)
     case RuntimeState::NoCustomTypeGlobalData:         return "NoCustomTypeGlobalData";
     case RuntimeState::InvalidCustomTypeHandle:        return "InvalidCustomTypeHandle";
     case RuntimeState::InvalidCustomTypeReference:     return "InvalidCustomTypeReference";
+    case RuntimeState::Yielded:                        return "Yielded";
     }
     return "Unknown";
 }
@@ -3,6 +3,10 @@
 #include "pulsar/lexer/utils.h"
 #include "pulsar/runtime/module.h"
 
+#include <cstddef> // offsetof
+
+static_assert(sizeof(Pulsar::Value) <= 16);
+
 Pulsar::Value::Value()
 {
     PULSAR_MEMSET((void*)this, 0, sizeof(Value));
@@ -13,8 +17,45 @@ Pulsar::Value::~Value()
     Reset();
 }
 
+size_t Pulsar::Value::GetTypeOffset()
+{
+    return offsetof(Value, m_Type);
+}
+
+size_t Pulsar::Value::GetPayloadOffset()
+{
+    return offsetof(Value, m_AsInteger);
+}
+
+template<typename T>
+static T* _RetainBox(T* box)
+{
+    box->RefCount.Increment();
+    return box;
+}
+
+template<typename T>
+static void _ReleaseBox(T* box)
+{
+    if (box->RefCount.Decrement() <= 1)
+        PULSAR_DELETE(T, box);
+}
+
+template<typename T>
+void Pulsar::Value::Unshare(Box<T>*& box)
+{
+    Box<T>* copy = NewBox<T>(box->Value);
+    _ReleaseBox(box);
+    box = copy;
+}
+
+template void Pulsar::Value::Unshare(Box<List>*& box);
+template void Pulsar::Value::Unshare(Box<String>*& box);
+template void Pulsar::Value::Unshare(Box<CustomData>*& box);
+
 Pulsar::Value& Pulsar::Value::operator=(const Value& other)
 {
+    // The payload of `other` is retained first in case it's the same as this one.
     switch (other.Type()) {
     case ValueType::Void:
         return SetVoid();
@@ -26,35 +67,36 @@ Pulsar::Value& Pulsar::Value::operator=(const Value& other)
         return SetFunctionReference(other.AsInteger());
     case ValueType::NativeFunctionReference:
         return SetNativeFunctionReference(other.AsInteger());
-    case ValueType::List:
-        return SetList(other.AsList());
-    case ValueType::String:
-        return SetString(other.AsString());
-    case ValueType::Custom:
-        return SetCustom(other.AsCustom());
+    case ValueType::List: {
+        Box<List>* list = _RetainBox(other.m_AsList);
+        Reset();
+        m_Type = ValueType::List;
+        m_AsList = list;
+    } break;
+    case ValueType::String: {
+        Box<String>* string = _RetainBox(other.m_AsString);
+        Reset();
+        m_Type = ValueType::String;
+        m_AsString = string;
+    } break;
+    case ValueType::Custom: {
+        Box<CustomData>* custom = _RetainBox(other.m_AsCustom);
+        Reset();
+        m_Type = ValueType::Custom;
+        m_AsCustom = custom;
+    } break;
     }
     return *this;
 }
 
 Pulsar::Value& Pulsar::Value::operator=(Value&& other)
 {
-    switch (other.Type()) {
-    case ValueType::Void:
-    case ValueType::Integer:
-    case ValueType::Double:
-    case ValueType::FunctionReference:
-    case ValueType::NativeFunctionReference:
-    case ValueType::Custom:
-        *this = (const Value&)other;
-        break;
-    case ValueType::List:
-        SetList(std::move(other.m_AsList));
-        break;
-    case ValueType::String:
-        SetString(std::move(other.m_AsString));
-        break;
-    }
-    other.Reset();
+    if (this == &other)
+        return *this;
+    Reset();
+    // All payloads are trivially relocatable.
+    PULSAR_MEMCPY((void*)this, (const void*)&other, sizeof(Value));
+    PULSAR_MEMSET((void*)&other, 0, sizeof(Value));
     return *this;
 }
 
@@ -76,23 +118,84 @@ bool Pulsar::Value::operator==(const Value& other) const
     case ValueType::Custom:
         return AsCustom().Type == other.AsCustom().Type
             && AsCustom().Data == other.AsCustom().Data;
-    case ValueType::List:
-        const List::Node* aNext = AsList().Front();
-        const List::Node* bNext = other.AsList().Front();
-        while (true) {
-            if (aNext == bNext)
-                return true;
-            else if (!aNext || !bNext)
-                return false;
-            else if (aNext->Value() != bNext->Value())
+    case ValueType::List: {
+        if (m_AsList == other.m_AsList)
+            return true;
+        const List& aList = AsList();
+        const List& bList = other.AsList();
+        if (aList.Length() != bList.Length())
+            return false;
+        auto bNext = bList.Begin();
+        for (const Value& a : aList) {
+            if (a != *bNext)
                 return false;
-            aNext = aNext->Next();
-            bNext = bNext->Next();
+            ++bNext;
         }
+        return true;
+    }
     }
     return false;
 }
 
+void Pulsar::Value::PromoteToAtomic() const
+{
+    // Boxes which are already atomic only hold atomic values.
+    // Otherwise, their values are promoted first so that other threads never see an atomic box holding local values.
+    switch (m_Type) {
+    case ValueType::List:
+        if (!m_AsList->RefCount.IsLocal())
+            break;
+        m_AsList->Value.PromoteToAtomic([](const Value& value) { value.PromoteToAtomic(); });
+        m_AsList->RefCount.PromoteToAtomic();
+        break;
+    case ValueType::String:
+        m_AsString->RefCount.PromoteToAtomic();
+        break;
+    case ValueType::Custom:
+        // The CustomData holder is reference counted atomically.
+        m_AsCustom->RefCount.PromoteToAtomic();
+        break;
+    default:
+        break;
+    }
+}
+
+void Pulsar::Value::Freeze() const
+{
+    // Frozen boxes only hold frozen values, like atomic ones.
+    switch (m_Type) {
+    case ValueType::List:
+        if (m_AsList->RefCount.IsFrozen())
+            break;
+        m_AsList->Value.Freeze([](const Value& value) { value.Freeze(); });
+        m_AsList->RefCount.Freeze();
+        break;
+    case ValueType::String:
+        m_AsString->RefCount.Freeze();
+        break;
+    case ValueType::Custom:
+        // Only the reference to the CustomData is immutable.
+        m_AsCustom->RefCount.Freeze();
+        break;
+    default:
+        break;
+    }
+}
+
+bool Pulsar::Value::IsFrozen() const
+{
+    switch (m_Type) {
+    case ValueType::List:
+        return m_AsList->RefCount.IsFrozen();
+    case ValueType::String:
+        return m_AsString->RefCount.IsFrozen();
+    case ValueType::Custom:
+        return m_AsCustom->RefCount.IsFrozen();
+    default:
+        return true;
+    }
+}
+
 Pulsar::String Pulsar::Value::ToString(ToReprOptions options) const
 {
     if (Type() == ValueType::String)
@@ -137,19 +240,19 @@ Pulsar::String Pulsar::Value::ToRepr(ToReprOptions options) const
     }
     case ValueType::List: {
         // TODO: Non-recursive
-        auto node = AsList().Front();
-        if (!node) return "[ ]";
+        const List& list = AsList();
+        if (list.IsEmpty()) return "[ ]";
         else if (options.MaxDepth <= 0) return "[ ... ]";
 
         ToReprOptions recOptions = options;
         --recOptions.MaxDepth;
 
         String result = "[ ";
-        result += node->Value().ToRepr(recOptions);
-        while (node->HasNext()) {
-            node = node->Next();
+        auto next = list.Begin();
+        result += (*next).ToRepr(recOptions);
+        while (++next != list.End()) {
             result += ", ";
-            result += node->Value().ToRepr(recOptions);
+            result += (*next).ToRepr(recOptions);
         }
         result += " ]";
 
@@ -186,21 +289,17 @@ void Pulsar::Value::Reset()
     case ValueType::Double:
     case ValueType::FunctionReference:
     case ValueType::NativeFunctionReference:
-        m_AsInteger = 0;
         break;
     case ValueType::List:
-        m_AsList.~LinkedList();
-        PULSAR_MEMSET((void*)&m_AsList, 0, sizeof(List));
+        _ReleaseBox(m_AsList);
         break;
     case ValueType::String:
-        m_AsString.~String();
-        PULSAR_MEMSET((void*)&m_AsString, 0, sizeof(String));
+        _ReleaseBox(m_AsString);
         break;
     case ValueType::Custom:
-        // Call Destructor
-        m_AsCustom.~CustomData();
-        PULSAR_MEMSET((void*)&m_AsCustom, 0, sizeof(CustomData));
+        _ReleaseBox(m_AsCustom);
         break;
     }
     m_Type = ValueType::Void;
+    m_AsInteger = 0;
 }
@@ -0,0 +1,95 @@
+#include "pulsar/structures/hash.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h> // _umul128
+#endif
+
+namespace
+{
+    constexpr uint64_t SECRET[4] = {
+        0xa0761d6478bd642f, 0xe7037ed1a0b428db,
+        0x8ebc6af09c88c6e3, 0x589965cc75374cc3,
+    };
+
+    // Replaces `a` and `b` with the low and high halves of their 128-bit product.
+    void Multiply(uint64_t& a, uint64_t& b)
+    {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t product = (__uint128_t)a * b;
+        a = (uint64_t)product;
+        b = (uint64_t)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        a = _umul128(a, b, &b);
+#else
+        uint64_t aHi = a >> 32, aLo = (uint32_t)a;
+        uint64_t bHi = b >> 32, bLo = (uint32_t)b;
+        uint64_t hh = aHi * bHi, hl = aHi * bLo;
+        uint64_t lh = aLo * bHi, ll = aLo * bLo;
+        uint64_t mid = (ll >> 32) + (uint32_t)hl + (uint32_t)lh;
+        a = (mid << 32) | (uint32_t)ll;
+        b = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+#endif
+    }
+
+    // XORs the halves of the 128-bit product of `a` and `b`.
+    uint64_t Fold(uint64_t a, uint64_t b)
+    {
+        Multiply(a, b);
+        return a ^ b;
+    }
+
+    uint64_t Read8(const uint8_t* p) { uint64_t v; PULSAR_MEMCPY(&v, p, 8); return v; }
+    uint64_t Read4(const uint8_t* p) { uint32_t v; PULSAR_MEMCPY(&v, p, 4); return v; }
+    // Reads 1 to 3 bytes.
+    uint64_t Read3(const uint8_t* p, size_t size)
+    {
+        return ((uint64_t)p[0] << 16) | ((uint64_t)p[size >> 1] << 8) | p[size-1];
+    }
+}
+
+uint64_t Pulsar::Hash::Bytes(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    seed ^= Fold(seed ^ SECRET[0], SECRET[1]);
+
+    uint64_t a, b;
+    if (size <= 16) {
+        if (size >= 4) {
+            size_t mid = (size >> 3) << 2;
+            a = (Read4(p) << 32) | Read4(p+mid);
+            b = (Read4(p+size-4) << 32) | Read4(p+size-4-mid);
+        } else if (size > 0) {
+            a = Read3(p, size);
+            b = 0;
+        } else {
+            a = 0;
+            b = 0;
+        }
+    } else {
+        size_t left = size;
+        if (left > 48) {
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+            do {
+                seed  = Fold(Read8(p)    ^ SECRET[1], Read8(p+8)  ^ seed);
+                seed1 = Fold(Read8(p+16) ^ SECRET[2], Read8(p+24) ^ seed1);
+                seed2 = Fold(Read8(p+32) ^ SECRET[3], Read8(p+40) ^ seed2);
+                p += 48;
+                left -= 48;
+            } while (left > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (left > 16) {
+            seed = Fold(Read8(p) ^ SECRET[1], Read8(p+8) ^ seed);
+            p += 16;
+            left -= 16;
+        }
+        a = Read8(p+left-16);
+        b = Read8(p+left-8);
+    }
+
+    a ^= SECRET[1];
+    b ^= seed;
+    Multiply(a, b);
+    return Fold(a ^ SECRET[0] ^ size, b ^ SECRET[1]);
+}
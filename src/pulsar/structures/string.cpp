@@ -1,14 +1,16 @@
 #include "pulsar/structures/string.h"
 
 Pulsar::String::String()
-    : m_Data(nullptr)
+    : m_Data(m_Small)
     , m_Length(0)
-    , m_Capacity(0)
-{}
+{
+    m_Small[0] = '\0';
+}
 
 Pulsar::String::~String()
 {
-    PULSAR_FREE(m_Data);
+    if (!IsSmall())
+        PULSAR_FREE((void*)m_Data);
 }
 
 Pulsar::String::String(const String& other)
@@ -43,7 +45,7 @@ Pulsar::String::String(const char* data, size_t length)
 
 void Pulsar::String::Resize(size_t newLength)
 {
-    if (!m_Data || newLength > m_Capacity)
+    if (newLength > Capacity())
         Reserve(newLength*3/2+1);
     m_Length = newLength;
     m_Data[m_Length] = '\0';
@@ -51,9 +53,15 @@ void Pulsar::String::Resize(size_t newLength)
 
 void Pulsar::String::Reserve(size_t newCapacity)
 {
-    if (m_Data && newCapacity <= m_Length)
+    if (newCapacity <= Capacity())
         return;
-    m_Data = (char*)PULSAR_REALLOC((void*)m_Data, (newCapacity+1) * sizeof(char));
+
+    if (IsSmall()) {
+        m_Data = (char*)PULSAR_MALLOC((newCapacity+1) * sizeof(char));
+        PULSAR_MEMCPY((void*)m_Data, (void*)m_Small, (m_Length+1)*sizeof(char));
+    } else {
+        m_Data = (char*)PULSAR_REALLOC((void*)m_Data, (newCapacity+1) * sizeof(char));
+    }
     m_Capacity = newCapacity;
     m_Data[m_Capacity] = '\0';
 }
@@ -93,10 +101,12 @@ bool Pulsar::String::operator==(const String& other) const
 Pulsar::String& Pulsar::String::operator+=(const String& other)
 {
     size_t appendIdx = m_Length;
-    Resize(m_Length+other.m_Length);
+    size_t otherLength = other.m_Length;
+    Resize(m_Length+otherLength);
+    // other.m_Data is read after resizing since `other` may be this String.
     PULSAR_MEMCPY(
         (void*)(m_Data+appendIdx), other.m_Data,
-        other.m_Length*sizeof(char));
+        otherLength*sizeof(char));
     return *this;
 }
 
@@ -121,6 +131,8 @@ Pulsar::String& Pulsar::String::operator+=(char ch)
 
 Pulsar::String& Pulsar::String::operator=(const String& other)
 {
+    if (this == &other)
+        return *this;
     Reserve(other.m_Length); // Do not allocate more than needed.
     Resize(other.m_Length);
     PULSAR_MEMCPY((void*)m_Data, other.m_Data, other.m_Length*sizeof(char));
@@ -129,13 +141,23 @@ Pulsar::String& Pulsar::String::operator=(const String& other)
 
 Pulsar::String& Pulsar::String::operator=(String&& other)
 {
-    PULSAR_FREE((void*)m_Data);
-    m_Data = other.m_Data;
+    if (this == &other)
+        return *this;
+    if (!IsSmall())
+        PULSAR_FREE((void*)m_Data);
+
     m_Length = other.m_Length;
-    m_Capacity = other.m_Capacity;
-    other.m_Data = nullptr;
+    if (other.IsSmall()) {
+        m_Data = m_Small;
+        PULSAR_MEMCPY((void*)m_Small, (void*)other.m_Small, (m_Length+1)*sizeof(char));
+    } else {
+        m_Data = other.m_Data;
+        m_Capacity = other.m_Capacity;
+    }
+
+    other.m_Data = other.m_Small;
     other.m_Length = 0;
-    other.m_Capacity = 0;
+    other.m_Small[0] = '\0';
     return *this;
 }
 
@@ -0,0 +1,393 @@
+#include "pulsar/verifier.h"
+
+bool Pulsar::Verifier::Verify(Module& module)
+{
+    bool allVerified = true;
+    for (size_t i = 0; i < module.Functions.Size(); i++) {
+        FunctionDefinition& function = module.Functions[i];
+        function.Verified = VerifyFunction(module, function);
+        allVerified = allVerified && function.Verified;
+        if (function.MaxStackSize == 0)
+            function.MaxStackSize = ComputeMaxStackSize(module, function);
+    }
+    return allVerified;
+}
+
+void Pulsar::Verifier::Visit(size_t instructionIdx, size_t depth)
+{
+    if (depth > MAX_TRACKED_DEPTH)
+        depth = MAX_TRACKED_DEPTH;
+    if (depth >= m_MinStackDepth[instructionIdx])
+        return;
+    m_MinStackDepth[instructionIdx] = depth;
+    m_ToVisit.PushBack(instructionIdx);
+}
+
+bool Pulsar::Verifier::VerifyFunction(const Module& module, const FunctionDefinition& function)
+{
+    // PrepareFrame moves arguments into locals.
+    if (function.LocalsCount < function.Arity)
+        return false;
+    // CallNative accesses NativeFunctions with a NativeBindings index.
+    if (module.NativeFunctions.Size() != module.NativeBindings.Size())
+        return false;
+
+    const List<Instruction>& code = function.Code;
+
+    m_MinStackDepth.Clear();
+    m_MinStackDepth.Resize(code.Size()+1, UNVISITED);
+    m_ToVisit.Clear();
+
+    Visit(0, function.StackArity);
+    while (!m_ToVisit.IsEmpty()) {
+        size_t instrIdx = m_ToVisit.Back();
+        m_ToVisit.PopBack();
+
+        size_t depth = m_MinStackDepth[instrIdx];
+        if (instrIdx >= code.Size()) {
+            if (depth < function.Returns)
+                return false;
+            continue;
+        }
+
+        const Instruction& instr = code[instrIdx];
+        StackEffect effect;
+        if (!GetStackEffect(module, function, instr, effect))
+            return false;
+
+        if (depth < effect.Pops)
+            return false;
+        size_t nextDepth = effect.IsDynamic ? 0 : depth - effect.Pops + effect.Pushes;
+
+        if (effect.Jumps) {
+            int64_t jumpIdx = (int64_t)instrIdx + instr.Arg0;
+            if (jumpIdx < 0 || (size_t)jumpIdx > code.Size())
+                return false;
+            Visit((size_t)jumpIdx, nextDepth);
+        }
+
+        if (effect.Continues)
+            Visit(instrIdx+1, nextDepth);
+    }
+
+    return true;
+}
+
+void Pulsar::Verifier::VisitMax(size_t instructionIdx, size_t depth)
+{
+    if (m_MaxStackDepth[instructionIdx] != UNVISITED && depth <= m_MaxStackDepth[instructionIdx])
+        return;
+    m_MaxStackDepth[instructionIdx] = depth;
+    m_ToVisit.PushBack(instructionIdx);
+}
+
+size_t Pulsar::Verifier::ComputeMaxStackSize(const Module& module, const FunctionDefinition& function)
+{
+    const List<Instruction>& code = function.Code;
+
+    m_MaxStackDepth.Clear();
+    m_MaxStackDepth.Resize(code.Size()+1, UNVISITED);
+    m_ToVisit.Clear();
+
+    // Upper bound of how much an icall may grow the stack, computed on the first one found.
+    size_t maxICallGrowth = UNVISITED;
+
+    size_t maxStackSize = function.StackArity;
+    VisitMax(0, function.StackArity);
+    while (!m_ToVisit.IsEmpty()) {
+        size_t instrIdx = m_ToVisit.Back();
+        m_ToVisit.PopBack();
+        if (instrIdx >= code.Size())
+            continue;
+
+        size_t depth = m_MaxStackDepth[instrIdx];
+        const Instruction& instr = code[instrIdx];
+        StackEffect effect;
+        if (!GetStackEffect(module, function, instr, effect))
+            return 0;
+
+        size_t nextDepth = depth > effect.Pops ? depth - effect.Pops : 0;
+        if (effect.IsDynamic) {
+            if (maxICallGrowth == UNVISITED)
+                maxICallGrowth = GetMaxCallGrowth(module);
+            nextDepth += maxICallGrowth;
+        } else {
+            nextDepth += effect.Pushes;
+        }
+
+        // The stack grows within a loop or this function is just too big.
+        if (nextDepth > MAX_COMPUTED_STACK_SIZE)
+            return 0;
+        if (nextDepth > maxStackSize)
+            maxStackSize = nextDepth;
+
+        if (effect.Jumps) {
+            int64_t jumpIdx = (int64_t)instrIdx + instr.Arg0;
+            if (jumpIdx < 0 || (size_t)jumpIdx > code.Size())
+                return 0;
+            VisitMax((size_t)jumpIdx, nextDepth);
+        }
+
+        if (effect.Continues)
+            VisitMax(instrIdx+1, nextDepth);
+    }
+
+    return maxStackSize;
+}
+
+// Marks instructions reached with different depths, they're not visited again.
+static constexpr size_t CONFLICTING_DEPTH = Pulsar::Verifier::UNKNOWN_DEPTH-1;
+
+void Pulsar::Verifier::VisitExact(List<size_t>& depths, size_t instructionIdx, size_t depth)
+{
+    if (depths[instructionIdx] == depth || depths[instructionIdx] == CONFLICTING_DEPTH)
+        return;
+    depths[instructionIdx] = depths[instructionIdx] == UNKNOWN_DEPTH ? depth : CONFLICTING_DEPTH;
+    m_ToVisit.PushBack(instructionIdx);
+}
+
+bool Pulsar::Verifier::ComputeStackDepths(const Module& module, const FunctionDefinition& function, List<size_t>& outDepths)
+{
+    if (!VerifyFunction(module, function))
+        return false;
+
+    const List<Instruction>& code = function.Code;
+
+    outDepths.Clear();
+    outDepths.Resize(code.Size()+1, UNKNOWN_DEPTH);
+    m_ToVisit.Clear();
+
+    VisitExact(outDepths, 0, function.StackArity);
+    while (!m_ToVisit.IsEmpty()) {
+        size_t instrIdx = m_ToVisit.Back();
+        m_ToVisit.PopBack();
+
+        size_t depth = outDepths[instrIdx];
+        if (instrIdx >= code.Size() || depth == CONFLICTING_DEPTH)
+            continue;
+
+        const Instruction& instr = code[instrIdx];
+        StackEffect effect;
+        if (!GetStackEffect(module, function, instr, effect) || depth < effect.Pops)
+            return false;
+        // The depth after an icall is only known at runtime.
+        if (effect.IsDynamic)
+            continue;
+
+        size_t nextDepth = depth - effect.Pops + effect.Pushes;
+        if (nextDepth > MAX_COMPUTED_STACK_SIZE)
+            return false;
+        if (effect.Jumps)
+            VisitExact(outDepths, (size_t)((int64_t)instrIdx + instr.Arg0), nextDepth);
+        if (effect.Continues)
+            VisitExact(outDepths, instrIdx+1, nextDepth);
+    }
+
+    for (size_t i = 0; i < outDepths.Size(); i++) {
+        if (outDepths[i] == CONFLICTING_DEPTH)
+            outDepths[i] = UNKNOWN_DEPTH;
+    }
+    return true;
+}
+
+size_t Pulsar::Verifier::GetMaxCallGrowth(const Module& module)
+{
+    size_t maxGrowth = 0;
+    auto updateMaxGrowth = [&maxGrowth](const FunctionDefinition& def) {
+        size_t args = def.Arity + def.StackArity;
+        if (def.Returns > args && def.Returns - args > maxGrowth)
+            maxGrowth = def.Returns - args;
+    };
+    for (size_t i = 0; i < module.Functions.Size(); i++)
+        updateMaxGrowth(module.Functions[i]);
+    for (size_t i = 0; i < module.NativeBindings.Size(); i++)
+        updateMaxGrowth(module.NativeBindings[i]);
+    return maxGrowth;
+}
+
+bool Pulsar::Verifier::GetStackEffect(const Module& module, const FunctionDefinition& function, const Instruction& instr, StackEffect& out)
+{
+    out = StackEffect();
+    switch (instr.Code) {
+    case InstructionCode::PushInt:
+    case InstructionCode::PushDbl:
+    case InstructionCode::PushFunctionReference:
+    case InstructionCode::PushNativeFunctionReference:
+    case InstructionCode::PushEmptyList:
+        out.Pushes = 1;
+        break;
+    case InstructionCode::Pack:
+        out.Pops = instr.Arg0 > 0 ? (size_t)instr.Arg0 : 0;
+        out.Pushes = 1;
+        break;
+    case InstructionCode::Pop:
+        out.Pops = instr.Arg0 > 0 ? (size_t)instr.Arg0 : 1;
+        break;
+    case InstructionCode::Swap:
+        out.Pops = out.Pushes = 2;
+        break;
+    case InstructionCode::Dup:
+        out.Pops = 1;
+        out.Pushes = 1 + (instr.Arg0 > 0 ? (size_t)instr.Arg0 : 1);
+        break;
+    case InstructionCode::PushConst:
+        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= module.Constants.Size())
+            return false;
+        out.Pushes = 1;
+        break;
+    case InstructionCode::PushLocal:
+    case InstructionCode::MoveLocal:
+        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= function.LocalsCount)
+            return false;
+        out.Pushes = 1;
+        break;
+    case InstructionCode::PopIntoLocal:
+        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= function.LocalsCount)
+            return false;
+        out.Pops = 1;
+        break;
+    case InstructionCode::CopyIntoLocal:
+        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= function.LocalsCount)
+            return false;
+        out.Pops = out.Pushes = 1;
+        break;
+    case InstructionCode::PushGlobal:
+        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= module.Globals.Size())
+            return false;
+        out.Pushes = 1;
+        break;
+    case InstructionCode::MoveGlobal:
+    case InstructionCode::PopIntoGlobal:
+    case InstructionCode::CopyIntoGlobal:
+        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= module.Globals.Size())
+            return false;
+        if (module.Globals[(size_t)instr.Arg0].IsConstant)
+            return false;
+        if (instr.Code == InstructionCode::MoveGlobal) {
+            out.Pushes = 1;
+        } else if (instr.Code == InstructionCode::PopIntoGlobal) {
+            out.Pops = 1;
+        } else {
+            out.Pops = out.Pushes = 1;
+        }
+        break;
+    case InstructionCode::Call:
+    case InstructionCode::TailCall:
+    case InstructionCode::CallNative: {
+        const List<FunctionDefinition>& definitions = instr.Code != InstructionCode::CallNative
+            ? module.Functions : module.NativeBindings;
+        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= definitions.Size())
+            return false;
+        const FunctionDefinition& callee = definitions[(size_t)instr.Arg0];
+        out.Pops   = callee.Arity + callee.StackArity;
+        out.Pushes = callee.Returns;
+    } break;
+    case InstructionCode::Return:
+        out.Pops = out.Pushes = function.Returns;
+        out.Continues = false;
+        break;
+    case InstructionCode::ICall:
+    case InstructionCode::ITailCall:
+        out.Pops = 1;
+        out.IsDynamic = true;
+        break;
+    case InstructionCode::DynSum:
+    case InstructionCode::DynSub:
+    case InstructionCode::DynMul:
+    case InstructionCode::DynDiv:
+    case InstructionCode::Mod:
+    case InstructionCode::BitAnd:
+    case InstructionCode::BitOr:
+    case InstructionCode::BitXor:
+    case InstructionCode::BitShiftLeft:
+    case InstructionCode::BitShiftRight:
+    case InstructionCode::Compare:
+    case InstructionCode::Equals:
+    case InstructionCode::Prepend:
+    case InstructionCode::Append:
+    case InstructionCode::Concat:
+        out.Pops = 2;
+        out.Pushes = 1;
+        break;
+    case InstructionCode::BitNot:
+    case InstructionCode::Floor:
+    case InstructionCode::Ceil:
+    case InstructionCode::Tail:
+        out.Pops = out.Pushes = 1;
+        break;
+    case InstructionCode::J:
+        out.Continues = false;
+        out.Jumps = true;
+        break;
+    case InstructionCode::JZ:
+    case InstructionCode::JNZ:
+    case InstructionCode::JGZ:
+    case InstructionCode::JGEZ:
+    case InstructionCode::JLZ:
+    case InstructionCode::JLEZ:
+        out.Pops = 1;
+        out.Jumps = true;
+        break;
+    case InstructionCode::IsEmpty:
+    case InstructionCode::Length:
+    case InstructionCode::Head:
+    case InstructionCode::IsVoid:
+    case InstructionCode::IsInteger:
+    case InstructionCode::IsDouble:
+    case InstructionCode::IsNumber:
+    case InstructionCode::IsFunctionReference:
+    case InstructionCode::IsNativeFunctionReference:
+    case InstructionCode::IsAnyFunctionReference:
+    case InstructionCode::IsList:
+    case InstructionCode::IsString:
+    case InstructionCode::IsCustom:
+        out.Pops = 1;
+        out.Pushes = 2;
+        break;
+    case InstructionCode::Unpack:
+        out.Pops = 1;
+        out.Pushes = instr.Arg0 > 0 ? (size_t)instr.Arg0 : 0;
+        break;
+    case InstructionCode::Index:
+    case InstructionCode::Prefix:
+    case InstructionCode::Suffix:
+        out.Pops = out.Pushes = 2;
+        break;
+    case InstructionCode::Substr:
+        out.Pops = 3;
+        out.Pushes = 2;
+        break;
+    case InstructionCode::IncLocal:
+    case InstructionCode::DecLocal:
+        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= function.LocalsCount)
+            return false;
+        break;
+    case InstructionCode::PushLocal2:
+        if (UnpackFirstArg(instr.Arg0) >= function.LocalsCount || UnpackSecondArg(instr.Arg0) >= function.LocalsCount)
+            return false;
+        out.Pushes = 2;
+        break;
+    case InstructionCode::PushConstAppend:
+        if (instr.Arg0 < 0 || (size_t)instr.Arg0 >= module.Constants.Size())
+            return false;
+        out.Pops = out.Pushes = 1;
+        break;
+    case InstructionCode::DupJZ:
+        out.Pops = out.Pushes = 1;
+        out.Jumps = true;
+        break;
+    case InstructionCode::CompareJGZ:
+    case InstructionCode::CompareJGEZ:
+    case InstructionCode::CompareJLZ:
+    case InstructionCode::CompareJLEZ:
+    case InstructionCode::EqualsJZ:
+    case InstructionCode::EqualsJNZ:
+        out.Pops = 2;
+        out.Jumps = true;
+        break;
+    default:
+        // Unknown instructions are not verified.
+        return false;
+    }
+    return true;
+}